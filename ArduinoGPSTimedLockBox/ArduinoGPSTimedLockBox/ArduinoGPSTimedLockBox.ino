@@ -10,6 +10,10 @@
 #include "Setup.h"
 #include "SinglePointConfiguration.h"
 #include "Temporal.h"
+#include "Scheduler.h"
+#include "Trace.h"
+#include "Journal.h"
+#include "DirectionHint.h"
 
 #include <NeoSWSerial.h>
 #include <NMEAGPS.h>
@@ -18,6 +22,7 @@
 #include <EEPROM.h>
 #include <LiquidCrystal_I2C.h>
 #include <Servo.h>
+#include <avr/sleep.h>
 
 // Hook
 //#define servoDegreesLock 10
@@ -33,11 +38,24 @@ Temporal realTimeClock;
 Display display;
 UserInput input;
 
+// State of the normal game, advanced by the tasks below from loop().
+gamePhase phase = inactive;
+bool fixReady = false;
+bool windowExpired = false;
+bool keyUnlocked = false;
+
 void setup()
 {
     Serial.begin(9600);
 
+    Scheduler::AddTask(GpsTask, 0);
+    Scheduler::AddTask(DisplayTask, 50);
+    Scheduler::AddTask(InputTask, 50);
+    Scheduler::AddTask(RtcTask, 1000);
+    Scheduler::AddTask(GameTask, 0);
+
     display.Initialize();
+    Trace::Record(traceLcdInit);
     display.WriteSearchBeginsIn(1, 1, 1);
 
     //switch (input.GetStartUpMode())
@@ -65,88 +83,198 @@ void setup()
 
 void RunNormal()
 {
-    systemConfig.LoadConfigFromEEPROM();
-    if (!realTimeClock.IsGameStartReached()) // Game hadn't started yet.
+    if (!systemConfig.LoadConfigFromEEPROM())
     {
-        TimeSpanDuration timeUntilGameStart = realTimeClock.GetTimeUntilGameStart();
-        display.WriteSearchBeginsIn(timeUntilGameStart.Days, timeUntilGameStart.Hours, timeUntilGameStart.Minutes);
-        Die();
+        display.WriteConfigInvalid();
+        phase = sayingGoodbye;
+        return;
     }
-    else // Game has started. Begin checking things like GPS and RTC.
+    Journal::RecordBoot();
+    globalPositioningModule.RequestPowerSave();
+    phase = checkingTime;
+}
+
+void GpsTask()
+{
+    if (globalPositioningModule.ReadFix())
     {
-        if (!realTimeClock.HasWindowOpened()) // Before unlock window
+        fixReady = true;
+        realTimeClock.AnchorToGps(globalPositioningModule.GetFixDateTime());
+        if (phase != inactive) // The configuration, and so the target, is loaded.
         {
-            display.WriteObtainingGPSLocationFix();
-            if (globalPositioningModule.IsWithinRadius(systemConfig.GetCurrentPointLocation()))
-            {
-                display.WriteLocationReached();
-            }
-            else
-            {
-                display.WriteDistanceRemaining(globalPositioningModule.GetAbsoluteDistanceFromPoint(systemConfig.GetCurrentPointLocation()));
-            }
-            TimeSpanDuration timeUntilWindow = realTimeClock.GetTimeUntilWindowOpens();
-            display.WriteTimeToUnlock(timeUntilWindow.Days, timeUntilWindow.Hours, timeUntilWindow.Minutes);
+            DirectionHint::AddFix(globalPositioningModule.GetFixLocation(), systemConfig.GetCurrentPointLocation());
+        }
+    }
+}
+
+void DisplayTask()
+{
+    display.Update();
+}
+
+void InputTask()
+{
+    keyUnlocked = input.IsKeyStateUnlocked();
+}
+
+// Passed to the display, which asks again each time it redraws the distance and hint.
+uint32_t DistanceToCurrentPoint()
+{
+    return globalPositioningModule.GetDistanceFromPoint(systemConfig.GetCurrentPointLocation());
+}
+
+directionHint HintToCurrentPoint()
+{
+    directionHint hint;
+    hint.bearing = globalPositioningModule.GetBearingToPoint(systemConfig.GetCurrentPointLocation());
+    hint.trend = DirectionHint::GetTrend();
+    return hint;
+}
+
+void RtcTask()
+{
+    if (phase != inactive && phase != finished)
+    {
+        windowExpired = realTimeClock.HasWindowExpired();
+    }
+}
 
+// Each phase does one step and returns. Phases that put a message on screen wait for the display to finish it first, but the other tasks keep running meanwhile.
+void GameTask()
+{
+    switch (phase)
+    {
+    case(checkingTime):
+        if (!realTimeClock.IsGameStartReached()) // Game hadn't started yet.
+        {
+            TimeSpanDuration timeUntilGameStart = realTimeClock.GetTimeUntilGameStart();
+            display.WriteSearchBeginsIn(timeUntilGameStart.Days, timeUntilGameStart.Hours, timeUntilGameStart.Minutes);
+            Trace::Record(traceDecisionMade);
+            phase = sayingGoodbye;
+        }
+        else if (realTimeClock.HasWindowExpired()) // After unlock window.
+        {
+            display.WriteTooLate();
+            Trace::Record(traceDecisionMade);
+            phase = sayingGoodbye;
         }
-        else if (realTimeClock.HasWindowOpened() && !realTimeClock.HasWindowExpired()) // Currently in unlock window
+        else // Game has started. The decision is made as soon as the averaged position is clearly inside or outside.
         {
             display.WriteObtainingGPSLocationFix();
-            if (globalPositioningModule.IsWithinRadius(systemConfig.GetCurrentPointLocation()))
+            phase = awaitingFix;
+        }
+        break;
+    case(awaitingFix):
+        if (fixReady) // Replaces whatever is on screen, so the decision is never held up by a message.
+        {
+            fixReady = false; // The averaged position only changes when the next fix arrives.
+            positionDecision decision = globalPositioningModule.DecideWithinRadius(systemConfig.GetCurrentPointLocation());
+            if (decision == decisionPending)
+            {
+                break;
+            }
+            bool windowOpen = realTimeClock.HasWindowOpened();
+            if (decision == decisionInside)
             {
                 display.WriteLocationReached();
-                if (systemConfig.IsFinalPoint())
+                if (!windowOpen)
+                {
+                    phase = showingTimeToUnlock;
+                }
+                else if (systemConfig.IsFinalPoint())
                 {
-                    FinalPointReached();
+                    phase = awaitingKeys;
                 }
                 else
                 {
-                    NextStageReached();
+                    phase = showingStageComplete;
                 }
             }
             else
             {
-                display.WriteDistanceRemaining(globalPositioningModule.GetAbsoluteDistanceFromPoint(systemConfig.GetCurrentPointLocation()));
+                display.WriteDistanceRemaining(DistanceToCurrentPoint, HintToCurrentPoint);
+                phase = windowOpen ? showingWindowRemaining : showingTimeToUnlock;
             }
-
+            Trace::Record(traceDecisionMade);
+            Journal::RecordFix(globalPositioningModule.GetFixLocation());
+        }
+        else if (globalPositioningModule.HasFixTimedOut()) // Indoors or under cover, so stop drawing power for a fix that isn't coming.
+        {
+            display.WriteNoGpsFix();
+            Trace::Record(traceFixTimedOut);
+            phase = sayingGoodbye;
+        }
+        break;
+    case(showingTimeToUnlock):
+        if (!display.IsBusy())
+        {
+            TimeSpanDuration timeUntilWindow = realTimeClock.GetTimeUntilWindowOpens();
+            display.WriteTimeToUnlock(timeUntilWindow.Days, timeUntilWindow.Hours, timeUntilWindow.Minutes);
+            phase = sayingGoodbye;
+        }
+        break;
+    case(showingWindowRemaining):
+        if (!display.IsBusy())
+        {
             TimeSpanDuration remainingWindow = realTimeClock.GetTimeUntilWindowClose();
             display.WriteUnlockTimeRemaining(remainingWindow.Days, remainingWindow.Hours, remainingWindow.Minutes);
+            phase = sayingGoodbye;
         }
-        else if (realTimeClock.HasWindowExpired()) // After unlock window.
+        break;
+    case(showingStageComplete):
+        if (!display.IsBusy())
         {
-            TooLate();
+            display.WriteStageXOfYComplete(systemConfig.GetCurrentPointNumber(), systemConfig.GetTotalPointCount());
+            phase = showingNextStage;
         }
-    }
-    Die();
-}
-
-void FinalPointReached()
-{
-    while (!realTimeClock.HasWindowExpired())
-    {
-        if (input.IsKeyStateUnlocked())
+        break;
+    case(showingNextStage):
+        if (!display.IsBusy())
+        {
+            display.WriteNextStageBeginsNow();
+            systemConfig.ProgressToNextPoint();
+            phase = sayingGoodbye;
+        }
+        break;
+    case(awaitingKeys):
+        if (windowExpired)
+        {
+            display.WriteTooLate();
+            phase = sayingGoodbye;
+        }
+        else if (keyUnlocked)
         {
             Lock(false);
-            Die();
+            phase = sayingGoodbye;
         }
-        else
+        else if (!display.IsBusy())
         {
             display.WriteInsertBothKeys();
-            delay(1500);
         }
-    }
-}
-
-void NextStageReached()
-{
-    while (!realTimeClock.HasWindowExpired())
-    {
-        TimeSpanDuration remainingWindow = realTimeClock.GetTimeUntilWindowClose();
-        uint8_t currentPoint = systemConfig.GetCurrentPointNumber();
-        uint8_t totalPoints = systemConfig.GetTotalPointCount();
-        display.WriteStageXOfYComplete(currentPoint, totalPoints);
-        display.WriteNextStageBeginsNow();
-        systemConfig.ProgressToNextPoint();
+        break;
+    case(sayingGoodbye):
+        if (!display.IsBusy())
+        {
+            display.WriteGoodbye();
+            phase = poweringDown;
+        }
+        break;
+    case(poweringDown):
+        if (!display.IsBusy())
+        {
+            display.Clear();
+            display.LcdOff();
+            Trace::Dump();
+            Serial.print(F("FIXES accepted,rejected "));
+            Serial.print(globalPositioningModule.GetAcceptedFixCount());
+            Serial.print(',');
+            Serial.println(globalPositioningModule.GetRejectedFixCount());
+            phase = finished;
+            PowerDown();
+        }
+        break;
+    default:
+        break;
     }
 }
 
@@ -154,23 +282,31 @@ void RunOverride() {
     if (input.ValidateCodeForStartupMode(overrideUnlock))
     {
         display.WriteAccessGranted();
+        display.Wait();
         Lock(false);
     }
     else
     {
         display.WriteAccessDenied();
+        display.Wait();
     }
     Die();
 }
 
 void RunExtraTime()
 {
-    systemConfig.LoadConfigFromEEPROM();
+    if (!systemConfig.LoadConfigFromEEPROM())
+    {
+        display.WriteConfigInvalid();
+        display.Wait();
+        Die();
+    }
     //if (!systemConfig.IsTimeExtended() && input.ValidateCodeForStartupMode(extraTime))
     {
         uint32_t duration = input.GetExtraTimeValue();
         systemConfig.ExtendTime(duration, realTimeClock.IsGameStartReached(), (!realTimeClock.HasWindowOpened() && !realTimeClock.HasWindowExpired()));
         display.WriteTimeExtended();
+        display.Wait();
     }
     //else
     //{
@@ -184,16 +320,37 @@ void RunCalibrateRTC()
     if (input.ValidateCodeForStartupMode(calibrateClock))
     {
         display.WriteCalibratingRTC();
-        time_t newTime = globalPositioningModule.GetDateTimeInUtc();
-        time_t currentTime = realTimeClock.GetDateTimeInUtc();
-        realTimeClock.SetCurrentTime(newTime);
-        delay(2000);
-        uint32_t delta = abs(newTime - currentTime);
-        display.WriteRTCOffBy(delta);
+        int32_t offset;
+        if (realTimeClock.CalibrateFromGps(offset))
+        {
+            display.WriteRTCOffBy(abs(offset));
+            display.Wait();
+            display.WriteRtcDrift(realTimeClock.GetDriftCentiPpm());
+            display.Wait();
+        }
+        else
+        {
+            // Either no fix came, or the fixes came without PPS. Only the second can be helped, by setting the RTC to the nearest
+            // whole second of a fix and leaving the drift as it was.
+            time_t newTime = globalPositioningModule.HasFixTimedOut() ? 0 : globalPositioningModule.GetDateTimeInUtc();
+            if (newTime == 0)
+            {
+                display.WriteNoGpsFix();
+                display.Wait();
+                Die();
+            }
+            time_t currentTime = realTimeClock.GetDateTimeInUtc();
+            realTimeClock.SetCurrentTime(newTime);
+            delay(2000);
+            uint32_t delta = abs(newTime - currentTime);
+            display.WriteRTCOffBy(delta);
+            display.Wait();
+        }
     }
     else
     {
         display.WriteAccessDenied();
+        display.Wait();
     }
     Die();
 }
@@ -204,9 +361,13 @@ void RunConfigureUnit()
     {
         Lock(false);
         display.WriteSerialMode();
-        systemConfig.Initialize();
-        input.AwaitKeyLock();
-        Lock(true);
+        bool configured = systemConfig.Initialize();
+        Trace::Dump();
+        if (configured)
+        {
+            input.AwaitKeyLock();
+            Lock(true);
+        }
     }
     //else
     //{
@@ -241,18 +402,33 @@ void Lock(bool lock)
 void TooLate()
 {
     display.WriteTooLate();
+    display.Wait();
     Die();
 }
 
 void Die()
 {
     display.WriteGoodbye();
+    display.Wait();
     display.Clear();
     display.LcdOff();
-    while (true) {}
+    PowerDown();
+}
+
+// Puts the GPS into backup and the MCU into power down with interrupts off, so only a power cycle starts the unit again.
+void PowerDown()
+{
+    globalPositioningModule.PowerDown();
+    Serial.flush();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    cli();
+    sleep_enable();
+    sleep_cpu();
 }
 
 void loop()
 {
-    // Empty. The unit runs once per power cycle.
+    // The unit still runs once per power cycle; the game only advances while phase is between inactive and finished.
+    Scheduler::RunDueTasks();
+    Scheduler::Idle();
 }
@@ -0,0 +1,76 @@
+#include "Bearing.h"
+#include "MotionPredictor.h"
+
+// NeoGPS's longitude difference that copes with the antimeridian. Defined in Location.cpp.
+int32_t safeDLon(int32_t p2, int32_t p1);
+
+// atan(i / 64) in hundredths of a degree, for i from 0 to 64.
+static const uint16_t arctangentTable[65] PROGMEM = {
+	0, 90, 179, 268, 358, 447, 536, 624, 713, 800, 888, 975, 1062,
+	1148, 1234, 1319, 1404, 1488, 1571, 1653, 1735, 1817, 1897, 1977, 2056, 2134,
+	2211, 2287, 2363, 2438, 2511, 2584, 2657, 2728, 2798, 2867, 2936, 3003, 3070,
+	3136, 3201, 3264, 3327, 3390, 3451, 3511, 3571, 3629, 3687, 3744, 3800, 3855,
+	3909, 3963, 4016, 4067, 4119, 4169, 4218, 4267, 4315, 4363, 4409, 4455, 4500
+};
+
+// Hundredths of a degree anticlockwise from the positive x axis, 0 to 35999. Zero for the origin.
+uint16_t Bearing::Atan2(int32_t y, int32_t x)
+{
+	uint32_t absX = (x < 0) ? -(uint32_t)x : x;
+	uint32_t absY = (y < 0) ? -(uint32_t)y : y;
+	if (absX == 0 && absY == 0)
+	{
+		return 0;
+	}
+	// Only the ratio matters, so drop bits until the larger side shifted up 16 still fits.
+	while (absX > 0xFFFF || absY > 0xFFFF)
+	{
+		absX >>= 1;
+		absY >>= 1;
+	}
+
+	bool steep = absY > absX;
+	uint32_t ratio = steep ? (absX << 16) / absY : (absY << 16) / absX; // tan of the angle from the nearer axis, Q16.
+	uint8_t index = ratio >> 10;
+	uint16_t angle = pgm_read_word(&arctangentTable[index]);
+	if (index < 64)
+	{
+		uint16_t next = pgm_read_word(&arctangentTable[index + 1]);
+		angle += ((uint32_t)(next - angle) * (ratio & 1023) + 512) >> 10;
+	}
+
+	if (steep)
+	{
+		angle = 9000 - angle;
+	}
+	if (x < 0)
+	{
+		angle = 18000 - angle;
+	}
+	if (y < 0)
+	{
+		angle = 36000 - angle;
+	}
+	return (angle >= 36000) ? angle - 36000 : angle;
+}
+
+// Hundredths of a degree clockwise from north. Treats the Earth as flat around the two points, which is within a tenth of
+// a degree of the great circle bearing out to 10 km, and a degree and a half out to 100 km.
+uint16_t Bearing::Between(const NeoGPS::Location_t& from, const NeoGPS::Location_t& to)
+{
+	int32_t north = to.lat() - from.lat();
+	int32_t east = safeDLon(to.lon(), from.lon());
+	while (north > 0xFFFF || north < -0xFFFF || east > 0xFFFF || east < -0xFFFF)
+	{
+		north /= 2;
+		east /= 2;
+	}
+	east = (east * MotionPredictor::Cosine(from.lat() / 100000)) >> 15;
+	return Atan2(east, north);
+}
+
+// 0 for north, then clockwise in eighths of a turn to 7 for north west.
+uint8_t Bearing::CompassPoint(uint16_t bearing)
+{
+	return ((bearing + 2250) / 4500) % 8;
+}
@@ -0,0 +1,23 @@
+#ifndef _BEARING_h
+#define _BEARING_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <NMEAGPS.h>
+
+// Integer replacement for Location_t::BearingTo, cheap enough to call on every display refresh.
+// atan2 folds the angle into the first octant and looks the ratio up in a 65 entry table, with straight lines in between.
+// atan2 is good to a hundredth of a degree or so. BearingTo's single precision great circle formula loses more than that below a kilometer.
+class Bearing
+{
+public:
+	static uint16_t Atan2(int32_t y, int32_t x);
+	static uint16_t Between(const NeoGPS::Location_t& from, const NeoGPS::Location_t& to);
+	static uint8_t CompassPoint(uint16_t bearing);
+};
+
+#endif
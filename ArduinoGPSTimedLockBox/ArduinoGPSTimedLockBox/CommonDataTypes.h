@@ -7,10 +7,24 @@ enum buttonState { none, left, center, right, leftAndCenter, leftAndRight, cente
 
 enum startupMode { normal, overrideUnlock, extraTime, calibrateClock, configureUnit };
 
+enum zoneKind { zoneTarget, zoneDecoy, zoneExclusion };
+
+enum positionDecision { decisionPending, decisionInside, decisionOutside };
+
+enum hintTrend { trendUnknown, trendWarmer, trendColder };
+
+enum gamePhase { inactive, checkingTime, awaitingFix, showingTimeToUnlock, showingWindowRemaining, showingStageComplete, showingNextStage, awaitingKeys, sayingGoodbye, poweringDown, finished };
+
 struct latLongLocation
 {
 	int32_t latitude;
 	int32_t longitude;
 };
 
+struct directionHint
+{
+	uint16_t bearing; // Hundredths of a degree clockwise from north.
+	hintTrend trend;
+};
+
 #endif
\ No newline at end of file
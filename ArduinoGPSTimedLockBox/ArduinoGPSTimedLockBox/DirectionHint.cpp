@@ -0,0 +1,38 @@
+#include "DirectionHint.h"
+
+latLongLocation DirectionHint::target = { 0, 0 };
+uint32_t DirectionHint::referenceDm = 0;
+hintTrend DirectionHint::trend = trendUnknown;
+bool DirectionHint::started = false;
+
+// A new target starts the trend again.
+void DirectionHint::AddFix(latLongLocation position, latLongLocation targetLocation)
+{
+	NeoGPS::Location_t here(position.latitude, position.longitude);
+	NeoGPS::Location_t there(targetLocation.latitude, targetLocation.longitude);
+	uint32_t distanceDm = here.DistanceKm(there) * 10000;
+
+	if (!started || targetLocation.latitude != target.latitude || targetLocation.longitude != target.longitude)
+	{
+		target = targetLocation;
+		trend = trendUnknown;
+		referenceDm = distanceDm;
+		started = true;
+		return;
+	}
+	if (distanceDm + HINT_TREND_DM <= referenceDm)
+	{
+		trend = trendWarmer;
+		referenceDm = distanceDm;
+	}
+	else if (distanceDm >= referenceDm + HINT_TREND_DM)
+	{
+		trend = trendColder;
+		referenceDm = distanceDm;
+	}
+}
+
+hintTrend DirectionHint::GetTrend()
+{
+	return trend;
+}
@@ -0,0 +1,29 @@
+#ifndef _DIRECTIONHINT_h
+#define _DIRECTIONHINT_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <NMEAGPS.h>
+#include "CommonDataTypes.h"
+
+#define HINT_TREND_DM 50 // How much closer or further, in decimeters, the player must get before the trend changes. More than a still receiver usually wanders.
+
+// Warmer or colder, from the distance to the target at each fix. The distance is compared with the one when the trend last changed,
+// not the fix before, so a slow walk still adds up and the wander of a still receiver doesn't flip it back and forth.
+class DirectionHint
+{
+private:
+	static latLongLocation target;
+	static uint32_t referenceDm;
+	static hintTrend trend;
+	static bool started;
+public:
+	static void AddFix(latLongLocation position, latLongLocation targetLocation);
+	static hintTrend GetTrend();
+};
+
+#endif
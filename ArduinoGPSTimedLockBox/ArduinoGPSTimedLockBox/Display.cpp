@@ -1,11 +1,58 @@
 #include "Display.h"
+#include "Bearing.h"
 
 //Slider
 #define screenI2C 0x27
 // Hook
 //#define screenI2C 0x38
 
-LiquidCrystal_I2C* Display::lcd = new LiquidCrystal_I2C(screenI2C, 2, 1, 0, 4, 5, 6, 7, 3, POSITIVE);
+static LiquidCrystal_I2C lcdDevice(screenI2C, 2, 1, 0, 4, 5, 6, 7, 3, POSITIVE);
+LiquidCrystal_I2C* Display::lcd = &lcdDevice;
+
+bool Display::holding = false;
+uint32_t Display::holdStart = 0;
+void (*Display::nextPage)() = NULL;
+void (*Display::refreshPage)() = NULL;
+uint32_t Display::lastRefresh = 0;
+uint32_t (*Display::distanceSource)() = NULL;
+directionHint (*Display::hintSource)() = NULL;
+uint8_t Display::pendingDays = 0;
+uint8_t Display::pendingHours = 0;
+uint8_t Display::pendingMinutes = 0;
+uint32_t Display::pendingValue = 0;
+char Display::frame[DISPLAY_ROWS][DISPLAY_COLUMNS];
+char Display::shown[DISPLAY_ROWS][DISPLAY_COLUMNS];
+
+// In displayMessage order.
+const DisplayMessage Display::messages[messageCount] PROGMEM = {
+	{ "Search will     " "begin in...     " }, // messageSearchBeginsIn
+	{ "Less than       " "a minute        " }, // messageLessThanAMinute
+	{ "    Days    Hrs " "   Minutes      ", { { 0, 0, 3, ' ' }, { 0, 9, 2, ' ' }, { 1, 0, 2, ' ' } } }, // messageDaysHoursMinutes
+	{ "Next stage      " "commencing      " }, // messageNextStageBeginsNow
+	{ "Stage   of      " "complete        ", { { 0, 6, 1, ' ' }, { 0, 11, 1, ' ' } } }, // messageStageComplete
+	{ "Obtaining GPS   " "location fix... " }, // messageObtainingFix
+	{ "Distance to     " "location...     " }, // messageDistanceTo
+	{ "         Meters " "Head            ", { { 0, 0, 8, ' ' } } }, // messageMeters
+	{ "Location has    " "been found      " }, // messageLocationReached
+	{ "Unlock window   " "will start in..." }, // messageWindowStartsIn
+	{ "Unlock window   " "will last for..." }, // messageWindowLastsFor
+	{ "Serial mode     " "                " }, // messageSerialMode
+	{ "Calibrating RTC " "from GPS fix... " }, // messageCalibratingRtc
+	{ "Real Time Clock " "was off by...   " }, // messageRtcOffBy
+	{ "                " "Seconds         ", { { 0, 0, 10, ' ' } } }, // messageSeconds
+	{ "RTC runs fast by" "     ms a day   ", { { 1, 0, 4, ' ' } } }, // messageRtcGains
+	{ "RTC runs slow by" "     ms a day   ", { { 1, 0, 4, ' ' } } }, // messageRtcLoses
+	{ "Enter Value:    " "                ", { { 1, 0, 2, '0' }, { 1, 14, 2, '0' } } }, // messageEnterValue
+	{ "Time Extended   " "                " }, // messageTimeExtended
+	{ "Passcode:       " "                " }, // messagePasscode
+	{ "Insert second   " "key to unlock   " }, // messageInsertBothKeys
+	{ "Access Granted  " "Welcome         " }, // messageAccessGranted
+	{ "Access Denied   " "                " }, // messageAccessDenied
+	{ "Too Late        " "Window Missed   " }, // messageTooLate
+	{ "Config Invalid  " "Please Reset    " }, // messageConfigInvalid
+	{ "No GPS Fix      " "Try Open Sky    " }, // messageNoGpsFix
+	{ "Goodbye         " "                " }, // messageGoodbye
+};
 
 Display::Display()
 {
@@ -13,7 +60,10 @@ Display::Display()
 
 void Display::Initialize()
 {
-	lcd->begin(16, 2);
+	lcd->begin(DISPLAY_COLUMNS, DISPLAY_ROWS);
+	// begin() leaves the LCD blank.
+	ClearFrame();
+	memcpy(shown, frame, sizeof(shown));
 }
 
 void Display::LcdOn()
@@ -26,15 +76,98 @@ void Display::LcdOff()
 	lcd->off();
 }
 
-void Display::Write(char *lineOne, char *lineTwo)
+// Compass points and trends, as drawn on the distance page. In the order of Bearing::CompassPoint and hintTrend.
+static const char compassNames[] PROGMEM = "N NEE SES SWW NW";
+static const char trendNames[] PROGMEM = "      " "Warmer" "Colder";
+
+// Messages are copied from flash into frame with their numbers filled in, then Flush() sends only the cells that differ from what the LCD is already showing.
+void Display::Write(displayMessage message, uint32_t first, uint32_t second, uint32_t third)
+{
+	Compose(message, first, second, third);
+	Flush();
+}
+
+// Write() without the Flush(), for pages that draw more into frame first.
+void Display::Compose(displayMessage message, uint32_t first, uint32_t second, uint32_t third)
+{
+	memcpy_P(frame, messages[message].Text, sizeof(frame));
+
+	uint32_t values[DISPLAY_MAX_SLOTS] = { first, second, third };
+	MessageSlot slots[DISPLAY_MAX_SLOTS];
+	memcpy_P(slots, messages[message].Slots, sizeof(slots));
+	for (uint8_t i = 0; i < DISPLAY_MAX_SLOTS; i++)
+	{
+		if (slots[i].Width != 0)
+		{
+			PutNumber(slots[i].Column, slots[i].Row, slots[i].Width, slots[i].Fill, values[i]);
+		}
+	}
+}
+
+void Display::ClearFrame()
+{
+	memset(frame, ' ', sizeof(frame));
+}
+
+// A value too wide for its slot shows as all nines.
+void Display::PutNumber(uint8_t column, uint8_t row, uint8_t width, char fill, uint32_t value)
+{
+	char* cell = &frame[row][column + width];
+	uint8_t remaining = width;
+	do {
+		*--cell = '0' + value % 10;
+		value /= 10;
+	} while (value != 0 && --remaining != 0);
+
+	if (value != 0)
+	{
+		memset(&frame[row][column], '9', width);
+		return;
+	}
+	while (cell != &frame[row][column])
+	{
+		*--cell = fill;
+	}
+}
+
+// text is in flash.
+void Display::PutText(uint8_t column, uint8_t row, const char* text, uint8_t length)
+{
+	memcpy_P(&frame[row][column], text, length);
+}
+
+// The LCD moves its cursor on after each character, so setCursor is only needed when the next changed cell isn't the next one along.
+// Everything goes out as one I2C burst, opened at the first changed cell, so a redraw that changes nothing doesn't touch the bus.
+void Display::Flush()
 {
-	Clear();
-	lcd->setCursor(0, 0);
-	lcd->print(lineOne);
-	if (lineTwo != "")
+	bool sending = false;
+	for (uint8_t row = 0; row < DISPLAY_ROWS; row++)
 	{
-		lcd->setCursor(0, 1);
-		lcd->print(lineTwo);
+		bool cursorHere = false;
+		for (uint8_t column = 0; column < DISPLAY_COLUMNS; column++)
+		{
+			if (frame[row][column] == shown[row][column])
+			{
+				cursorHere = false;
+				continue;
+			}
+			if (!sending)
+			{
+				lcd->beginBurst();
+				sending = true;
+			}
+			if (!cursorHere)
+			{
+				lcd->setCursor(column, row);
+				cursorHere = true;
+			}
+			lcd->write(frame[row][column]);
+			shown[row][column] = frame[row][column];
+		}
+	}
+	if (sending)
+	{
+		lcd->endBurst();
 	}
 }
 
@@ -42,164 +175,245 @@ void Display::DaysHoursMinutes(uint8_t days, uint8_t hours, uint8_t minutes)
 {
 	if (days + hours + minutes <= 0)
 	{
-		Write("Less than", "a minute");
+		Write(messageLessThanAMinute);
 	}
 	else
 	{
-		//Write(String(days) + " Days " + String(hours) + " Hours", String(minutes) + " Minutes");
+		Write(messageDaysHoursMinutes, days, hours, minutes);
+	}
+}
+
+// Messages stay on screen for DISPLAY_HOLD_MS without blocking. Update() then shows the next page, or clears the screen if there isn't one.
+// A page with a live value sets refreshPage after holding, and Update() calls it every DISPLAY_REFRESH_MS until the hold ends.
+void Display::Hold(void (*next)())
+{
+	holding = true;
+	holdStart = millis();
+	nextPage = next;
+	refreshPage = NULL;
+}
+
+bool Display::IsBusy()
+{
+	return holding;
+}
+
+void Display::Update()
+{
+	if (holding && refreshPage != NULL && (millis() - lastRefresh >= DISPLAY_REFRESH_MS))
+	{
+		lastRefresh = millis();
+		refreshPage();
 	}
+	if (holding && (millis() - holdStart >= DISPLAY_HOLD_MS))
+	{
+		holding = false;
+		refreshPage = NULL;
+		void (*next)() = nextPage;
+		nextPage = NULL;
+		if (next != NULL)
+		{
+			next();
+		}
+		else
+		{
+			Clear();
+		}
+	}
+}
+
+// For the one-shot modes, which have nothing else to do while a message is showing.
+void Display::Wait()
+{
+	while (IsBusy())
+	{
+		Update();
+	}
+}
+
+void Display::WriteDaysHoursMinutesPage()
+{
+	DaysHoursMinutes(pendingDays, pendingHours, pendingMinutes);
+	Hold(NULL);
+}
+
+// Read from distanceSource and hintSource when the page is drawn, not when it was asked for, and kept up to date while it shows.
+void Display::WriteDistancePage()
+{
+	RefreshDistancePage();
+	Hold(NULL);
+	refreshPage = RefreshDistancePage;
+	lastRefresh = millis();
 }
 
-void Display::DelayClear()
+// Flush() only sends the cells that changed, so this is just the digits and the hint.
+void Display::RefreshDistancePage()
 {
-	delay(3000);
-	Clear();
+	Compose(messageMeters, distanceSource());
+	directionHint hint = hintSource();
+	PutText(5, 1, &compassNames[Bearing::CompassPoint(hint.bearing) * 2], 2);
+	PutText(9, 1, &trendNames[hint.trend * 6], 6);
+	Flush();
+}
+
+void Display::WriteSecondsPage()
+{
+	Write(messageSeconds, pendingValue);
+	Hold(NULL);
 }
 
 void Display::WriteSearchBeginsIn(uint8_t days, uint8_t hours, uint8_t minutes)
 {
-	//Write("Search will", "begin in...");
-	delay(3000);
-	DaysHoursMinutes(days, hours, minutes);
-	DelayClear();
+	Write(messageSearchBeginsIn);
+	pendingDays = days;
+	pendingHours = hours;
+	pendingMinutes = minutes;
+	Hold(WriteDaysHoursMinutesPage);
 }
 
 void Display::WriteNextStageBeginsNow()
 {
-	//Write("Next stage", "commencing");
-	DelayClear();
+	Write(messageNextStageBeginsNow);
+	Hold(NULL);
 }
 
 void Display::WriteStageXOfYComplete(uint8_t currentPoint, uint8_t totalPoints)
 {
-	//Write("Stage " + String(currentPoint) + " of " + String(totalPoints), "complete");
-	DelayClear();
+	Write(messageStageComplete, currentPoint, totalPoints);
+	Hold(NULL);
 }
 
 void Display::WriteObtainingGPSLocationFix()
 {
-	//Write("Obtaining GPS", "location fix...");
+	Write(messageObtainingFix);
 }
 
-void Display::WriteDistanceRemaining(uint32_t distance)
+void Display::WriteDistanceRemaining(uint32_t (*distance)(), directionHint (*hint)())
 {
-	Clear();
-	//Write("Distance to", "location...");
-	delay(3000);
-	//Write(String(distance) + " Meters");
-	DelayClear();
+	Write(messageDistanceTo);
+	distanceSource = distance;
+	hintSource = hint;
+	Hold(WriteDistancePage);
 }
 
 void Display::WriteLocationReached()
 {
-	Clear();
-	//Write("Location has", "been found");
-	DelayClear();
+	Write(messageLocationReached);
+	Hold(NULL);
 }
 
 void Display::WriteTimeToUnlock(uint8_t days, uint8_t hours, uint8_t minutes)
 {
-	//Write("Unlock window", "will start in...");
-	delay(3000);
-	//DaysHoursMinutes(days, hours, minutes);
-	DelayClear();
+	Write(messageWindowStartsIn);
+	pendingDays = days;
+	pendingHours = hours;
+	pendingMinutes = minutes;
+	Hold(WriteDaysHoursMinutesPage);
 }
 
 void Display::WriteUnlockTimeRemaining(uint8_t days, uint8_t hours, uint8_t minutes)
 {
-	//Write("Unlock window", "will last for...");
-	delay(3000);
-	DaysHoursMinutes(days, hours, minutes);
-	DelayClear();
+	Write(messageWindowLastsFor);
+	pendingDays = days;
+	pendingHours = hours;
+	pendingMinutes = minutes;
+	Hold(WriteDaysHoursMinutesPage);
 }
 
 void Display::WriteSerialMode()
 {
-	//Write("Serial mode");
+	Write(messageSerialMode);
 }
 
 void Display::WriteCalibratingRTC()
 {
-	//Write("Calibrating RTC", "from GPS fix...");
+	Write(messageCalibratingRtc);
 }
 
 void Display::WriteRTCOffBy(uint32_t delta)
 {
-	//Write("Real Time Clock", "was off by...");
-	delay(3000);
-	//Write(String(delta), "Seconds");
-	DelayClear();
+	Write(messageRtcOffBy);
+	pendingValue = delta;
+	Hold(WriteSecondsPage);
+}
+
+// One part per million is 86.4 ms a day. Widened before abs, as -32768 has no int16_t magnitude; an int is 16 bits on the AVR.
+void Display::WriteRtcDrift(int16_t driftCentiPpm)
+{
+	uint32_t msPerDay = ((uint32_t)abs((int32_t)driftCentiPpm) * 864 + 500) / 1000;
+	Write(driftCentiPpm < 0 ? messageRtcLoses : messageRtcGains, msPerDay);
+	Hold(NULL);
 }
 
 void Display::WriteTimeExtensionValues(uint8_t hours, uint8_t mins)
 {
-	//Write("Enter Value:");
-	lcd->setCursor(0, 1);
-	if (hours < 10) {
-		lcd->print('0');
-		lcd->setCursor(1, 1);
-	}
-	lcd->print(hours);
-	lcd->setCursor(14, 1);
-	if (mins < 10) {
-		lcd->print('0');
-		lcd->setCursor(15, 1);
-	}
-	lcd->print(mins);
+	Write(messageEnterValue, hours, mins);
 }
 
 void Display::WriteTimeExtended()
 {
-	//Write("Time Extended");
-	DelayClear();
+	Write(messageTimeExtended);
+	Hold(NULL);
 }
 
 void Display::WriteEnterPasscode()
 {
-	//Write("Passcode:");
+	Write(messagePasscode);
 }
 
 void Display::CharTyped(uint8_t dotCount)
 {
-	lcd->setCursor(dotCount, 1);
-	//lcd->print("*");
+	if (dotCount < DISPLAY_COLUMNS)
+	{
+		frame[1][dotCount] = '*';
+		Flush();
+	}
 }
 
 void Display::WriteInsertBothKeys()
 {
-	//Write("Insert second", "key to unlock");
-	DelayClear();
+	Write(messageInsertBothKeys);
+	Hold(NULL);
 }
 
 void Display::WriteAccessGranted()
 {
-	//Write("Access Granted", "Welcome");
-	DelayClear();
+	Write(messageAccessGranted);
+	Hold(NULL);
 }
 
 void Display::WriteAccessDenied()
 {
-	//Write("Access Denied");
-	DelayClear();
+	Write(messageAccessDenied);
+	Hold(NULL);
 }
 
 void Display::WriteTooLate()
 {
-	Clear();
-	//Write("Too Late", "Window Missed");
-	DelayClear();
+	Write(messageTooLate);
+	Hold(NULL);
+}
+
+void Display::WriteConfigInvalid()
+{
+	Write(messageConfigInvalid);
+	Hold(NULL);
+}
+
+void Display::WriteNoGpsFix()
+{
+	Write(messageNoGpsFix);
+	Hold(NULL);
 }
 
 void Display::WriteGoodbye()
 {
-	//Write("Goodbye");
-	DelayClear();
+	Write(messageGoodbye);
+	Hold(NULL);
 }
 
 void Display::Clear()
 {
-	lcd->setCursor(0, 0);
-	lcd->print("                ");
-	lcd->setCursor(0, 1);
-	lcd->print("                ");
+	ClearFrame();
+	Flush();
 }
\ No newline at end of file
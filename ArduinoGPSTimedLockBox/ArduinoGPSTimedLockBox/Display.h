@@ -8,14 +8,68 @@
 #endif
 
 #include <LiquidCrystal_I2C.h>
+#include "CommonDataTypes.h"
+
+#define DISPLAY_HOLD_MS 3000
+#define DISPLAY_REFRESH_MS 250 // How often a page showing a live value redraws it.
+#define DISPLAY_COLUMNS 16
+#define DISPLAY_ROWS 2
+#define DISPLAY_MAX_SLOTS 3
+
+enum displayMessage {
+	messageSearchBeginsIn, messageLessThanAMinute, messageDaysHoursMinutes, messageNextStageBeginsNow, messageStageComplete,
+	messageObtainingFix, messageDistanceTo, messageMeters, messageLocationReached, messageWindowStartsIn, messageWindowLastsFor,
+	messageSerialMode, messageCalibratingRtc, messageRtcOffBy, messageSeconds, messageRtcGains, messageRtcLoses, messageEnterValue, messageTimeExtended, messagePasscode,
+	messageInsertBothKeys, messageAccessGranted, messageAccessDenied, messageTooLate, messageConfigInvalid, messageNoGpsFix, messageGoodbye, messageCount
+};
+
+// A number drawn into a message, right aligned in Width cells and padded with Fill. Width 0 marks an unused slot.
+struct MessageSlot
+{
+	uint8_t Row;
+	uint8_t Column;
+	uint8_t Width;
+	char Fill;
+};
+
+// Both lines, already padded to the full width, followed by where the message's numbers go. Kept in flash.
+struct DisplayMessage
+{
+	char Text[DISPLAY_ROWS * DISPLAY_COLUMNS + 1];
+	MessageSlot Slots[DISPLAY_MAX_SLOTS];
+};
 
 class Display
 {
 private:
 	static LiquidCrystal_I2C* lcd;
-	static void Write(char* lineOne, char* lineTwo);
+	static char frame[DISPLAY_ROWS][DISPLAY_COLUMNS];
+	static char shown[DISPLAY_ROWS][DISPLAY_COLUMNS];
+	static const DisplayMessage messages[messageCount];
+	static void ClearFrame();
+	static void PutNumber(uint8_t column, uint8_t row, uint8_t width, char fill, uint32_t value);
+	static void Flush();
+	static void Compose(displayMessage message, uint32_t first = 0, uint32_t second = 0, uint32_t third = 0);
+	static void Write(displayMessage message, uint32_t first = 0, uint32_t second = 0, uint32_t third = 0);
+	static void PutText(uint8_t column, uint8_t row, const char* text, uint8_t length);
 	static void DaysHoursMinutes(uint8_t days, uint8_t hours, uint8_t minutes);
-	static void DelayClear();
+	static void Hold(void (*next)());
+	static void WriteDaysHoursMinutesPage();
+	static void WriteDistancePage();
+	static void RefreshDistancePage();
+	static void WriteSecondsPage();
+
+	static bool holding;
+	static uint32_t holdStart;
+	static void (*nextPage)();
+	static void (*refreshPage)();
+	static uint32_t lastRefresh;
+	static uint32_t (*distanceSource)();
+	static directionHint (*hintSource)();
+	static uint8_t pendingDays;
+	static uint8_t pendingHours;
+	static uint8_t pendingMinutes;
+	static uint32_t pendingValue;
 public:
 	Display();
 	static void Initialize();
@@ -25,13 +79,14 @@ public:
 	static void WriteNextStageBeginsNow();
 	static void WriteStageXOfYComplete(uint8_t currentPoint, uint8_t totalPoints);
 	static void WriteObtainingGPSLocationFix();
-	static void WriteDistanceRemaining(uint32_t);
+	static void WriteDistanceRemaining(uint32_t (*distance)(), directionHint (*hint)());
 	static void WriteTimeToUnlock(uint8_t, uint8_t, uint8_t);
 	static void WriteLocationReached();
 	static void WriteUnlockTimeRemaining(uint8_t, uint8_t, uint8_t);
 	static void WriteSerialMode();
 	static void WriteCalibratingRTC();
 	static void WriteRTCOffBy(uint32_t delta);
+	static void WriteRtcDrift(int16_t driftCentiPpm);
 	static void WriteTimeExtensionValues(uint8_t hours, uint8_t mins);
 	static void WriteTimeExtended();
 	static void WriteEnterPasscode();
@@ -40,8 +95,13 @@ public:
 	static void WriteAccessGranted();
 	static void WriteAccessDenied();
 	static void WriteTooLate();
+	static void WriteConfigInvalid();
+	static void WriteNoGpsFix();
 	static void WriteGoodbye();
 	static void Clear();
+	static bool IsBusy();
+	static void Update();
+	static void Wait();
 };
 
 #endif
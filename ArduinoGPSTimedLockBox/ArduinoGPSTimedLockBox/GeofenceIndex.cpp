@@ -0,0 +1,167 @@
+#include "GeofenceIndex.h"
+#include <stdlib.h>
+
+// 1e-7 degree units per meter of latitude.
+static const float unitsPerMeter = 1.0 / (NeoGPS::Location_t::EARTH_RADIUS_KM * 1000.0 * NeoGPS::Location_t::RAD_PER_DEG * NeoGPS::Location_t::LOC_SCALE);
+
+static int CompareCells(const void* a, const void* b)
+{
+	uint32_t keyA = ((const GeofenceCell*)a)->Key;
+	uint32_t keyB = ((const GeofenceCell*)b)->Key;
+	if (keyA < keyB) { return -1; }
+	if (keyA > keyB) { return 1; }
+	return (int)((const GeofenceCell*)a)->Zone - (int)((const GeofenceCell*)b)->Zone; // Keeps each cell's zones in zone order.
+}
+
+GeofenceIndex::GeofenceIndex(GeofenceZone* zoneArray, GeofenceCell* cellArray, uint16_t cellArrayLength)
+{
+	zones = zoneArray;
+	zoneCount = 0;
+	cells = cellArray;
+	cellCapacity = cellArrayLength;
+	cellCount = 0;
+}
+
+uint16_t GeofenceIndex::LatCell(int32_t latitude)
+{
+	return (uint32_t)(latitude + 900000000L) >> GEOFENCE_CELL_SHIFT;
+}
+
+uint16_t GeofenceIndex::LonCell(int32_t longitude)
+{
+	uint32_t offset = (uint32_t)longitude + 1800000000UL; // Counted from -180 degrees.
+	if (offset >= 3600000000UL)
+	{
+		offset = 0; // +180 is the same place as -180.
+	}
+	return offset >> GEOFENCE_CELL_SHIFT;
+}
+
+uint32_t GeofenceIndex::CellKey(uint16_t latCell, uint16_t lonCell)
+{
+	return ((uint32_t)latCell << 15) | lonCell;
+}
+
+void GeofenceIndex::SetZone(GeofenceZone& zone, latLongLocation location, uint16_t radiusMeters, zoneKind kind)
+{
+	zone.Fence.init(NeoGPS::Location_t(location.latitude, location.longitude), radiusMeters);
+	zone.Kind = kind;
+}
+
+// Adds one cell entry for the zone for every cell in the box. Longitudes are offsets from -180 degrees.
+bool GeofenceIndex::AddCells(uint16_t zone, int32_t latLow, int32_t latHigh, uint32_t lonLow, uint32_t lonHigh)
+{
+	for (uint16_t latCell = LatCell(latLow); latCell <= LatCell(latHigh); latCell++)
+	{
+		for (uint16_t lonCell = lonLow >> GEOFENCE_CELL_SHIFT; lonCell <= (lonHigh >> GEOFENCE_CELL_SHIFT); lonCell++)
+		{
+			if (cellCount >= cellCapacity)
+			{
+				return false;
+			}
+			cells[cellCount].Key = CellKey(latCell, lonCell);
+			cells[cellCount].Zone = zone;
+			cellCount++;
+		}
+	}
+	return true;
+}
+
+// Lists every zone under each cell its bounding box touches, then sorts the list by cell.
+// Returns false if the cell array is too small, or a zone is too close to a pole to be boxed.
+bool GeofenceIndex::Build(uint16_t numberOfZones)
+{
+	zoneCount = numberOfZones;
+	cellCount = 0;
+
+	for (uint16_t z = 0; z < zoneCount; z++)
+	{
+		const NeoGPS::Location_t& center = zones[z].Fence.center();
+		float latUnits = zones[z].Fence.radiusM() * unitsPerMeter;
+		float cosLat = cos(center.lat() * NeoGPS::Location_t::RAD_PER_DEG * NeoGPS::Location_t::LOC_SCALE);
+		if (cosLat * 900000000.0 <= latUnits)
+		{
+			return false;
+		}
+		int32_t lonUnits = latUnits / cosLat;
+
+		int32_t latLow = max(center.lat() - (int32_t)latUnits, -900000000L);
+		int32_t latHigh = min(center.lat() + (int32_t)latUnits, 900000000L);
+
+		// A box that runs past +/-180 degrees is split in two, so every cell is numbered the same way a fix's cell is.
+		int64_t lonLow = (int64_t)center.lon() + 1800000000L - lonUnits;
+		int64_t lonHigh = (int64_t)center.lon() + 1800000000L + lonUnits;
+		bool added = true;
+		if (lonLow < 0)
+		{
+			added &= AddCells(z, latLow, latHigh, lonLow + 3600000000LL, 3599999999UL);
+			lonLow = 0;
+		}
+		if (lonHigh >= 3600000000LL)
+		{
+			added &= AddCells(z, latLow, latHigh, 0, lonHigh - 3600000000LL);
+			lonHigh = 3599999999UL;
+		}
+		added &= AddCells(z, latLow, latHigh, lonLow, lonHigh);
+		if (!added)
+		{
+			return false;
+		}
+	}
+
+	qsort(cells, cellCount, sizeof(GeofenceCell), CompareCells);
+	return true;
+}
+
+uint16_t GeofenceIndex::LowerBound(uint32_t searchKey)
+{
+	uint16_t low = 0;
+	uint16_t high = cellCount;
+	while (low < high)
+	{
+		uint16_t middle = low + ((high - low) / 2);
+		if (cells[middle].Key < searchKey)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+// Fills found with the numbers of up to maxFound zones containing position, and returns how many it filled.
+uint8_t GeofenceIndex::FindContaining(const NeoGPS::Location_t& position, uint16_t* found, uint8_t maxFound)
+{
+	uint32_t positionKey = CellKey(LatCell(position.lat()), LonCell(position.lon()));
+	uint8_t count = 0;
+	for (uint16_t i = LowerBound(positionKey); (i < cellCount) && (cells[i].Key == positionKey) && (count < maxFound); i++)
+	{
+		if (zones[cells[i].Zone].Fence.contains(position))
+		{
+			found[count++] = cells[i].Zone;
+		}
+	}
+	return count;
+}
+
+// Same answer as FindContaining, by testing every zone. Used when checking the index.
+uint8_t GeofenceIndex::FindContainingLinear(const NeoGPS::Location_t& position, uint16_t* found, uint8_t maxFound)
+{
+	uint8_t count = 0;
+	for (uint16_t z = 0; (z < zoneCount) && (count < maxFound); z++)
+	{
+		if (zones[z].Fence.contains(position))
+		{
+			found[count++] = z;
+		}
+	}
+	return count;
+}
+
+uint16_t GeofenceIndex::GetCellCount()
+{
+	return cellCount;
+}
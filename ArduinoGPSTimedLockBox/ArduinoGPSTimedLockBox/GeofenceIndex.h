@@ -0,0 +1,54 @@
+#ifndef _GEOFENCEINDEX_h
+#define _GEOFENCEINDEX_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <NMEAGPS.h>
+#include "CommonDataTypes.h"
+
+// Cells are 2^17 units of 1e-7 degrees, about 1.46km of latitude.
+#define GEOFENCE_CELL_SHIFT 17
+
+struct GeofenceZone
+{
+	NeoGPS::Geofence_t Fence;
+	uint8_t Kind = zoneTarget;
+};
+
+// One entry for every cell a zone's bounding box touches. Sorted by Key so a cell's zones are found with a binary search.
+struct GeofenceCell
+{
+	uint32_t Key;
+	uint16_t Zone;
+};
+
+// Answers "which zones contain this position" by only testing the zones listed for the position's cell.
+// The caller owns both arrays, so the size of the index is decided where the zones come from.
+class GeofenceIndex
+{
+private:
+	GeofenceZone* zones;
+	uint16_t zoneCount;
+	GeofenceCell* cells;
+	uint16_t cellCapacity;
+	uint16_t cellCount;
+
+	static uint16_t LatCell(int32_t latitude);
+	static uint16_t LonCell(int32_t longitude);
+	static uint32_t CellKey(uint16_t latCell, uint16_t lonCell);
+	bool AddCells(uint16_t zone, int32_t latLow, int32_t latHigh, uint32_t lonLow, uint32_t lonHigh);
+	uint16_t LowerBound(uint32_t searchKey);
+public:
+	GeofenceIndex(GeofenceZone* zoneArray, GeofenceCell* cellArray, uint16_t cellArrayLength);
+	static void SetZone(GeofenceZone& zone, latLongLocation location, uint16_t radiusMeters, zoneKind kind);
+	bool Build(uint16_t numberOfZones);
+	uint8_t FindContaining(const NeoGPS::Location_t& position, uint16_t* found, uint8_t maxFound);
+	uint8_t FindContainingLinear(const NeoGPS::Location_t& position, uint16_t* found, uint8_t maxFound);
+	uint16_t GetCellCount();
+};
+
+#endif
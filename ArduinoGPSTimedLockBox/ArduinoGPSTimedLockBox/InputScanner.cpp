@@ -0,0 +1,121 @@
+#include "InputScanner.h"
+
+scanResult InputScanner::error = scanOk;
+uint8_t InputScanner::errorPosition = 0;
+uint8_t InputScanner::errorField = 0;
+char InputScanner::errorFormatCharacter = 0;
+
+// Fields are written to fields in the order they appear in the format. limits (in PROGMEM) has one entry per field, or is NULL if any value will do.
+bool InputScanner::Scan(const char* input, const char* format, const ScanFieldLimit* limits, int32_t* fields)
+{
+	uint8_t position = 0;
+	uint8_t field = 0;
+	uint8_t fieldStart = 0;
+	char fieldLetter = 0;
+	int32_t value = 0;
+	bool negative = false;
+	bool fieldNegative = false;
+
+	while (true)
+	{
+		char formatCharacter = pgm_read_byte(format + position);
+		char inputCharacter = input[position];
+
+		if (formatCharacter >= 'a' && formatCharacter <= 'z')
+		{
+			uint8_t digit = inputCharacter - '0';
+			if (digit > 9)
+			{
+				return Fail(inputCharacter == '\0' ? scanTooShort : scanExpectedDigit, position, field, formatCharacter);
+			}
+			if (formatCharacter == fieldLetter)
+			{
+				// Saturate rather than wrap, so too many digits can never come back as a value in range.
+				value = value > (SCAN_SATURATED - 9) / 10 ? SCAN_SATURATED : value * 10 + digit;
+			}
+			else
+			{
+				if (fieldLetter && !EndField(fields, field, limits, value, fieldNegative, fieldStart, fieldLetter))
+				{
+					return false;
+				}
+				fieldNegative = negative;
+				negative = false;
+				fieldLetter = formatCharacter;
+				fieldStart = position;
+				value = digit;
+			}
+		}
+		else if (formatCharacter == '\0')
+		{
+			if (fieldLetter && !EndField(fields, field, limits, value, fieldNegative, fieldStart, fieldLetter))
+			{
+				return false;
+			}
+			if (inputCharacter != '\0')
+			{
+				return Fail(scanTooLong, position, field, formatCharacter);
+			}
+			error = scanOk;
+			return true;
+		}
+		else if (inputCharacter == '\0')
+		{
+			return Fail(scanTooShort, position, field, formatCharacter);
+		}
+		else if (formatCharacter == '+')
+		{
+			if (inputCharacter != '+' && inputCharacter != '-')
+			{
+				return Fail(scanExpectedSign, position, field, formatCharacter);
+			}
+			negative = inputCharacter == '-';
+		}
+		else if (inputCharacter != formatCharacter)
+		{
+			return Fail(scanExpectedCharacter, position, field, formatCharacter);
+		}
+		position++;
+	}
+}
+
+bool InputScanner::EndField(int32_t* fields, uint8_t& field, const ScanFieldLimit* limits, int32_t value, bool negative, uint8_t fieldStart, char fieldLetter)
+{
+	if (limits && (value < (int32_t)pgm_read_word(&limits[field].Minimum) || value > (int32_t)pgm_read_word(&limits[field].Maximum)))
+	{
+		return Fail(scanOutOfRange, fieldStart, field, fieldLetter);
+	}
+	fields[field++] = negative ? -value : value;
+	return true;
+}
+
+// Always returns false, so a failing scan can return it directly.
+bool InputScanner::Fail(scanResult result, uint8_t position, uint8_t field, char formatCharacter)
+{
+	error = result;
+	errorPosition = position;
+	errorField = field;
+	errorFormatCharacter = formatCharacter;
+	return false;
+}
+
+scanResult InputScanner::GetError()
+{
+	return error;
+}
+
+uint8_t InputScanner::GetErrorPosition()
+{
+	return errorPosition;
+}
+
+// For scanOutOfRange, the index of the field that broke its limits.
+uint8_t InputScanner::GetErrorField()
+{
+	return errorField;
+}
+
+char InputScanner::GetErrorFormatCharacter()
+{
+	return errorFormatCharacter;
+}
@@ -0,0 +1,41 @@
+#ifndef _INPUTSCANNER_h
+#define _INPUTSCANNER_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#define SCAN_SATURATED 0x7FFFFFFFL
+
+enum scanResult { scanOk, scanTooShort, scanTooLong, scanExpectedSign, scanExpectedDigit, scanExpectedCharacter, scanOutOfRange };
+
+struct ScanFieldLimit
+{
+	uint16_t Minimum;
+	uint16_t Maximum;
+};
+
+// Validates and converts a fixed format entry in a single pass. A format (kept in PROGMEM) has one character per input character:
+// a lower case letter is a digit of the field it names, '+' takes a '+' or '-' that applies to the next field, and anything else must appear as is.
+// A run of the same letter is one field even across other characters, so "+cc.ccccccc" reads a coordinate as one whole number.
+// On failure the reason and the position of the first bad character are kept until the next scan.
+class InputScanner
+{
+private:
+	static scanResult error;
+	static uint8_t errorPosition;
+	static uint8_t errorField;
+	static char errorFormatCharacter;
+	static bool EndField(int32_t* fields, uint8_t& field, const ScanFieldLimit* limits, int32_t value, bool negative, uint8_t fieldStart, char fieldLetter);
+	static bool Fail(scanResult result, uint8_t position, uint8_t field, char formatCharacter);
+public:
+	static bool Scan(const char* input, const char* format, const ScanFieldLimit* limits, int32_t* fields);
+	static scanResult GetError();
+	static uint8_t GetErrorPosition();
+	static uint8_t GetErrorField();
+	static char GetErrorFormatCharacter();
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "Journal.h"
+
+JournalRecord Journal::latest;
+uint8_t Journal::latestSlot;
+
+// One pass over the region. The valid record with the newest sequence number is the current state.
+// Returns false if there is no state for this configuration yet.
+bool Journal::Recover(uint16_t configCrc)
+{
+	bool found = false;
+	latestSlot = JOURNAL_SLOT_COUNT - 1;
+	memset(&latest, 0, sizeof(latest));
+
+	JournalRecord record;
+	for (uint8_t slot = 0; slot < JOURNAL_SLOT_COUNT; slot++)
+	{
+		if (!ReadSlot(slot, record)) { continue; }
+		if (!found || (int16_t)(record.Sequence - latest.Sequence) > 0)
+		{
+			latest = record;
+			latestSlot = slot;
+			found = true;
+		}
+	}
+
+	if (!found || latest.ConfigCrc != configCrc)
+	{
+		ClearGameState(configCrc);
+		return false;
+	}
+	return true;
+}
+
+// Called once a new configuration has been saved. Even the same route set up again starts from the first point.
+void Journal::StartGame(uint16_t configCrc)
+{
+	Recover(configCrc);
+	ClearGameState(configCrc);
+	Append();
+}
+
+// The sequence, boot count and last fix carry over from one game to the next.
+void Journal::ClearGameState(uint16_t configCrc)
+{
+	latest.ConfigCrc = configCrc;
+	latest.PointIndex = 0;
+	latest.ExtendedFromPoint = 0;
+	latest.ExtensionSeconds = 0;
+	latest.Flags &= JOURNAL_FLAG_FIX_KNOWN;
+}
+
+bool Journal::ReadSlot(uint8_t slot, JournalRecord& record)
+{
+	EEPROM.get(JOURNAL_EEPROM_ADDRESS + slot * sizeof(JournalRecord), record);
+	return record.Crc == Crc16((const uint8_t*)&record, offsetof(JournalRecord, Crc));
+}
+
+void Journal::Append()
+{
+	latestSlot = (latestSlot + 1) % JOURNAL_SLOT_COUNT;
+	latest.Sequence++;
+	latest.Crc = Crc16((const uint8_t*)&latest, offsetof(JournalRecord, Crc));
+	EEPROM.put(JOURNAL_EEPROM_ADDRESS + latestSlot * sizeof(JournalRecord), latest);
+}
+
+uint8_t Journal::GetPointIndex()
+{
+	return latest.PointIndex;
+}
+
+bool Journal::IsTimeExtended()
+{
+	return latest.Flags & JOURNAL_FLAG_TIME_EXTENDED;
+}
+
+uint32_t Journal::GetExtensionSeconds()
+{
+	return latest.ExtensionSeconds;
+}
+
+uint8_t Journal::GetExtendedFromPoint()
+{
+	return latest.ExtendedFromPoint;
+}
+
+bool Journal::IsGameStartShifted()
+{
+	return latest.Flags & JOURNAL_FLAG_SHIFT_GAME_START;
+}
+
+bool Journal::IsWindowOpenShifted()
+{
+	return latest.Flags & JOURNAL_FLAG_SHIFT_WINDOW_OPEN;
+}
+
+bool Journal::GetLastFix(latLongLocation& location)
+{
+	location.latitude = latest.LastLatitude;
+	location.longitude = latest.LastLongitude;
+	return latest.Flags & JOURNAL_FLAG_FIX_KNOWN;
+}
+
+uint16_t Journal::GetBootCount()
+{
+	return latest.BootCount;
+}
+
+void Journal::RecordBoot()
+{
+	latest.BootCount++;
+	Append();
+}
+
+void Journal::RecordPointIndex(uint8_t pointIndex)
+{
+	latest.PointIndex = pointIndex;
+	Append();
+}
+
+void Journal::RecordExtension(uint32_t duration, uint8_t fromPoint, bool shiftGameStart, bool shiftWindowOpen)
+{
+	latest.ExtensionSeconds = duration;
+	latest.ExtendedFromPoint = fromPoint;
+	latest.Flags |= JOURNAL_FLAG_TIME_EXTENDED;
+	if (shiftGameStart) { latest.Flags |= JOURNAL_FLAG_SHIFT_GAME_START; }
+	if (shiftWindowOpen) { latest.Flags |= JOURNAL_FLAG_SHIFT_WINDOW_OPEN; }
+	Append();
+}
+
+void Journal::RecordFix(latLongLocation location)
+{
+	latest.LastLatitude = location.latitude;
+	latest.LastLongitude = location.longitude;
+	latest.Flags |= JOURNAL_FLAG_FIX_KNOWN;
+	Append();
+}
+
+// CRC-16/CCITT-FALSE, also used for the configuration record. Pass the previous result as crc to continue over more data.
+uint16_t Journal::Crc16(const uint8_t* data, uint16_t length, uint16_t crc)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef _JOURNAL_h
+#define _JOURNAL_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <EEPROM.h>
+#include "CommonDataTypes.h"
+
+// The journal fills the EEPROM after the configuration record, apart from the clock model at the very end.
+#define JOURNAL_EEPROM_ADDRESS 128
+#define JOURNAL_EEPROM_BYTES 880
+#define JOURNAL_SLOT_COUNT (JOURNAL_EEPROM_BYTES / sizeof(JournalRecord))
+
+#define JOURNAL_FLAG_TIME_EXTENDED 0x01
+#define JOURNAL_FLAG_SHIFT_GAME_START 0x02
+#define JOURNAL_FLAG_SHIFT_WINDOW_OPEN 0x04
+#define JOURNAL_FLAG_FIX_KNOWN 0x08
+
+struct JournalRecord
+{
+	uint32_t ExtensionSeconds;
+	int32_t LastLatitude;
+	int32_t LastLongitude;
+	uint16_t Sequence;
+	uint16_t ConfigCrc;
+	uint16_t BootCount;
+	uint8_t PointIndex;
+	uint8_t ExtendedFromPoint;
+	uint8_t Flags;
+	uint16_t Crc;
+};
+
+// Append-only record of the game state that changes while a game is played.
+// Each change writes a whole record to the slot after the latest one, so the writes are spread over every slot in the region
+// and a record torn by a power cut fails its CRC and the one before it is used instead.
+// Records only apply to the configuration whose CRC they carry, and setup starts each game with a fresh record, so nothing is ever erased.
+class Journal
+{
+private:
+	static JournalRecord latest;
+	static uint8_t latestSlot;
+	static bool ReadSlot(uint8_t slot, JournalRecord& record);
+	static void Append();
+	static void ClearGameState(uint16_t configCrc);
+public:
+	static bool Recover(uint16_t configCrc);
+	static void StartGame(uint16_t configCrc);
+	static uint8_t GetPointIndex();
+	static bool IsTimeExtended();
+	static uint32_t GetExtensionSeconds();
+	static uint8_t GetExtendedFromPoint();
+	static bool IsGameStartShifted();
+	static bool IsWindowOpenShifted();
+	static bool GetLastFix(latLongLocation& location);
+	static uint16_t GetBootCount();
+
+	static void RecordBoot();
+	static void RecordPointIndex(uint8_t pointIndex);
+	static void RecordExtension(uint32_t duration, uint8_t fromPoint, bool shiftGameStart, bool shiftWindowOpen);
+	static void RecordFix(latLongLocation location);
+
+	static uint16_t Crc16(const uint8_t* data, uint16_t length, uint16_t crc = 0xFFFF);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "MotionPredictor.h"
+#include "PositionEstimator.h"
+
+// NeoGPS's longitude difference that copes with the antimeridian. Defined in Location.cpp.
+int32_t safeDLon(int32_t p2, int32_t p1);
+
+NeoGPS::Location_t MotionPredictor::lastLocation;
+uint32_t MotionPredictor::lastFixMicros = 0;
+int32_t MotionPredictor::velocityNorth = 0;
+int32_t MotionPredictor::velocityEast = 0;
+int16_t MotionPredictor::cosLatitude = 32767;
+bool MotionPredictor::known = false;
+
+// sin() of each whole degree from 0 to 90, Q15.
+static const int16_t sineTable[91] PROGMEM = {
+	0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+	5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+	11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+	16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+	21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+	25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+	28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+	30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+	32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+	32767
+};
+
+#define MAX_SPEED_MMPS 65535 // About 235 km/h. Keeps a horizon's worth of travel within 32 bit math.
+#define MIN_COS_LATITUDE 1144 // cos(88 degrees). Closer to the poles a millimeter east is too many units of longitude.
+#define LAT_UNITS_PER_MM_Q16 5887 // 1e-7 degrees of latitude per millimeter is 0.08983.
+#define DM_PER_UNIT_Q16 7287 // 1e-7 degrees are 0.11120 decimeters on NeoGPS's mean earth radius, so distances agree with DistanceKm.
+#define MAX_LOCAL_UNITS 290000 // About 3.2 km. Past 294702, units * DM_PER_UNIT_Q16 overflows 32 bits.
+#define MAX_LOCAL_LON_UNITS 524287 // The most that can be scaled by cos(latitude) * 2^12 in 32 bits.
+
+void MotionPredictor::Reset()
+{
+	known = false;
+	velocityNorth = 0;
+	velocityEast = 0;
+}
+
+// fixMicros is when the fix's position was true, which is its PPS edge when there is one.
+void MotionPredictor::Add(const gps_fix& fix, uint32_t fixMicros)
+{
+	if (!fix.valid.location)
+	{
+		return;
+	}
+	lastLocation = fix.location;
+	lastFixMicros = fixMicros;
+	cosLatitude = max(Cosine(fix.location.lat() / 100000), MIN_COS_LATITUDE);
+	known = true;
+
+	velocityNorth = 0;
+	velocityEast = 0;
+	if (fix.valid.speed && fix.valid.heading)
+	{
+		uint32_t speed = min(fix.speed_mkn() * 463 / 900, (uint32_t)MAX_SPEED_MMPS); // A knot is 1852/3600 m/s.
+		if (speed >= PREDICT_MIN_SPEED_MMPS)
+		{
+			velocityNorth = ((int32_t)speed * Cosine(fix.heading_cd())) >> 15;
+			velocityEast = ((int32_t)speed * Sine(fix.heading_cd())) >> 15;
+		}
+	}
+}
+
+bool MotionPredictor::IsMoving()
+{
+	return known && (velocityNorth != 0 || velocityEast != 0);
+}
+
+// How far the last fix will have moved by nowMicros, in millimeters north and east.
+void MotionPredictor::Travelled(uint32_t nowMicros, int32_t& northMm, int32_t& eastMm)
+{
+	int32_t elapsedMs = min((nowMicros - lastFixMicros) / 1000, (uint32_t)PREDICT_HORIZON_MS);
+	northMm = velocityNorth * elapsedMs / 1000;
+	eastMm = velocityEast * elapsedMs / 1000;
+}
+
+// Where the last fix will have got to by nowMicros, or the fix itself if it wasn't moving.
+NeoGPS::Location_t MotionPredictor::Predict(uint32_t nowMicros)
+{
+	int32_t northMm, eastMm;
+	Travelled(nowMicros, northMm, eastMm);
+	int32_t dLat = (northMm * LAT_UNITS_PER_MM_Q16) / 65536;
+	int32_t dLon = ((eastMm * LAT_UNITS_PER_MM_Q16) / 65536) * 32768 / cosLatitude;
+
+	int32_t lon = lastLocation.lon();
+	// Wrap at the antimeridian without going through a value that doesn't fit.
+	if (dLon > 0 && lon > 1800000000L - dLon)
+	{
+		lon = lon - 1800000000L + dLon - 1800000000L;
+	}
+	else if (dLon < 0 && lon < -1800000000L - dLon)
+	{
+		lon = lon + 1800000000L + dLon + 1800000000L;
+	}
+	else
+	{
+		lon += dLon;
+	}
+	return NeoGPS::Location_t(lastLocation.lat() + dLat, lon);
+}
+
+// Distance from where the last fix will have got to by nowMicros to the target. Both are measured from the last fix on a
+// flat local grid, as PositionEstimator does, so there's no floating point unless the target is kilometers away.
+uint32_t MotionPredictor::GetDistanceDm(const NeoGPS::Location_t& target, uint32_t nowMicros)
+{
+	int32_t dLat = target.lat() - lastLocation.lat();
+	int32_t dLon = safeDLon(target.lon(), lastLocation.lon());
+	int32_t eastUnits = (abs(dLon) <= MAX_LOCAL_LON_UNITS) ? (dLon * ((cosLatitude + 4) >> 3) + 2048) >> 12 : MAX_LOCAL_LON_UNITS;
+	if (abs(dLat) > MAX_LOCAL_UNITS || abs(eastUnits) > MAX_LOCAL_UNITS)
+	{
+		return NeoGPS::Location_t::DistanceKm(Predict(nowMicros), target) * 10000;
+	}
+	int32_t northMm, eastMm;
+	Travelled(nowMicros, northMm, eastMm);
+	// Every step rounds rather than truncates, or a few hundred meters away the distance comes out a few tenths short.
+	int32_t north = ((dLat * DM_PER_UNIT_Q16 + 32768) >> 16) - (northMm + ((northMm < 0) ? -50 : 50)) / 100;
+	int32_t east = ((eastUnits * DM_PER_UNIT_Q16 + 32768) >> 16) - (eastMm + ((eastMm < 0) ? -50 : 50)) / 100;
+	uint32_t dNorth = min(abs(north), 46340L);
+	uint32_t dEast = min(abs(east), 46340L);
+	return PositionEstimator::SquareRoot(dNorth * dNorth + dEast * dEast);
+}
+
+// Q15, from the table with straight lines between whole degrees.
+int16_t MotionPredictor::Sine(int32_t centidegrees)
+{
+	centidegrees %= 36000;
+	if (centidegrees < 0)
+	{
+		centidegrees += 36000;
+	}
+	bool negative = centidegrees >= 18000;
+	if (negative)
+	{
+		centidegrees -= 18000;
+	}
+	if (centidegrees > 9000)
+	{
+		centidegrees = 18000 - centidegrees;
+	}
+	uint8_t degree = centidegrees / 100;
+	int16_t value = pgm_read_word(&sineTable[degree]);
+	if (degree < 90)
+	{
+		int16_t next = pgm_read_word(&sineTable[degree + 1]);
+		value += ((int32_t)(next - value) * (centidegrees % 100)) / 100;
+	}
+	return negative ? -value : value;
+}
+
+int16_t MotionPredictor::Cosine(int32_t centidegrees)
+{
+	return Sine(centidegrees + 9000);
+}
@@ -0,0 +1,37 @@
+#ifndef _MOTIONPREDICTOR_h
+#define _MOTIONPREDICTOR_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <NMEAGPS.h>
+
+#define PREDICT_MIN_SPEED_MMPS 400 // Below this the reported heading is mostly noise, so the player is taken to be standing still.
+#define PREDICT_HORIZON_MS 5000 // Never extrapolate further than this past the last fix, in case fixes stop coming.
+
+// Carries the last fix forward at its reported speed and heading, so the distance shown between 1 Hz fixes keeps up with a walking player.
+// Integer only: velocity is kept in millimeters a second and positions in NeoGPS's 1e-7 degrees.
+class MotionPredictor
+{
+private:
+	static NeoGPS::Location_t lastLocation;
+	static uint32_t lastFixMicros;
+	static int32_t velocityNorth; // mm/s
+	static int32_t velocityEast; // mm/s
+	static int16_t cosLatitude; // Q15, at the last fix
+	static bool known;
+	static void Travelled(uint32_t nowMicros, int32_t& northMm, int32_t& eastMm);
+public:
+	static void Reset();
+	static void Add(const gps_fix& fix, uint32_t fixMicros);
+	static bool IsMoving();
+	static NeoGPS::Location_t Predict(uint32_t nowMicros);
+	static uint32_t GetDistanceDm(const NeoGPS::Location_t& target, uint32_t nowMicros);
+	static int16_t Sine(int32_t centidegrees);
+	static int16_t Cosine(int32_t centidegrees);
+};
+
+#endif
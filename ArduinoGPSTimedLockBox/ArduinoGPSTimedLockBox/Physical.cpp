@@ -1,8 +1,40 @@
 #include "Physical.h"
 
+#ifndef NMEAGPS_INTERRUPT_PROCESSING
+#error NMEAGPS_INTERRUPT_PROCESSING must be in the build flags, as board.txt sets it. Physical parses in the receive ISR.
+#endif
+#ifndef NMEAGPS_TIMESTAMP_FROM_PPS
+#error NMEAGPS_TIMESTAMP_FROM_PPS must be in the build flags, as board.txt sets it. Physical marks each second from the PPS edge.
+#endif
+
 NeoSWSerial Physical::gpsPort(RX_PIN, TX_PIN);
 NMEAGPS Physical::gps;
 gps_fix Physical::fix;
+volatile bool Physical::firstCharSeen = false;
+volatile uint32_t Physical::firstCharMillis = 0;
+bool Physical::firstCharTraced = false;
+bool Physical::firstFixTraced = false;
+volatile uint8_t Physical::ppsCount = 0;
+FixQualityPolicy Physical::qualityPolicy = { FIX_MIN_SATELLITES, FIX_MAX_HDOP, FIX_MIN_STATUS, FIX_SETTLE_MS };
+bool Physical::settleStarted = false;
+bool Physical::settled = false;
+uint32_t Physical::settleStartMillis = 0;
+uint16_t Physical::acceptedFixes = 0;
+uint16_t Physical::rejectedFixes = 0;
+uint32_t Physical::lastFixMillis = 0;
+bool Physical::powerSaveWanted = false;
+bool Physical::powerSaveSent = false;
+uint8_t Physical::ackPattern[8] = { 0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00 }; // UBX-ACK-ACK. The last two are the class and ID it acknowledges.
+volatile uint8_t Physical::ackProgress = 0;
+volatile bool Physical::ackReceived = false;
+
+#define UBX_CLASS_RXM 0x02
+#define UBX_CLASS_CFG 0x06
+#define UBX_RXM_PMREQ 0x41
+#define UBX_CFG_RXM 0x11
+
+static const uint8_t ubxPowerSaveMode[] PROGMEM = { 0x08, 0x01 }; // CFG-RXM: reserved, then low power mode 1, power save.
+static const uint8_t ubxBackupUntilReset[] PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00 }; // RXM-PMREQ: no duration, backup flag.
 
 Physical::Physical()
 {
@@ -11,7 +43,12 @@ Physical::Physical()
 
 void Physical::SerialBegin()
 {
+    // Characters are parsed as they arrive, inside the NeoSWSerial receive interrupt.
+    gpsPort.attachInterrupt(GpsIsr);
     gpsPort.begin(9600);
+    lastFixMillis = millis();
+    pinMode(PPS_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(PPS_PIN), PpsIsr, RISING);
 }
 
 void Physical::SerialEnd()
@@ -19,50 +56,344 @@ void Physical::SerialEnd()
     gpsPort.end();
 }
 
-void Physical::UpdateGPS()
+void Physical::GpsIsr(uint8_t c)
+{
+    if (!firstCharSeen)
+    {
+        firstCharMillis = millis();
+        firstCharSeen = true;
+    }
+    // Watch for the acknowledgement of the last UBX message sent. The NMEA parser ignores the binary bytes around it.
+    if (c == ackPattern[ackProgress])
+    {
+        if (++ackProgress == sizeof(ackPattern))
+        {
+            ackReceived = true;
+            ackProgress = 0;
+        }
+    }
+    else
+    {
+        ackProgress = (c == ackPattern[0]) ? 1 : 0;
+    }
+    gps.handle(c);
+}
+
+// Marks the start of each UTC second for NeoGPS's UTCsecondStart, and counts them so a second can be matched to its edge.
+void Physical::PpsIsr()
+{
+    gps.UTCsecondStart(micros());
+    ppsCount++;
+}
+
+// Take the newest complete fix that passes the quality policy from the queue filled by the ISR. Returns false straight away if there isn't one.
+// Fixes that fail are counted and dropped, so they never reach the position estimate or the fix the other methods use.
+bool Physical::ReadFix()
 {
-    while (true)
+    // The ISR can't call Trace, so the first character is traced here with the time the ISR saw it.
+    if (firstCharSeen && !firstCharTraced)
+    {
+        Trace::Record(traceFirstNmeaChar, firstCharMillis);
+        firstCharTraced = true;
+    }
+    // Sent once the receiver is talking, since a u-blox ignores commands while it is still starting up.
+    if (powerSaveWanted && firstCharSeen && !powerSaveSent)
+    {
+        SendUbx(UBX_CLASS_CFG, UBX_CFG_RXM, ubxPowerSaveMode, sizeof(ubxPowerSaveMode));
+        powerSaveSent = true;
+    }
+
+    bool accepted = false;
+    while (gps.available())
     {
-        // If we have a full sentance, read it to the fix structure.
-        if (gps.available(gpsPort))
+        gps_fix latest = gps.read();
+        if (!(latest.valid.location && latest.valid.date && latest.valid.time))
+        {
+            continue;
+        }
+        if (!firstFixTraced)
         {
-            fix = gps.read();
-            if (fix.valid.location && fix.valid.date && fix.valid.time)
+            Trace::Record(traceFirstValidFix);
+            firstFixTraced = true;
+        }
+        if (!IsFixGoodEnough(latest))
+        {
+            if (rejectedFixes < 0xFFFF)
             {
-                return;
+                rejectedFixes++;
             }
+            continue;
+        }
+        if (acceptedFixes < 0xFFFF)
+        {
+            acceptedFixes++;
         }
+        fix = latest;
+        lastFixMillis = millis();
+        PositionEstimator::Add(fix);
+        MotionPredictor::Add(fix, GetFixMicros());
+        accepted = true;
     }
+    return accepted;
 }
 
-time_t Physical::GetDateTimeInUtc()
+// Only compares fields NMEAGPS has already parsed. A fix missing a field the policy checks fails, since it can't be vouched for.
+bool Physical::IsFixGoodEnough(const gps_fix& candidate)
 {
-    while (true)
+    if (!candidate.valid.status || candidate.status < qualityPolicy.MinStatus)
+    {
+        return false;
+    }
+    if (qualityPolicy.MinSatellites != 0 && (!candidate.valid.satellites || candidate.satellites < qualityPolicy.MinSatellites))
     {
-        UpdateGPS();
-        if (fix.valid.date && fix.valid.time)
+        return false;
+    }
+    if (qualityPolicy.MaxHdop != 0 && (!candidate.valid.hdop || candidate.hdop > qualityPolicy.MaxHdop))
+    {
+        return false;
+    }
+
+    // The settle time starts with the first fix that passes the checks above.
+    if (!settled)
+    {
+        if (!settleStarted)
         {
-            return fix.dateTime + SECS_YR_2000; // dateTime object seems to want to resturn the time since 2000. I prefer 1970 as my epoch.
+            settleStartMillis = millis();
+            settleStarted = true;
         }
+        if (millis() - settleStartMillis < qualityPolicy.SettleMs)
+        {
+            return false;
+        }
+        settled = true;
     }
+    return true;
+}
+
+void Physical::SetFixQualityPolicy(const FixQualityPolicy& policy)
+{
+    qualityPolicy = policy;
+}
+
+// Fixes this boot with a location and time that passed the quality policy, and that failed it.
+uint16_t Physical::GetAcceptedFixCount()
+{
+    return acceptedFixes;
 }
 
-float Physical::GetAbsoluteDistanceFromPoint(latLongLocation targetLocation)
+uint16_t Physical::GetRejectedFixCount()
 {
-    while (true)
+    return rejectedFixes;
+}
+
+// Number of fixes dropped because the queue was full when the ISR finished one.
+uint16_t Physical::GetFixOverruns()
+{
+    return gps.overruns();
+}
+
+// Whether GPS_FIX_TIMEOUT_MS has passed since the last accepted fix, or since the port was opened if there hasn't been one.
+bool Physical::HasFixTimedOut()
+{
+    return millis() - lastFixMillis > GPS_FIX_TIMEOUT_MS;
+}
+
+// Puts a u-blox receiver into its cyclic power save mode once it starts talking. Other receivers ignore the message.
+// Not for calibration, which wants every PPS edge.
+void Physical::RequestPowerSave()
+{
+    powerSaveWanted = true;
+}
+
+// The receiver acknowledged the power save request, so it is a u-blox.
+bool Physical::IsUbloxAttached()
+{
+    return powerSaveSent && ackReceived;
+}
+
+// Puts a u-blox receiver into backup mode, where it draws microamps and keeps its almanac for a quick start next time.
+// It stays there until the power is cycled, so this is only for when the unit is finished.
+void Physical::PowerDown()
+{
+    SendUbx(UBX_CLASS_RXM, UBX_RXM_PMREQ, ubxBackupUntilReset, sizeof(ubxBackupUntilReset));
+    SerialEnd();
+}
+
+// payload is in flash. The acknowledgement, if one comes, is picked out of the received bytes by GpsIsr.
+void Physical::SendUbx(uint8_t messageClass, uint8_t messageId, const uint8_t* payload, uint8_t length)
+{
+    // GpsIsr reads the pattern, so it mustn't see one byte changed and not the other, or carry a match part way through
+    // the old pattern over to the new one.
+    noInterrupts();
+    ackReceived = false;
+    ackProgress = 0;
+    ackPattern[6] = messageClass;
+    ackPattern[7] = messageId;
+    interrupts();
+
+    uint8_t header[] = { messageClass, messageId, length, 0 };
+    uint8_t checkA = 0;
+    uint8_t checkB = 0;
+    gpsPort.write(0xB5);
+    gpsPort.write(0x62);
+    for (uint8_t i = 0; i < sizeof(header) + length; i++)
     {
-        UpdateGPS();
-        if (fix.valid.location)
+        uint8_t value = (i < sizeof(header)) ? header[i] : pgm_read_byte(payload + i - sizeof(header));
+        gpsPort.write(value);
+        checkA += value;
+        checkB += checkA;
+    }
+    gpsPort.write(checkA);
+    gpsPort.write(checkB);
+}
+
+// Waits for the next accepted fix, idling between characters. Returns false if GPS_FIX_TIMEOUT_MS passes without one.
+bool Physical::UpdateGPS()
+{
+    while (!ReadFix())
+    {
+        if (HasFixTimedOut())
         {
-            NeoGPS::Location_t target(targetLocation.latitude, targetLocation.longitude);
-            return fix.location.DistanceKm(target) * 1000; // Convert from kilometers to meters.
+            return false;
         }
-        delay(100);
+        Scheduler::Idle();
+    }
+    return true;
+}
+
+// Returns 0 if no fix comes before the timeout.
+time_t Physical::GetDateTimeInUtc()
+{
+    if (!UpdateGPS())
+    {
+        return 0;
+    }
+    return fix.dateTime + SECS_YR_2000; // dateTime object seems to want to resturn the time since 2000. I prefer 1970 as my epoch.
+}
+
+// Waits for the next fix with a time, and returns the UTC second it is for along with the count of the PPS edge that began that second.
+// The sentences for a second arrive after its PPS edge, so the last edge before a fix completes is the start of the fix's whole second.
+// (dateTime_cs only says how far into that second the fix was taken.) Returns false if there has been no PPS edge in the last second,
+// or if GPS_FIX_TIMEOUT_MS passes without a fix with a time, which HasFixTimedOut then reports.
+bool Physical::GetUtcSecondStart(time_t& utcSecond, uint8_t& edgeCount)
+{
+    while (gps.available())
+    {
+        gps.read(); // Anything already queued may be from before the last edge.
+    }
+
+    gps_fix latest;
+    do {
+        while (!gps.available())
+        {
+            if (HasFixTimedOut())
+            {
+                return false;
+            }
+            Scheduler::Idle();
+        }
+        latest = gps.read();
+    } while (!(latest.valid.date && latest.valid.time));
+
+    uint32_t edgeMicros;
+    GetLastPps(edgeMicros, edgeCount);
+    if (micros() - edgeMicros > 1000000UL)
+    {
+        return false;
+    }
+    utcSecond = latest.dateTime + SECS_YR_2000;
+    return true;
+}
+
+// When the fix just read was taken: the PPS edge that began its second, or if there's been no edge in the last second, now.
+uint32_t Physical::GetFixMicros()
+{
+    uint32_t edgeMicros;
+    uint8_t edgeCount;
+    GetLastPps(edgeMicros, edgeCount);
+    uint32_t now = micros();
+    return (now - edgeMicros < 1000000UL) ? edgeMicros : now;
+}
+
+void Physical::GetLastPps(uint32_t& edgeMicros, uint8_t& edgeCount)
+{
+    // Read again if an edge lands in between, so the two always belong together.
+    do {
+        edgeCount = ppsCount;
+        edgeMicros = gps.UTCsecondStart();
+    } while (edgeCount != ppsCount);
+}
+
+// In meters. While the player is moving, from where the last fix's speed and heading will have taken them by now, so it can be refreshed between fixes.
+// Standing still, from the averaged position once there is one, otherwise from the latest fix.
+uint32_t Physical::GetDistanceFromPoint(latLongLocation targetLocation)
+{
+    // The main loop keeps the fix current through ReadFix, so only wait if there has never been one.
+    while (!fix.valid.location && UpdateGPS())
+    {
+    }
+    NeoGPS::Location_t target(targetLocation.latitude, targetLocation.longitude);
+    if (MotionPredictor::IsMoving())
+    {
+        return MotionPredictor::GetDistanceDm(target, micros()) / 10;
+    }
+    if (PositionEstimator::HasEstimate())
+    {
+        return PositionEstimator::GetDistanceDm(target) / 10;
     }
+    return fix.location.DistanceKm(target) * 1000;
 }
 
+// Hundredths of a degree clockwise from north, from the same position GetDistanceFromPoint uses.
+uint16_t Physical::GetBearingToPoint(latLongLocation targetLocation)
+{
+    while (!fix.valid.location && UpdateGPS())
+    {
+    }
+    return Bearing::Between(GetCurrentLocation(), NeoGPS::Location_t(targetLocation.latitude, targetLocation.longitude));
+}
 
-bool Physical::IsWithinRadius(latLongLocation targetLocation)
+NeoGPS::Location_t Physical::GetCurrentLocation()
 {
-    return (GetAbsoluteDistanceFromPoint(targetLocation) <= 30);
+    if (MotionPredictor::IsMoving())
+    {
+        return MotionPredictor::Predict(micros());
+    }
+    if (PositionEstimator::HasEstimate())
+    {
+        return PositionEstimator::GetLocation();
+    }
+    return fix.location;
+}
+
+// Decides from the averaged position, and stays pending until its confidence circle is clear of the boundary.
+// A single fix near the edge would otherwise flip the answer from one boot to the next.
+positionDecision Physical::DecideWithinRadius(latLongLocation targetLocation)
+{
+    positionDecision decision = PositionEstimator::DecideWithin(NeoGPS::Location_t(targetLocation.latitude, targetLocation.longitude), WITHIN_RADIUS_METERS);
+    if (decision != decisionPending)
+    {
+        Trace::Record(traceDistanceComputed);
+    }
+    return decision;
+}
+
+latLongLocation Physical::GetFixLocation()
+{
+    while (!fix.valid.location && UpdateGPS())
+    {
+    }
+    latLongLocation location;
+    location.latitude = fix.location.lat();
+    location.longitude = fix.location.lon();
+    return location;
+}
+
+// The time of the fix the main loop last read, unlike GetDateTimeInUtc() which waits for the next one.
+time_t Physical::GetFixDateTime()
+{
+    while (!(fix.valid.date && fix.valid.time) && UpdateGPS())
+    {
+    }
+    return fix.dateTime + SECS_YR_2000;
 }
\ No newline at end of file
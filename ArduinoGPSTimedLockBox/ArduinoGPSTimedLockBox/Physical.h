@@ -11,9 +11,31 @@
 #include <NMEAGPS.h>
 #include <Time.h>
 #include "CommonDataTypes.h"
+#include "Trace.h"
+#include "PositionEstimator.h"
+#include "MotionPredictor.h"
+#include "Bearing.h"
+#include "Scheduler.h"
 
 #define RX_PIN 6
 #define TX_PIN 7
+#define PPS_PIN 2 // The GPS module's pulse per second output. Must be an external interrupt pin.
+#define WITHIN_RADIUS_METERS 30
+#define GPS_FIX_TIMEOUT_MS 300000UL // Give up after this long without an accepted fix, rather than waiting on a receiver that can't see the sky.
+
+// Default fix quality policy. A limit of 0 isn't checked.
+#define FIX_MIN_SATELLITES 5
+#define FIX_MAX_HDOP 4000 // x1000, as NeoGPS keeps it.
+#define FIX_MIN_STATUS gps_fix::STATUS_STD
+#define FIX_SETTLE_MS 10000 // A receiver's first fixes after a cold start wander, even when they pass the other checks.
+
+struct FixQualityPolicy
+{
+	uint8_t MinSatellites;
+	uint16_t MaxHdop;
+	gps_fix::status_t MinStatus;
+	uint16_t SettleMs;
+};
 
 class Physical
 {
@@ -21,14 +43,51 @@ private:
 	static NeoSWSerial gpsPort;
 	static NMEAGPS gps;
 	static gps_fix fix;
-	static void UpdateGPS();
+	static volatile bool firstCharSeen;
+	static volatile uint32_t firstCharMillis;
+	static bool firstCharTraced;
+	static bool firstFixTraced;
+	static volatile uint8_t ppsCount;
+	static FixQualityPolicy qualityPolicy;
+	static bool settleStarted;
+	static bool settled;
+	static uint32_t settleStartMillis;
+	static uint32_t lastFixMillis;
+	static bool powerSaveWanted;
+	static bool powerSaveSent;
+	static uint8_t ackPattern[8];
+	static volatile uint8_t ackProgress;
+	static volatile bool ackReceived;
+	static void SendUbx(uint8_t messageClass, uint8_t messageId, const uint8_t* payload, uint8_t length);
+	static uint16_t acceptedFixes;
+	static uint16_t rejectedFixes;
+	static bool IsFixGoodEnough(const gps_fix& candidate);
+	static uint32_t GetFixMicros();
+	static NeoGPS::Location_t GetCurrentLocation();
+	static void GpsIsr(uint8_t c);
+	static void PpsIsr();
+	static bool UpdateGPS();
 public:
 	Physical();
 	static void SerialBegin();
 	static void SerialEnd();
+	static bool ReadFix();
+	static uint16_t GetFixOverruns();
+	static bool HasFixTimedOut();
+	static void RequestPowerSave();
+	static bool IsUbloxAttached();
+	static void PowerDown();
+	static void SetFixQualityPolicy(const FixQualityPolicy& policy);
+	static uint16_t GetAcceptedFixCount();
+	static uint16_t GetRejectedFixCount();
 	static time_t GetDateTimeInUtc();
-	static float GetAbsoluteDistanceFromPoint(latLongLocation targetLocation);
-	static bool IsWithinRadius(latLongLocation targetLocation);
+	static bool GetUtcSecondStart(time_t& utcSecond, uint8_t& edgeCount);
+	static void GetLastPps(uint32_t& edgeMicros, uint8_t& edgeCount);
+	static uint32_t GetDistanceFromPoint(latLongLocation targetLocation);
+	static uint16_t GetBearingToPoint(latLongLocation targetLocation);
+	static positionDecision DecideWithinRadius(latLongLocation targetLocation);
+	static latLongLocation GetFixLocation();
+	static time_t GetFixDateTime();
 };
 
 #endif
@@ -0,0 +1,255 @@
+#include "PositionEstimator.h"
+
+// NeoGPS's longitude difference that copes with the antimeridian. Defined in Location.cpp.
+int32_t safeDLon(int32_t p2, int32_t p1);
+
+PositionSample PositionEstimator::samples[ESTIMATE_WINDOW];
+uint8_t PositionEstimator::sampleCount = 0;
+uint8_t PositionEstimator::nextSample = 0;
+uint16_t PositionEstimator::fixesSinceReset = 0;
+NeoGPS::Location_t PositionEstimator::origin;
+uint16_t PositionEstimator::originCosLat = 4096;
+bool PositionEstimator::estimateValid = false;
+int16_t PositionEstimator::meanNorth = 0;
+int16_t PositionEstimator::meanEast = 0;
+uint16_t PositionEstimator::confidenceDm = 0;
+uint8_t PositionEstimator::keptCount = 0;
+
+// 1e-7 degrees of latitude are 0.11132 decimeters, which is 7296 / 2^16. The other way, a decimeter is 8.983 units.
+#define DM_PER_UNIT_Q16 7296
+#define UNITS_PER_DM_X1000 8983
+#define MAX_LOCAL_UNITS 290000 // ESTIMATE_RANGE_DM in 1e-7 degrees of latitude, with some to spare. Past 294337, units * DM_PER_UNIT_Q16 overflows 32 bits.
+#define MAX_LOCAL_LON_UNITS 524287 // The most that can be scaled by cos(latitude) * 2^12 in 32 bits. Away from the equator this limits the range east and west.
+
+void PositionEstimator::Reset()
+{
+	sampleCount = 0;
+	nextSample = 0;
+	fixesSinceReset = 0;
+	estimateValid = false;
+}
+
+void PositionEstimator::Add(const gps_fix& fix)
+{
+	if (!fix.valid.location)
+	{
+		return;
+	}
+
+	int32_t north, east;
+	if (sampleCount == 0 || !ToLocal(fix.location, north, east))
+	{
+		// Too far from the fixes before to average with them, so start the window again here.
+		sampleCount = 0;
+		nextSample = 0;
+		origin = fix.location;
+		originCosLat = cos(origin.lat() * NeoGPS::Location_t::RAD_PER_DEG * NeoGPS::Location_t::LOC_SCALE) * 4096.0; // The only floating point, once per origin.
+		north = 0;
+		east = 0;
+	}
+
+	// Weight by 1/HDOP^2, with HDOP in hundredths. Below 0.64 it makes no difference, and the cap keeps the weighted sums within 32 bits.
+	uint16_t hdop = ESTIMATE_DEFAULT_HDOP;
+#ifdef GPS_FIX_HDOP
+	if (fix.valid.hdop && fix.hdop != 0)
+	{
+		hdop = fix.hdop;
+	}
+#endif
+	uint16_t hundredths = constrain(hdop / 10, 64, 4095);
+
+	PositionSample& sample = samples[nextSample];
+	sample.North = north;
+	sample.East = east;
+	sample.Weight = (1UL << 24) / ((uint32_t)hundredths * hundredths);
+	nextSample = (nextSample + 1) % ESTIMATE_WINDOW;
+	if (sampleCount < ESTIMATE_WINDOW)
+	{
+		sampleCount++;
+	}
+	if (fixesSinceReset < 0xFFFF)
+	{
+		fixesSinceReset++;
+	}
+	Update();
+}
+
+// Decimeters north and east of the origin. Returns false if the location is more than ESTIMATE_RANGE_DM away.
+bool PositionEstimator::ToLocal(const NeoGPS::Location_t& location, int32_t& north, int32_t& east)
+{
+	int32_t dLat = location.lat() - origin.lat();
+	int32_t dLon = safeDLon(location.lon(), origin.lon());
+	if (abs(dLat) > MAX_LOCAL_UNITS || abs(dLon) > MAX_LOCAL_LON_UNITS)
+	{
+		return false;
+	}
+	int32_t eastUnits = (dLon * originCosLat) >> 12;
+	if (abs(eastUnits) > MAX_LOCAL_UNITS)
+	{
+		return false;
+	}
+	north = (dLat * DM_PER_UNIT_Q16) >> 16;
+	east = (eastUnits * DM_PER_UNIT_Q16) >> 16;
+	return (abs(north) <= ESTIMATE_RANGE_DM) && (abs(east) <= ESTIMATE_RANGE_DM);
+}
+
+// Sorts values in place. Count is at most ESTIMATE_WINDOW, so insertion sort is enough.
+int16_t PositionEstimator::Median(int16_t* values, uint8_t count)
+{
+	for (uint8_t i = 1; i < count; i++)
+	{
+		int16_t value = values[i];
+		uint8_t j = i;
+		for (; j > 0 && values[j - 1] > value; j--)
+		{
+			values[j] = values[j - 1];
+		}
+		values[j] = value;
+	}
+	return (count & 1) ? values[count / 2] : (int16_t)(((int32_t)values[count / 2 - 1] + values[count / 2]) / 2);
+}
+
+void PositionEstimator::Update()
+{
+	int16_t norths[ESTIMATE_WINDOW];
+	int16_t easts[ESTIMATE_WINDOW];
+	int16_t distances[ESTIMATE_WINDOW];
+	for (uint8_t i = 0; i < sampleCount; i++)
+	{
+		norths[i] = samples[i].North;
+		easts[i] = samples[i].East;
+	}
+	int16_t medianNorth = Median(norths, sampleCount);
+	int16_t medianEast = Median(easts, sampleCount);
+
+	for (uint8_t i = 0; i < sampleCount; i++)
+	{
+		uint32_t dNorth = min(abs((int32_t)samples[i].North - medianNorth), 32767L);
+		uint32_t dEast = min(abs((int32_t)samples[i].East - medianEast), 32767L);
+		distances[i] = min(SquareRoot(dNorth * dNorth + dEast * dEast), 32767);
+		norths[i] = distances[i]; // Median() sorts, so it gets a copy.
+	}
+	uint16_t outlierDm = max(3 * (uint16_t)Median(norths, sampleCount), ESTIMATE_OUTLIER_FLOOR_DM);
+
+	int32_t sumWeight = 0;
+	int32_t sumNorth = 0;
+	int32_t sumEast = 0;
+	keptCount = 0;
+	for (uint8_t i = 0; i < sampleCount; i++)
+	{
+		if ((uint16_t)distances[i] <= outlierDm)
+		{
+			sumWeight += samples[i].Weight;
+			sumNorth += (int32_t)samples[i].North * samples[i].Weight;
+			sumEast += (int32_t)samples[i].East * samples[i].Weight;
+			keptCount++;
+		}
+	}
+	meanNorth = (sumNorth + (sumNorth < 0 ? -sumWeight : sumWeight) / 2) / sumWeight;
+	meanEast = (sumEast + (sumEast < 0 ? -sumWeight : sumWeight) / 2) / sumWeight;
+
+	// The spread of the kept fixes, and the error HDOP predicts for one fix. Fixes a second apart share most of their error,
+	// so averaging them doesn't shrink either; the radius is twice the larger of the two.
+	uint32_t sumSquares = 0;
+	for (uint8_t i = 0; i < sampleCount; i++)
+	{
+		if ((uint16_t)distances[i] <= outlierDm)
+		{
+			uint32_t dNorth = min(abs((int32_t)samples[i].North - meanNorth), 8191L);
+			uint32_t dEast = min(abs((int32_t)samples[i].East - meanEast), 8191L);
+			sumSquares += dNorth * dNorth + dEast * dEast;
+		}
+	}
+	uint16_t spreadDm = SquareRoot(sumSquares / keptCount);
+	uint16_t hdopHundredths = SquareRoot(((uint32_t)keptCount << 24) / sumWeight); // Inverse of the mean weight.
+	uint16_t hdopErrorDm = ((uint32_t)ESTIMATE_UERE_DM * hdopHundredths) / 100;
+	confidenceDm = 2 * max(spreadDm, hdopErrorDm);
+	estimateValid = true;
+}
+
+bool PositionEstimator::HasEstimate()
+{
+	return estimateValid;
+}
+
+NeoGPS::Location_t PositionEstimator::GetLocation()
+{
+	int32_t northUnits = (int32_t)meanNorth * UNITS_PER_DM_X1000 / 1000;
+	int32_t eastUnits = (int32_t)meanEast * UNITS_PER_DM_X1000 / 1000;
+	int32_t lonUnits = (originCosLat == 0) ? eastUnits : (eastUnits * 4096) / originCosLat;
+	return NeoGPS::Location_t(origin.lat() + northUnits, origin.lon() + lonUnits);
+}
+
+uint16_t PositionEstimator::GetConfidenceRadiusDm()
+{
+	return confidenceDm;
+}
+
+// Fixes left after outliers were dropped.
+uint8_t PositionEstimator::GetKeptCount()
+{
+	return keptCount;
+}
+
+uint32_t PositionEstimator::GetDistanceDm(const NeoGPS::Location_t& target)
+{
+	int32_t north, east;
+	if (!ToLocal(target, north, east))
+	{
+		return NeoGPS::Location_t::DistanceKm(GetLocation(), target) * 10000;
+	}
+	uint32_t dNorth = min(abs(north - meanNorth), 46340L);
+	uint32_t dEast = min(abs(east - meanEast), 46340L);
+	return SquareRoot(dNorth * dNorth + dEast * dEast);
+}
+
+// Only decides once the confidence circle is wholly inside or wholly outside the fence: the mean position's distance from
+// the center, plus or minus the confidence radius, against the fence's radius. Integer math unless the center is beyond
+// ESTIMATE_RANGE_DM, where GetDistanceDm falls back to floating point.
+positionDecision PositionEstimator::DecideWithin(const NeoGPS::Location_t& center, uint16_t radiusM)
+{
+	if (!estimateValid || (keptCount < ESTIMATE_MIN_FIXES && fixesSinceReset < ESTIMATE_MAX_FIXES))
+	{
+		return decisionPending;
+	}
+	uint32_t distanceDm = GetDistanceDm(center);
+	uint32_t radiusDm = radiusM * 10UL;
+	if (fixesSinceReset >= ESTIMATE_MAX_FIXES)
+	{
+		return (distanceDm <= radiusDm) ? decisionInside : decisionOutside;
+	}
+	if (distanceDm + confidenceDm <= radiusDm)
+	{
+		return decisionInside;
+	}
+	if (distanceDm > radiusDm + confidenceDm)
+	{
+		return decisionOutside;
+	}
+	return decisionPending;
+}
+
+// Integer square root, rounded down.
+uint16_t PositionEstimator::SquareRoot(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
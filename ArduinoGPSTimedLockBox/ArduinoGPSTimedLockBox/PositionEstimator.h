@@ -0,0 +1,62 @@
+#ifndef _POSITIONESTIMATOR_h
+#define _POSITIONESTIMATOR_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <NMEAGPS.h>
+#include "CommonDataTypes.h"
+
+#define ESTIMATE_WINDOW 8 // Fixes averaged. Each one costs 6 bytes of RAM.
+#define ESTIMATE_MIN_FIXES 8 // Fixes needed, after outliers are dropped, before a decision is made. Multipath jumps last a few seconds, so fewer can all be one jump.
+#define ESTIMATE_MAX_FIXES 60 // After this many fixes without a decision, the mean alone decides, so a player standing on the boundary is not kept waiting.
+#define ESTIMATE_UERE_DM 30 // GPS ranging error in decimeters. Multiplied by HDOP it gives the error of a single fix.
+#define ESTIMATE_DEFAULT_HDOP 2000 // Assumed, x1000, for fixes that don't report HDOP.
+#define ESTIMATE_OUTLIER_FLOOR_DM 50 // Fixes this close to the median are never outliers, however tight the rest are.
+#define ESTIMATE_RANGE_DM 30000 // Fixes further than this from the window's origin start the window again there.
+
+// A fix held as decimeters north and east of the window's origin, with its weight.
+struct PositionSample
+{
+	int16_t North;
+	int16_t East;
+	uint16_t Weight;
+};
+
+// Averages the last ESTIMATE_WINDOW fixes into one position with a confidence radius, so a decision near a fence boundary
+// doesn't change with each fix. Fixes further than three times the median distance from the median position are dropped as
+// multipath outliers, and the rest are weighted by 1/HDOP^2. Fixed size, and only integer math once the window's origin is set.
+class PositionEstimator
+{
+private:
+	static PositionSample samples[ESTIMATE_WINDOW];
+	static uint8_t sampleCount;
+	static uint8_t nextSample;
+	static uint16_t fixesSinceReset;
+	static NeoGPS::Location_t origin;
+	static uint16_t originCosLat; // cos(origin latitude) * 2^12
+	static bool estimateValid;
+	static int16_t meanNorth;
+	static int16_t meanEast;
+	static uint16_t confidenceDm;
+	static uint8_t keptCount;
+
+	static bool ToLocal(const NeoGPS::Location_t& location, int32_t& north, int32_t& east);
+	static int16_t Median(int16_t* values, uint8_t count);
+	static void Update();
+public:
+	static void Reset();
+	static void Add(const gps_fix& fix);
+	static bool HasEstimate();
+	static NeoGPS::Location_t GetLocation();
+	static uint16_t GetConfidenceRadiusDm();
+	static uint8_t GetKeptCount();
+	static uint32_t GetDistanceDm(const NeoGPS::Location_t& target);
+	static positionDecision DecideWithin(const NeoGPS::Location_t& center, uint16_t radiusM);
+	static uint16_t SquareRoot(uint32_t value);
+};
+
+#endif
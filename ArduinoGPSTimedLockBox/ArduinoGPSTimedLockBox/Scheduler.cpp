@@ -0,0 +1,39 @@
+#include "Scheduler.h"
+#include <avr/sleep.h>
+
+ScheduledTask Scheduler::tasks[MAX_TASKS];
+uint8_t Scheduler::taskCount = 0;
+
+bool Scheduler::AddTask(taskFunction run, uint16_t periodMs)
+{
+	if (taskCount >= MAX_TASKS)
+	{
+		return false;
+	}
+	tasks[taskCount].run = run;
+	tasks[taskCount].periodMs = periodMs;
+	tasks[taskCount].lastRun = millis();
+	taskCount++;
+	return true;
+}
+
+void Scheduler::RunDueTasks()
+{
+	for (uint8_t i = 0; i < taskCount; i++)
+	{
+		uint32_t now = millis();
+		if (now - tasks[i].lastRun >= tasks[i].periodMs)
+		{
+			tasks[i].lastRun = now;
+			tasks[i].run();
+		}
+	}
+}
+
+// Stops the CPU until the next interrupt. The millis() tick wakes it at least every millisecond, and each GPS character,
+// PPS edge and key press wakes it sooner, so nothing is missed; the clocks and peripherals keep running.
+void Scheduler::Idle()
+{
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_mode();
+}
@@ -0,0 +1,34 @@
+#ifndef _SCHEDULER_h
+#define _SCHEDULER_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#define MAX_TASKS 6
+
+typedef void (*taskFunction)();
+
+// A task is run every periodMs milliseconds. A period of 0 runs it on every pass through the loop.
+struct ScheduledTask
+{
+	taskFunction run = NULL;
+	uint16_t periodMs = 0;
+	uint32_t lastRun = 0;
+};
+
+// Cooperative scheduler. Tasks must return quickly so the others get their turn; nothing here may call delay().
+class Scheduler
+{
+private:
+	static ScheduledTask tasks[MAX_TASKS];
+	static uint8_t taskCount;
+public:
+	static bool AddTask(taskFunction run, uint16_t periodMs);
+	static void RunDueTasks();
+	static void Idle();
+};
+
+#endif
@@ -3,21 +3,22 @@
 uint8_t Setup::numberOfPoints;
 uint8_t Setup::currentPointIndex;
 time_t Setup::gameStartDateTime;
-SinglePointConfiguration* Setup::singlePointConfigurationCollection[5];
+SinglePointConfiguration Setup::singlePointConfigurationCollection[MAX_POINTS];
 bool Setup::timeExtended;
+uint16_t Setup::configCrc;
+char Setup::inputBuffer[SETUP_INPUT_BUFFER_LENGTH];
+
+// Entry formats for InputScanner, one character per input character.
+static const char dateTimeFormat[] PROGMEM = "yyyy-nn-ddThh:mm:ss";
+static const char latitudeFormat[] PROGMEM = "+cc.ccccccc";
+static const char longitudeFormat[] PROGMEM = "+ccc.ccccccc";
+static const char windowDurationFormat[] PROGMEM = "ww";
+static const ScanFieldLimit dateTimeLimits[] PROGMEM = { { 1970, 2105 }, { 1, 12 }, { 1, 31 }, { 0, 23 }, { 0, 59 }, { 0, 59 } };
 
 Setup::Setup()
 {
-    for (uint8_t i = 0; i < 5; i++)
-    {
-        singlePointConfigurationCollection[i] = new SinglePointConfiguration();
-    }
 }
 
-//Setup::~Setup() {
-//    delete [] singlePointConfigurationCollection; //Removed as we are now static, add this back if we make this class non-static.
-//}
-
 void Setup::PrintErrorInvalidInputLength()
 {
     Serial.println(F("INVALID: Incorrect input length."));
@@ -91,10 +92,16 @@ void Setup::PrintSplashScreen()
     Serial.println(F("To continue, press any key..."));
 }
 
-void Setup::AwaitUserInput()
+// Returns the key pressed. A batch message is left in the buffer for RunBatchConfiguration to read.
+char Setup::AwaitUserInput()
 {
     while (!Serial.available()) {}
-    while (Serial.available()){ Serial.read(); } // Clear buffer
+    char key = Serial.read();
+    if (key != BATCH_START)
+    {
+        while (Serial.available()){ Serial.read(); } // Clear buffer
+    }
+    return key;
 }
 
 void Setup::GetUserInput(char* rx_string, uint8_t maxStringLength)
@@ -137,231 +144,122 @@ void Setup::GetUserInput(char* rx_string, uint8_t maxStringLength)
     }
 }
 
-bool Setup::ValidateUserInputDateTime(char* rx_string)
+bool Setup::ScanDateTime(char* rx_string, time_t& dateTime)
 {
-    // Must be correct length.
-    for (uint8_t i = 0; i < 19; i++)
-    {
-        if (rx_string[i] == '\0')
-        {
-            PrintErrorInvalidInputLength();
-            return false;
-        }
-    }
-    if (rx_string[19] != '\0')
-    {
-        PrintErrorInvalidInputLength();
-        return false;
-    }
-
-    // Year digits must be three digits between 0 and 9.
-    for (uint8_t i = 0; i < 4; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Year"));
-            return false;
-        }
-    }
-    
-    // Year must be greater than 1970. This is due to some processing later that will fail otherwise.
-    // Further checking of the validity of the date itself will take place later.
-    uint16_t year = (
-        ((rx_string[0] - 48) * 1000) +
-        ((rx_string[1] - 48) * 100) +
-        ((rx_string[2] - 48) * 10) +
-        (rx_string[3] - 48));
-    if (year < 1970)
-    {
-        return false;
-    }
-
-                       
-    // Validate first hypen delimiter.
-    if (rx_string[4] != '-')
-    {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("First hyphen"));
-        return false;
-    }
-
-    // Month digits must be three digits between 0 and 9.
-    for (uint8_t i = 5; i < 7; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Month"));
-            return false;
-        }
-    }
-
-    // Validate second hypen delimiter.
-    if (rx_string[7] != '-')
-    {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("Second hyphen"));
-        return false;
-    }
-
-    // Day digits must be three digits between 0 and 9.
-    for (uint8_t i = 8; i < 10; i++)
+    int32_t fields[6];
+    if (!InputScanner::Scan(rx_string, dateTimeFormat, dateTimeLimits, fields))
     {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Day"));
-            return false;
-        }
-    }
-
-    // Validate 'T' delimiter.
-    if (rx_string[10] != 'T')
-    {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("'T' delimiter"));
+        PrintScanError(dateTimeLimits);
         return false;
     }
 
-    // Hour digits must be three digits between 0 and 9.
-    for (uint8_t i = 11; i < 13; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Hours"));
-            return false;
-        }
-    }
+    tmElements_t inputTimeInElements;
+    inputTimeInElements.Year = fields[0] - 1970; // Offset from 1970. Required by TimeLib.h to store in a byte.
+    inputTimeInElements.Month = fields[1];
+    inputTimeInElements.Day = fields[2];
+    inputTimeInElements.Hour = fields[3];
+    inputTimeInElements.Minute = fields[4];
+    inputTimeInElements.Second = fields[5];
+    dateTime = makeTimeFast(inputTimeInElements);
+    return true;
+}
 
-    // Validate first colon delimiter.
-    if (rx_string[13] != ':')
+// Returns the location in ten millionths of a degree.
+bool Setup::ScanLocation(char* rx_string, latOrLong latOrLong, int32_t& location)
+{
+    if (!InputScanner::Scan(rx_string, latOrLong == latitude ? latitudeFormat : longitudeFormat, NULL, &location))
     {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("First colon"));
+        PrintScanError(NULL);
         return false;
     }
+    return true;
+}
 
-    // Minutes digits must be three digits between 0 and 9.
-    for (uint8_t i = 14; i < 16; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Minutes"));
-            return false;
-        }
-    }
-
-    // Validate second colon delimiter.
-    if (rx_string[16] != ':')
+// Returns as absolute number of seconds.
+bool Setup::ScanWindowDuration(char* rx_string, uint16_t& durationInSeconds)
+{
+    int32_t minutes;
+    if (!InputScanner::Scan(rx_string, windowDurationFormat, NULL, &minutes))
     {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("Second colon"));
+        PrintScanError(NULL);
         return false;
     }
-
-    // Seconds digits must be three digits between 0 and 9.
-    for (uint8_t i = 17; i < 19; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Seconds"));
-            return false;
-        }
-    }
-
+    durationInSeconds = minutes * 60;
     return true;
 }
 
-time_t Setup::ParseDateTimeInputToTimeT(char* dateTimeString)
+void Setup::PrintScanError(const ScanFieldLimit* limits)
 {
-    uint8_t builtYear = (
-        ((dateTimeString[0] - 48) * 1000) +
-        ((dateTimeString[1] - 48) * 100) +
-        ((dateTimeString[2] - 48) * 10) +
-        (dateTimeString[3] - 48)) - 1970; // Offset from 1970. Required by TimeLib.h to store in a byte.
-
-    uint8_t builtMonth = (
-        ((dateTimeString[5] - 48) * 10) +
-        (dateTimeString[6] - 48));
-
-    uint8_t builtDay = (
-        ((dateTimeString[8] - 48) * 10) +
-        (dateTimeString[9] - 48));
-
-    uint8_t builtHour = (
-        ((dateTimeString[11] - 48) * 10) +
-        (dateTimeString[12] - 48));
-
-    uint8_t builtMinute = (
-        ((dateTimeString[14] - 48) * 10) +
-        (dateTimeString[15] - 48));
-
-    uint8_t builtSecond = (
-        ((dateTimeString[17] - 48) * 10) +
-        (dateTimeString[18] - 48));
-
-    tmElements_t inputTimeInElements;
-    inputTimeInElements.Year = builtYear;
-    inputTimeInElements.Month = builtMonth;
-    inputTimeInElements.Day = builtDay;
-    inputTimeInElements.Hour = builtHour;
-    inputTimeInElements.Minute = builtMinute;
-    inputTimeInElements.Second = builtSecond;
-
-    return makeTime(inputTimeInElements);
-}
-
-uint16_t Setup::ParseMinutesStringToSeconds(char* durationString)
-{
-    return ((durationString[0] - 48) * 600) + ((durationString[1] - 48) * 60);
-}
-
-int32_t Setup::ParseLatLongStringToInt32(char* locationString, latOrLong latOrLong)
-{
-    uint8_t decimalPosition = 0;
-    uint8_t stringLength = 0;
-    if (latOrLong == latitude)
-    {
-        decimalPosition = 3;
-        stringLength = 12;
-    }
-    else if(latOrLong == longitude)
-    {
-        decimalPosition = 4;
-        stringLength = 13;
-    }
-    else
+    char formatCharacter = InputScanner::GetErrorFormatCharacter();
+    switch (InputScanner::GetError())
     {
-        return 0;
-    }
-
-    // Remove '.'
-    for (uint8_t i = decimalPosition; i < stringLength - 1; i++) // Minus 1 so we don't try override the original '\0' with something from out of the array bounds.
-    {
-        locationString[i] = locationString[i + 1];
-    }
-
-    // Remove +/-
-    char absoluteValAsString[13];
-    strncpy(absoluteValAsString, locationString + 1, stringLength - 2); // Copy from just after the +/- through to (and including the '\0'. Minus 2 accounts for the missing +/- and the missing '.'.
-
-    // Convert to long.
-    int32_t absoluteVal = atol(absoluteValAsString);
-    if (locationString[0] == '-') // Return with +/- added back.
+    case(scanExpectedSign):
+        Serial.println(F("INVALID: First character must be '+' or '-'."));
+        break;
+    case(scanExpectedDigit):
+        PrintErrorInvalidCharacterFoundInField();
+        PrintFieldName(formatCharacter);
+        break;
+    case(scanExpectedCharacter):
+        PrintErrorRequiredCharacterOmmitted();
+        Serial.print(F(" '"));
+        Serial.print(formatCharacter);
+        Serial.println(F("'"));
+        break;
+    case(scanOutOfRange):
     {
-        return -absoluteVal;
+        const ScanFieldLimit* limit = &limits[InputScanner::GetErrorField()];
+        PrintErrorValueIsLogicallyInvalid();
+        Serial.print(pgm_read_word(&limit->Minimum));
+        Serial.print(F(" and "));
+        Serial.print(pgm_read_word(&limit->Maximum));
+        Serial.print(F(" (inclusive) for "));
+        PrintFieldName(formatCharacter);
+        break;
+    }
+    default:
+        PrintErrorInvalidInputLength();
+        break;
+    }
+    Serial.print(F("At character "));
+    Serial.println(InputScanner::GetErrorPosition() + 1);
+}
+
+void Setup::PrintFieldName(char formatCharacter)
+{
+    switch (formatCharacter)
+    {
+    case('y'):
+        Serial.println(F("Year"));
+        break;
+    case('n'):
+        Serial.println(F("Month"));
+        break;
+    case('d'):
+        Serial.println(F("Day"));
+        break;
+    case('h'):
+        Serial.println(F("Hours"));
+        break;
+    case('m'):
+        Serial.println(F("Minutes"));
+        break;
+    case('s'):
+        Serial.println(F("Seconds"));
+        break;
+    case('c'):
+        Serial.println(F("Degrees"));
+        break;
+    default:
+        Serial.println(F("Grace period value."));
+        break;
     }
-    return absoluteVal;
 }
 
 uint8_t Setup::PromptForNumberOfPoints()
 {
-    char* rx_string = new char[2];
-    Serial.println(F("How many 4D points do you wish to configure? (Between 1 and 5)."));
+    char* rx_string = inputBuffer;
+    Serial.println(F("How many 4D points do you wish to configure? (Between 1 and 9)."));
     bool validUserInput = false;
     do {
         Serial.print(F(": "));
@@ -369,16 +267,15 @@ uint8_t Setup::PromptForNumberOfPoints()
     } while (!ValidateUserInputNumberOfPoints(rx_string));
 
     uint8_t numPointInput = rx_string[0] - 48; // Convert to integer.
-    delete(rx_string);
     return numPointInput;
 }
 
 bool Setup::ValidateUserInputNumberOfPoints(char* rx_string)
 {
-    if (rx_string[0] < '1' || rx_string[0] > '5')
+    if (rx_string[0] < '1' || rx_string[0] > '0' + MAX_POINTS)
     {
         PrintErrorValueIsLogicallyInvalid();
-        Serial.println(F("1 and 5 (inclusive)."));
+        Serial.println(F("1 and 9 (inclusive)."));
         return false;
     }
     return true;
@@ -387,26 +284,22 @@ bool Setup::ValidateUserInputNumberOfPoints(char* rx_string)
 time_t Setup::PromptForGameStartDateTime()
 {
     //ISO 8601 format without the timezone offset
-    char* rx_string = new char[20];
+    char* rx_string = inputBuffer;
     Serial.println(F("Enter the UTC date/time value for when you wish the game to start."));
     Serial.println(F("At this date and time the first location hint will be revealed to the user."));
     PrintInfoTimeInputFormatting();
-    bool validUserInput = false;
+    time_t startDateTime;
     do {
         Serial.print(F(": "));
         GetUserInput(rx_string, 19);
-    } while (!ValidateUserInputDateTime(rx_string));
+    } while (!ScanDateTime(rx_string, startDateTime));
 
-    time_t startDateTime = ParseDateTimeInputToTimeT(rx_string);
-    delete(rx_string);
     return startDateTime;
 }
 
 bool Setup::ValidateGameStartDateTime(time_t startDateTime)
 {
-    DS1307RTC* clock = new DS1307RTC();
-    time_t currentTime = clock->get();
-    delete(clock);
+    time_t currentTime = RTC.get();
     if (startDateTime < currentTime)
     {
         Serial.println();
@@ -419,7 +312,7 @@ bool Setup::ValidateGameStartDateTime(time_t startDateTime)
 
 int32_t Setup::PromptForLatitude(bool final = false)
 {
-    char* rx_string = new char[12];
+    char* rx_string = inputBuffer;
     Serial.print(F("Enter the latitude value of the "));
     if (final)
     {
@@ -430,73 +323,15 @@ int32_t Setup::PromptForLatitude(bool final = false)
         Serial.println(F("next hint reveal location"));
     }
     PrintInfoLocationInputFormatting(false);
-    bool validUserInput = false;
+    int32_t latInt;
     do {
         Serial.print(F(": "));
         GetUserInput(rx_string, 11);
-    } while (!ValidateUserInputLatitude(rx_string));
+    } while (!ScanLocation(rx_string, latitude, latInt));
 
-    int32_t latInt = ParseLatLongStringToInt32(rx_string, latitude);
-    delete(rx_string);
     return latInt;
 }
 
-bool Setup::ValidateUserInputLatitude(char* rx_string)
-{
-    // Must be correct length.
-    for (uint8_t i = 0; i < 11; i++)
-    {
-        if (rx_string[i] == '\0') {
-            PrintErrorInvalidInputLength();
-            return false;
-        }
-    }
-    if (rx_string[11] != '\0')
-    {
-        PrintErrorInvalidInputLength();
-        return false;
-    }
-
-    // Must start with + or -.
-    if (rx_string[0] != '+' && rx_string[0] != '-')
-    {
-        Serial.println(F("INVALID: First character must be '+' or '-'."));
-        return false;
-    }
-
-    // Next must be a decimal point.
-    if (rx_string[3] != '.')
-    {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("Decimal point"));
-        return false;
-    }
-
-    // Next must be two digits between 0 and 9.
-    for (uint8_t i = 1; i < 3; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Before decimal point."));
-            return false;
-        }
-    }
-
-    // Next must be seven digits between 0 and 9.
-    for (uint8_t i = 4; i < 11; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("After decimal point."));
-            return false;
-        }
-    }
-
-    return true;
-}
-
 bool Setup::ValidateLatitude(int32_t latitude)
 {
     if (latitude > 900000000 || latitude < -900000000)
@@ -511,7 +346,7 @@ bool Setup::ValidateLatitude(int32_t latitude)
 
 int32_t Setup::PromptForLongitude(bool final = false)
 {
-    char* rx_string = new char[13];
+    char* rx_string = inputBuffer;
     Serial.print(F("Enter the longitude value of the "));
     if (final)
     {
@@ -522,74 +357,15 @@ int32_t Setup::PromptForLongitude(bool final = false)
         Serial.println(F("next hint reveal location"));
     }
     PrintInfoLocationInputFormatting(true);
-    bool validUserInput = false;
+    int32_t longInt;
     do {
         Serial.print(F(": "));
         GetUserInput(rx_string, 12);
-    } while (!ValidateUserInputLongitude(rx_string));
-
-    int32_t longInt = ParseLatLongStringToInt32(rx_string, longitude);
+    } while (!ScanLocation(rx_string, longitude, longInt));
 
-    delete(rx_string);
     return longInt;
 }
 
-bool Setup::ValidateUserInputLongitude(char* rx_string)
-{
-    // Must be correct length.
-    for (uint8_t i = 0; i < 12; i++)
-    {
-        if (rx_string[i] == '\0') {
-            PrintErrorInvalidInputLength();
-            return false;
-        }
-    }
-    if (rx_string[12] != '\0')
-    {
-        PrintErrorInvalidInputLength();
-        return false;
-    }
-
-    // Must start with + or -.
-    if (rx_string[0] != '+' && rx_string[0] != '-')
-    {
-        Serial.println(F("INVALID: First character must be '+' or '-'."));
-        return false;
-    }
-
-    // Next must be a decimal point.
-    if (rx_string[4] != '.')
-    {
-        PrintErrorRequiredCharacterOmmitted();
-        Serial.println(F("Decimal point"));
-        return false;
-    }
-
-    // Next must be three digits between 0 and 9.
-    for (uint8_t i = 1; i < 4; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Before decimal point."));
-            return false;
-        }
-    }
-
-    // Next must be seven digits between 0 and 9.
-    for (uint8_t i = 5; i < 11; i++)
-    {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
-        {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("After decimal point."));
-            return false;
-        }
-    }
-
-    return true;
-}
-
 bool Setup::ValidateLongitude(int32_t longitude)
 {
     if (longitude > 1800000000 || longitude < -1800000000)
@@ -605,7 +381,7 @@ bool Setup::ValidateLongitude(int32_t longitude)
 time_t Setup::PromptForNextPointDateTime(bool final = false)
 {
     //ISO 8601 format without the timezone offset
-    char* rx_string = new char[20];
+    char* rx_string = inputBuffer;
     Serial.print(F("Enter the UTC date/time value "));
     if (final)
     {
@@ -616,14 +392,12 @@ time_t Setup::PromptForNextPointDateTime(bool final = false)
         Serial.println(F("of the next hint reveal."));
     }
     PrintInfoTimeInputFormatting();
-    bool validUserInput = false;
+    time_t nextDateTime;
     do {
         Serial.print(F(": "));
         GetUserInput(rx_string, 19);
-    } while (!ValidateUserInputDateTime(rx_string));
+    } while (!ScanDateTime(rx_string, nextDateTime));
 
-    time_t nextDateTime = ParseDateTimeInputToTimeT(rx_string);
-    delete(rx_string);
     return nextDateTime;
 }
 
@@ -636,7 +410,7 @@ bool Setup::ValidateNextPointDateTime(time_t nextPointDateTime)
 uint16_t Setup::PromptForWindowDuration()
 {
     //ISO 8601 format without the timezone offset
-    char* rx_string = new char[3];
+    char* rx_string = inputBuffer;
     Serial.println(F("Enter the value (in minutes) for how long you wish the grace window to last."));
     Serial.println(F("This is the length of time after the next hint is revealed/unlock time is reached that the unit will be accessible."));
     Serial.println(F("It's purpose it to allow for a margin of error in arriving at the location late and still being able to continue."));
@@ -647,67 +421,234 @@ uint16_t Setup::PromptForWindowDuration()
     Serial.println(F("Examples:"));
     Serial.println(F("    01 <- 1 Minute."));
     Serial.println(F("    15 <- 15 Minutes."));
-    bool validUserInput = false;
+    uint16_t graceWindowDuration;
     do {
         Serial.print(F(": "));
         GetUserInput(rx_string, 2);
-    } while (!ValidateUserInputWindowDuration(rx_string));
+    } while (!ScanWindowDuration(rx_string, graceWindowDuration));
 
-    uint16_t graceWindowDuration = ParseMinutesStringToSeconds(rx_string);
-    delete(rx_string);
     return graceWindowDuration;
 }
 
-bool Setup::ValidateUserInputWindowDuration(char* rx_string)
+bool Setup::ValidateWindowDuration(uint16_t durationInSeconds)
 {
-    // Must be correct length.
-    for (uint8_t i = 0; i < 2; i++)
+    if (durationInSeconds > 3600 || durationInSeconds < 60)
     {
-        if (rx_string[i] == '\0')
-        {
-            PrintErrorInvalidInputLength();
-            return false;
-        }
+        PrintErrorValueIsLogicallyInvalid();
+        Serial.println(F("1 and 60 (inclusive)."));
+        Serial.println();
+        return false;
     }
-    if (rx_string[2] != '\0')
+    return true;
+}
+
+// Batch configuration lets a host provision the unit without the prompts. Instead of a key press at the splash screen, it sends the whole game as one line:
+//   $CFG,<points>,<game start>,<latitude>,<longitude>,<window open>,<window minutes>,...*<CRC>
+// Fields use the same formats as the prompts, with four per point in the order they are prompted for.
+// The CRC is CRC-16/CCITT-FALSE over everything between '$' and '*', as four hex digits.
+// The unit replies "$ACK,<config CRC>" once the configuration is stored. Otherwise it replies "$NAK,<field>" with the number of the first field that failed
+// (0 is "CFG"), "$NAK,CRC" or "$NAK,SIZE", and waits for another message. EEPROM is left untouched until a whole message has passed.
+void Setup::RunBatchConfiguration()
+{
+    while (true)
     {
-        PrintErrorInvalidInputLength();
-        return false;
+        uint8_t result = ReadBatchMessage();
+        if (result == BATCH_ACCEPTED)
+        {
+            currentPointIndex = 0;
+            timeExtended = false;
+            if (SaveConfigToEEPROM())
+            {
+                break;
+            }
+            result = BATCH_TOO_LARGE;
+        }
+
+        Serial.print(F("$NAK,"));
+        if (result == BATCH_BAD_CRC)
+        {
+            Serial.println(F("CRC"));
+        }
+        else if (result == BATCH_TOO_LARGE)
+        {
+            Serial.println(F("SIZE"));
+        }
+        else
+        {
+            Serial.println(result);
+        }
+        while (!Serial.available() || Serial.read() != BATCH_START) {}
     }
+    Journal::StartGame(configCrc);
+
+    Serial.print(F("$ACK,"));
+    Serial.println(configCrc, HEX);
+    Serial.println(F("Cycle unlock key (to locked state) to lock unit."));
+}
+
+// Reads the rest of a message after its '$', validating each field as it completes so the line never has to be held in RAM.
+// Returns BATCH_ACCEPTED, BATCH_BAD_CRC, or the number of the first field that failed.
+uint8_t Setup::ReadBatchMessage()
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t receivedCrc = 0;
+    uint8_t crcDigits = 0;
+    bool inCrc = false;
+    uint8_t field = 0;
+    uint8_t length = 0;
+    uint8_t failedField = BATCH_ACCEPTED;
 
-    // Digits must be three digits between 0 and 9.
-    for (uint8_t i = 0; i < 2; i++)
+    while (true)
     {
-        if (rx_string[i] < '0' || rx_string[i] > '9')
+        if (!Serial.available())
+        {
+            continue;
+        }
+        char rx_char = Serial.read();
+        if (rx_char == '\r' || rx_char == '\n')
+        {
+            break;
+        }
+
+        if (inCrc)
+        {
+            int8_t digit = HexDigitValue(rx_char);
+            if (digit < 0 || crcDigits > 3)
+            {
+                crcDigits = 5; // Never matches.
+            }
+            else
+            {
+                receivedCrc = (receivedCrc << 4) | digit;
+                crcDigits++;
+            }
+            continue;
+        }
+
+        if (rx_char == '*')
         {
-            PrintErrorInvalidCharacterFoundInField();
-            Serial.println(F("Grace period value."));
-            return false;
+            inCrc = true;
+        }
+        else
+        {
+            crc = Journal::Crc16((const uint8_t*)&rx_char, 1, crc);
+        }
+
+        if (rx_char == ',' || rx_char == '*')
+        {
+            inputBuffer[length] = '\0';
+            if (failedField == BATCH_ACCEPTED && !ApplyBatchField(field, inputBuffer))
+            {
+                failedField = field;
+            }
+            if (field < 3 + 4 * MAX_POINTS)
+            {
+                field++;
+            }
+            length = 0;
+        }
+        else if (length < SETUP_INPUT_BUFFER_LENGTH - 1)
+        {
+            inputBuffer[length++] = rx_char;
+        }
+        else if (failedField == BATCH_ACCEPTED)
+        {
+            PrintErrorInvalidInputLength();
+            failedField = field;
         }
     }
 
-    return true;
+    if (!inCrc || crcDigits != 4 || receivedCrc != crc)
+    {
+        return BATCH_BAD_CRC;
+    }
+    if (failedField != BATCH_ACCEPTED)
+    {
+        return failedField;
+    }
+    if (field != 3 + 4 * numberOfPoints)
+    {
+        return field; // The first missing field.
+    }
+    return BATCH_ACCEPTED;
 }
 
-bool Setup::ValidateWindowDuration(uint16_t durationInSeconds)
+bool Setup::ApplyBatchField(uint8_t field, char* value)
 {
-    if (durationInSeconds > 3600 || durationInSeconds < 60)
+    if (field == 0)
     {
-        PrintErrorValueIsLogicallyInvalid();
-        Serial.println(F("1 and 60 (inclusive)."));
-        Serial.println();
+        return strcmp(value, "CFG") == 0;
+    }
+    if (field == 1)
+    {
+        if (value[0] == '\0' || value[1] != '\0' || !ValidateUserInputNumberOfPoints(value)) { return false; }
+        numberOfPoints = value[0] - 48;
+        return true;
+    }
+    if (field == 2)
+    {
+        return ScanDateTime(value, gameStartDateTime) && ValidateGameStartDateTime(gameStartDateTime);
+    }
+
+    uint8_t point = (field - 3) / 4;
+    if (point >= numberOfPoints)
+    {
+        Serial.println(F("INVALID: More fields than the number of points needs."));
         return false;
     }
-    return true;
+    SinglePointConfiguration& configuration = singlePointConfigurationCollection[point];
+    switch ((field - 3) % 4)
+    {
+    case 0:
+    {
+        int32_t unlockLatitude;
+        if (!ScanLocation(value, latitude, unlockLatitude)) { return false; }
+        configuration.SetLocation(unlockLatitude, 0);
+        return ValidateLatitude(unlockLatitude);
+    }
+    case 1:
+    {
+        int32_t unlockLongitude;
+        if (!ScanLocation(value, longitude, unlockLongitude)) { return false; }
+        configuration.SetLocation(configuration.GetLocation().latitude, unlockLongitude);
+        return ValidateLongitude(unlockLongitude);
+    }
+    case 2:
+    {
+        time_t unlockDateTime;
+        if (!ScanDateTime(value, unlockDateTime)) { return false; }
+        configuration.SetWindowOpenDateTime(unlockDateTime);
+        return ValidateNextPointDateTime(unlockDateTime);
+    }
+    default:
+    {
+        uint16_t windowDurationInSeconds;
+        if (!ScanWindowDuration(value, windowDurationInSeconds)) { return false; }
+        configuration.SetWindowCloseDateTime(configuration.GetWindowOpenDateTime() + windowDurationInSeconds);
+        return ValidateWindowDuration(windowDurationInSeconds);
+    }
+    }
 }
 
-void Setup::Initialize()
+int8_t Setup::HexDigitValue(char hexDigit)
 {
-    ZeroConfigAndEEPROM();
+    if (hexDigit >= '0' && hexDigit <= '9') { return hexDigit - '0'; }
+    if (hexDigit >= 'A' && hexDigit <= 'F') { return hexDigit - 'A' + 10; }
+    if (hexDigit >= 'a' && hexDigit <= 'f') { return hexDigit - 'a' + 10; }
+    return -1;
+}
 
+// Returns false if the configuration entered could not be stored, in which case the unit must not be locked.
+bool Setup::Initialize()
+{
     ClearScreen();
     PrintSplashScreen();
-    AwaitUserInput();
+    if (AwaitUserInput() == BATCH_START)
+    {
+        RunBatchConfiguration();
+        return true;
+    }
+    ZeroConfig();
     ClearScreen();
 
     timeExtended = false;
@@ -755,14 +696,21 @@ void Setup::Initialize()
         time_t windowClose = unlockDateTime + windowDurationInSeconds;
         ClearScreen();
 
-        singlePointConfigurationCollection[i]->SetLocation(unlockLatitude, unlockLongitude);
-        singlePointConfigurationCollection[i]->SetWindowOpenDateTime(unlockDateTime);
-        singlePointConfigurationCollection[i]->SetWindowCloseDateTime(windowClose);
+        singlePointConfigurationCollection[i].SetLocation(unlockLatitude, unlockLongitude);
+        singlePointConfigurationCollection[i].SetWindowOpenDateTime(unlockDateTime);
+        singlePointConfigurationCollection[i].SetWindowCloseDateTime(windowClose);
     }
 
-    SaveConfigToEEPROM();
+    if (!SaveConfigToEEPROM())
+    {
+        Serial.println(F("ERROR: Configuration is too large to store. Use fewer points, or points closer together in place and time."));
+        Serial.println(F("Power cycle the unit to start setup again."));
+        return false;
+    }
+    Journal::StartGame(configCrc);
 
     Serial.println(F("Cycle unlock key (to locked state) to lock unit."));
+    return true;
 }
 
 time_t Setup::GetGameStartDateTime()
@@ -772,17 +720,17 @@ time_t Setup::GetGameStartDateTime()
 
 latLongLocation Setup::GetCurrentPointLocation()
 {
-    return singlePointConfigurationCollection[currentPointIndex]->GetLocation();
+    return singlePointConfigurationCollection[currentPointIndex].GetLocation();
 }
 
 time_t Setup::GetCurrentPointWindowOpenTime()
 {
-    return singlePointConfigurationCollection[currentPointIndex]->GetWindowOpenDateTime();
+    return singlePointConfigurationCollection[currentPointIndex].GetWindowOpenDateTime();
 }
 
 time_t Setup::GetCurrentPointWindowCloseTime()
 {
-    return singlePointConfigurationCollection[currentPointIndex]->GetWindowCloseDateTime();
+    return singlePointConfigurationCollection[currentPointIndex].GetWindowCloseDateTime();
 }
 
 uint8_t Setup::GetCurrentPointNumber()
@@ -799,7 +747,7 @@ void Setup::ProgressToNextPoint()
 {
     if (currentPointIndex < numberOfPoints - 1) {
         currentPointIndex++;
-        EEPROM.update(1, currentPointIndex);
+        Journal::RecordPointIndex(currentPointIndex);
     }
 }
 
@@ -811,20 +759,26 @@ bool Setup::IsFinalPoint()
 void Setup::ExtendTime(uint32_t duration, bool isGameStartReached, bool isBeforeWindowOpen)
 {
     if (timeExtended) { return; }
-    if (!isGameStartReached)
+    ApplyExtension(duration, currentPointIndex, !isGameStartReached, isBeforeWindowOpen);
+    Journal::RecordExtension(duration, currentPointIndex, !isGameStartReached, isBeforeWindowOpen);
+}
+
+// The stored configuration is never rewritten for an extension; the journal records it and it is applied again on every load.
+void Setup::ApplyExtension(uint32_t duration, uint8_t fromPoint, bool shiftGameStart, bool shiftWindowOpen)
+{
+    if (shiftGameStart)
     {
         gameStartDateTime += duration;
     }
-    for (uint8_t i = currentPointIndex; i < numberOfPoints; i++)
+    for (uint8_t i = fromPoint; i < numberOfPoints; i++)
     {
-        if (isBeforeWindowOpen)
+        if (shiftWindowOpen)
         {
-            singlePointConfigurationCollection[i]->SetWindowOpenDateTime(singlePointConfigurationCollection[i]->GetWindowOpenDateTime() + duration);
+            singlePointConfigurationCollection[i].SetWindowOpenDateTime(singlePointConfigurationCollection[i].GetWindowOpenDateTime() + duration);
         }
-        singlePointConfigurationCollection[i]->SetWindowCloseDateTime(singlePointConfigurationCollection[i]->GetWindowCloseDateTime() + duration);
+        singlePointConfigurationCollection[i].SetWindowCloseDateTime(singlePointConfigurationCollection[i].GetWindowCloseDateTime() + duration);
     }
     timeExtended = true;
-    SaveConfigToEEPROM();
 }
 
 bool Setup::IsTimeExtended()
@@ -834,150 +788,190 @@ bool Setup::IsTimeExtended()
 
 
 // EEPROM
-void Setup::LoadConfigFromEEPROM()
+// The configuration is stored as one record starting at CONFIG_EEPROM_ADDRESS:
+//   version, payload length, payload..., CRC-16 (low byte first) over everything before it.
+// The payload holds the point count, starting point index and time extended flag as single bytes (the journal tracks them during a game), then the game start as a varint.
+// Each point follows as varints: latitude and longitude as zigzag deltas from the previous point (the first from 0,0),
+// window open as a zigzag delta from the previous window close (the first from the game start), and the window length in seconds.
+// Points set for the same area on the same day usually take 8 to 12 bytes each instead of 16.
+bool Setup::LoadConfigFromEEPROM()
 {
-    numberOfPoints = EEPROM.read(0);
-    currentPointIndex = EEPROM.read(1);
-    timeExtended = EEPROM.read(2);
-    gameStartDateTime = ReadUnsignedInt32AsBytesFromEEPROM(3);
+    uint8_t record[CONFIG_EEPROM_BYTES];
+    EEPROM.get(CONFIG_EEPROM_ADDRESS, record);
 
-    uint8_t storageAddress = 7;
-    for (uint8_t i = 0; i < numberOfPoints; i++)
+    bool valid = DecodeConfig(record);
+    if (!valid)
     {
-        int32_t lat = ReadSignedInt32AsBytesFromEEPROM(storageAddress);
-        storageAddress += 4;
-        int32_t lng = ReadSignedInt32AsBytesFromEEPROM(storageAddress);
-        storageAddress += 4;
-        time_t dt = ReadUnsignedInt32AsBytesFromEEPROM(storageAddress);
-        storageAddress += 4;
-        time_t gp = ReadUnsignedInt32AsBytesFromEEPROM(storageAddress);
-        storageAddress += 4;
-
-        singlePointConfigurationCollection[i]->SetLocation(lat, lng);
-        singlePointConfigurationCollection[i]->SetWindowOpenDateTime(dt);
-        singlePointConfigurationCollection[i]->SetWindowCloseDateTime(gp);
+        numberOfPoints = 0;
+        currentPointIndex = 0;
+        timeExtended = false;
     }
+    else
+    {
+        // The point reached and any extension since the configuration was written come from the journal.
+        if (Journal::Recover(configCrc))
+        {
+            if (Journal::GetPointIndex() < numberOfPoints)
+            {
+                currentPointIndex = Journal::GetPointIndex();
+            }
+            if (Journal::IsTimeExtended() && !timeExtended)
+            {
+                ApplyExtension(Journal::GetExtensionSeconds(), Journal::GetExtendedFromPoint(), Journal::IsGameStartShifted(), Journal::IsWindowOpenShifted());
+            }
+        }
+    }
+    Trace::Record(traceEepromLoad);
+    return valid;
 }
 
-void Setup::SaveConfigToEEPROM()
+bool Setup::SaveConfigToEEPROM()
 {
-    EEPROM.update(0, numberOfPoints);
-    EEPROM.update(1, currentPointIndex);
-    EEPROM.update(2, timeExtended);
-    StoreUnsignedInt32AsBytesInEEPROM(gameStartDateTime, 3);
+    uint8_t record[CONFIG_EEPROM_BYTES];
+    uint8_t length = EncodeConfig(record);
+    if (length == 0) { return false; }
 
-    uint8_t storageAddress = 7;
-    for (uint8_t i = 0; i < numberOfPoints; i++)
+    // Nothing is written unless the new record fits, so a configuration that is too large leaves the stored one intact.
+    // A save cut short part way leaves a record whose CRC fails, which is reported at boot rather than run. What is left of
+    // a longer record past the new one is zeroed; update skips the cells already clear, so a save only wears what changed.
+    for (uint8_t i = 0; i < CONFIG_EEPROM_BYTES; i++)
     {
-        StoreSignedInt32AsBytesInEEPROM(singlePointConfigurationCollection[i]->GetLocation().latitude, storageAddress);
-        storageAddress += 4;
-        StoreSignedInt32AsBytesInEEPROM(singlePointConfigurationCollection[i]->GetLocation().longitude, storageAddress);
-        storageAddress += 4;
-        StoreUnsignedInt32AsBytesInEEPROM(singlePointConfigurationCollection[i]->GetWindowOpenDateTime(), storageAddress);
-        storageAddress += 4;
-        StoreUnsignedInt32AsBytesInEEPROM(singlePointConfigurationCollection[i]->GetWindowCloseDateTime(), storageAddress);
-        storageAddress += 4;
+        EEPROM.update(CONFIG_EEPROM_ADDRESS + i, (i < length) ? record[i] : 0);
     }
+    return true;
 }
 
-void Setup::StoreUnsignedInt32AsBytesInEEPROM(uint32_t data, uint8_t startIndex)
+// Returns the number of bytes used, or 0 if the configuration does not fit in CONFIG_EEPROM_BYTES.
+uint8_t Setup::EncodeConfig(uint8_t* record)
 {
-    union convertUnsignedInt32_t {
-        uint32_t uint32;
-        byte byteArray[4];
-    } unsignedInt32Union;
+    uint8_t position = 2;
+    record[position++] = numberOfPoints;
+    record[position++] = currentPointIndex;
+    record[position++] = timeExtended;
+    if (!WriteVarint(record, position, gameStartDateTime)) { return 0; }
+
+    uint32_t previousLatitude = 0;
+    uint32_t previousLongitude = 0;
+    uint32_t previousDateTime = gameStartDateTime;
+    for (uint8_t i = 0; i < numberOfPoints; i++)
+    {
+        latLongLocation location = singlePointConfigurationCollection[i].GetLocation();
+        uint32_t windowOpen = singlePointConfigurationCollection[i].GetWindowOpenDateTime();
+        uint32_t windowClose = singlePointConfigurationCollection[i].GetWindowCloseDateTime();
+
+        // Differences are taken modulo 2^32 so even a jump across the antimeridian round trips.
+        if (!WriteVarint(record, position, ZigZagEncode((int32_t)((uint32_t)location.latitude - previousLatitude)))) { return 0; }
+        if (!WriteVarint(record, position, ZigZagEncode((int32_t)((uint32_t)location.longitude - previousLongitude)))) { return 0; }
+        if (!WriteVarint(record, position, ZigZagEncode((int32_t)(windowOpen - previousDateTime)))) { return 0; }
+        if (!WriteVarint(record, position, windowClose - windowOpen)) { return 0; }
 
-    unsignedInt32Union.uint32 = data;
+        previousLatitude = location.latitude;
+        previousLongitude = location.longitude;
+        previousDateTime = windowClose;
+    }
 
-    EEPROM.update(startIndex, unsignedInt32Union.byteArray[0]);
-    startIndex++;
-    EEPROM.update(startIndex, unsignedInt32Union.byteArray[1]);
-    startIndex++;
-    EEPROM.update(startIndex, unsignedInt32Union.byteArray[2]);
-    startIndex++;
-    EEPROM.update(startIndex, unsignedInt32Union.byteArray[3]);
+    if (position + 2 > CONFIG_EEPROM_BYTES) { return 0; }
+    record[0] = CONFIG_FORMAT_VERSION;
+    record[1] = position - 2;
+    uint16_t crc = Journal::Crc16(record, position);
+    configCrc = crc;
+    record[position++] = crc & 0xFF;
+    record[position++] = crc >> 8;
+    return position;
 }
 
-void Setup::StoreSignedInt32AsBytesInEEPROM(int32_t data, uint8_t startIndex)
+bool Setup::DecodeConfig(const uint8_t* record)
 {
-    union convertSignedInt32_t {
-        int32_t int32;
-        byte byteArray[4];
-    } signedInt32Union;
+    if (record[0] != CONFIG_FORMAT_VERSION) { return false; }
+    uint8_t end = 2 + record[1];
+    if (end < 5 || end + 2 > CONFIG_EEPROM_BYTES) { return false; }
+    uint16_t crc = record[end] | ((uint16_t)record[end + 1] << 8);
+    if (crc != Journal::Crc16(record, end)) { return false; }
 
-    signedInt32Union.int32 = data;
+    uint8_t position = 2;
+    uint8_t pointCount = record[position++];
+    uint8_t pointIndex = record[position++];
+    bool extended = record[position++];
+    if (pointCount == 0 || pointCount > MAX_POINTS || pointIndex >= pointCount) { return false; }
 
-    EEPROM.update(startIndex, signedInt32Union.byteArray[0]);
-    startIndex++;
-    EEPROM.update(startIndex, signedInt32Union.byteArray[1]);
-    startIndex++;
-    EEPROM.update(startIndex, signedInt32Union.byteArray[2]);
-    startIndex++;
-    EEPROM.update(startIndex, signedInt32Union.byteArray[3]);
-}
+    uint32_t gameStart;
+    if (!ReadVarint(record, position, end, gameStart)) { return false; }
 
-uint32_t Setup::ReadUnsignedInt32AsBytesFromEEPROM(uint8_t startIndex)
-{
-    union convertUnsignedInt32_t {
-        uint32_t uint32;
-        byte byteArray[4];
-    } unsignedInt32Union;
+    uint32_t latitude = 0;
+    uint32_t longitude = 0;
+    uint32_t dateTime = gameStart;
+    for (uint8_t i = 0; i < pointCount; i++)
+    {
+        uint32_t latitudeDelta, longitudeDelta, openDelta, windowLength;
+        if (!ReadVarint(record, position, end, latitudeDelta)) { return false; }
+        if (!ReadVarint(record, position, end, longitudeDelta)) { return false; }
+        if (!ReadVarint(record, position, end, openDelta)) { return false; }
+        if (!ReadVarint(record, position, end, windowLength)) { return false; }
 
-    unsignedInt32Union.byteArray[0] = EEPROM.read(startIndex);
-    startIndex++;
-    unsignedInt32Union.byteArray[1] = EEPROM.read(startIndex);
-    startIndex++;
-    unsignedInt32Union.byteArray[2] = EEPROM.read(startIndex);
-    startIndex++;
-    unsignedInt32Union.byteArray[3] = EEPROM.read(startIndex);
+        latitude += ZigZagDecode(latitudeDelta);
+        longitude += ZigZagDecode(longitudeDelta);
+        uint32_t windowOpen = dateTime + ZigZagDecode(openDelta);
+        dateTime = windowOpen + windowLength;
 
-    return unsignedInt32Union.uint32;
+        singlePointConfigurationCollection[i].SetLocation(latitude, longitude);
+        singlePointConfigurationCollection[i].SetWindowOpenDateTime(windowOpen);
+        singlePointConfigurationCollection[i].SetWindowCloseDateTime(dateTime);
+    }
+    if (position != end) { return false; }
+
+    numberOfPoints = pointCount;
+    currentPointIndex = pointIndex;
+    timeExtended = extended;
+    gameStartDateTime = gameStart;
+    configCrc = crc;
+    return true;
 }
 
-int32_t Setup::ReadSignedInt32AsBytesFromEEPROM(uint8_t startIndex)
+bool Setup::WriteVarint(uint8_t* record, uint8_t& position, uint32_t value)
 {
-    union convertSignedInt32_t {
-        int32_t int32;
-        byte byteArray[4];
-    } signedInt32Union;
+    do {
+        if (position >= CONFIG_EEPROM_BYTES) { return false; }
+        uint8_t part = value & 0x7F;
+        value >>= 7;
+        record[position++] = value ? (part | 0x80) : part;
+    } while (value);
+    return true;
+}
 
-    signedInt32Union.byteArray[0] = EEPROM.read(startIndex);
-    startIndex++;
-    signedInt32Union.byteArray[1] = EEPROM.read(startIndex);
-    startIndex++;
-    signedInt32Union.byteArray[2] = EEPROM.read(startIndex);
-    startIndex++;
-    signedInt32Union.byteArray[3] = EEPROM.read(startIndex);
+bool Setup::ReadVarint(const uint8_t* record, uint8_t& position, uint8_t end, uint32_t& value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (position >= end) { return false; }
+        uint8_t part = record[position++];
+        value |= (uint32_t)(part & 0x7F) << shift;
+        if (!(part & 0x80)) { return true; }
+    }
+    return false;
+}
 
-    return signedInt32Union.int32;
+uint32_t Setup::ZigZagEncode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
 }
 
-void Setup::ZeroConfigAndEEPROM() {
+int32_t Setup::ZigZagDecode(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+void Setup::ZeroConfig() {
 
-    numberOfPoints = 5;
+    numberOfPoints = 0;
     currentPointIndex = 0;
     timeExtended = false;
     gameStartDateTime = 0;
 
-    singlePointConfigurationCollection[0]->SetLocation(0, 0);
-    singlePointConfigurationCollection[0]->SetWindowOpenDateTime(0);
-    singlePointConfigurationCollection[0]->SetWindowCloseDateTime(0);
-
-    singlePointConfigurationCollection[1]->SetLocation(0, 0);
-    singlePointConfigurationCollection[1]->SetWindowOpenDateTime(0);
-    singlePointConfigurationCollection[1]->SetWindowCloseDateTime(0);
-
-    singlePointConfigurationCollection[2]->SetLocation(0, 0);
-    singlePointConfigurationCollection[2]->SetWindowOpenDateTime(0);
-    singlePointConfigurationCollection[2]->SetWindowCloseDateTime(0);
-
-    singlePointConfigurationCollection[3]->SetLocation(0, 0);
-    singlePointConfigurationCollection[3]->SetWindowOpenDateTime(0);
-    singlePointConfigurationCollection[3]->SetWindowCloseDateTime(0);
-
-    singlePointConfigurationCollection[4]->SetLocation(0, 0);
-    singlePointConfigurationCollection[4]->SetWindowOpenDateTime(0);
-    singlePointConfigurationCollection[4]->SetWindowCloseDateTime(0);
-
-    SaveConfigToEEPROM();
+    for (uint8_t i = 0; i < MAX_POINTS; i++)
+    {
+        singlePointConfigurationCollection[i].SetLocation(0, 0);
+        singlePointConfigurationCollection[i].SetWindowOpenDateTime(0);
+        singlePointConfigurationCollection[i].SetWindowCloseDateTime(0);
+    }
 }
\ No newline at end of file
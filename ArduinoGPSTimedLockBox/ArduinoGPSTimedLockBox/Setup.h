@@ -12,6 +12,20 @@
 #include <EEPROM.h>
 #include "CommonDataTypes.h"
 #include "SinglePointConfiguration.h"
+#include "Trace.h"
+#include "Journal.h"
+#include "InputScanner.h"
+
+#define MAX_POINTS 9
+#define CONFIG_EEPROM_ADDRESS 0
+#define CONFIG_EEPROM_BYTES 128
+#define CONFIG_FORMAT_VERSION 1
+#define SETUP_INPUT_BUFFER_LENGTH 20 // Longest entry (an ISO 8601 date/time) plus its NUL.
+#define SETUP_RAM_BUDGET 192 // Bytes on AVR.
+#define BATCH_START '$'
+#define BATCH_ACCEPTED 0xFF
+#define BATCH_BAD_CRC 0xFE
+#define BATCH_TOO_LARGE 0xFD
 
 class Setup
 {
@@ -19,8 +33,16 @@ private:
 	static uint8_t numberOfPoints;
 	static uint8_t currentPointIndex;
 	static time_t gameStartDateTime;
-	static SinglePointConfiguration* singlePointConfigurationCollection[];
+	static SinglePointConfiguration singlePointConfigurationCollection[MAX_POINTS];
 	static bool timeExtended;
+	static uint16_t configCrc;
+	static char inputBuffer[SETUP_INPUT_BUFFER_LENGTH];
+
+	// Setup never uses the heap, so this is all the RAM it takes beyond the stack. The build fails if it grows past the budget.
+#if defined(__AVR__)
+	static_assert(sizeof(numberOfPoints) + sizeof(currentPointIndex) + sizeof(gameStartDateTime) + sizeof(singlePointConfigurationCollection)
+		+ sizeof(timeExtended) + sizeof(configCrc) + sizeof(inputBuffer) <= SETUP_RAM_BUDGET, "Setup's static RAM is over SETUP_RAM_BUDGET.");
+#endif
 
 	static void ClearScreen();
 	static void PrintSplashScreen();
@@ -31,39 +53,45 @@ private:
 	static void PrintInfoTimeInputFormatting();
 	static void PrintInfoLocationInputFormatting(bool isLongitude);
 
-	static void AwaitUserInput();
+	static char AwaitUserInput();
 	static void GetUserInput(char* rx_string, uint8_t maxStringLength);
-	static bool ValidateUserInputDateTime(char* rx_string);
-	static time_t ParseDateTimeInputToTimeT(char* dateTimeString);
-	static uint16_t ParseMinutesStringToSeconds(char* durationString);
-	static int32_t ParseLatLongStringToInt32(char* locationString, latOrLong latOrLong);
+	static bool ScanDateTime(char* rx_string, time_t& dateTime);
+	static bool ScanLocation(char* rx_string, latOrLong latOrLong, int32_t& location);
+	static bool ScanWindowDuration(char* rx_string, uint16_t& durationInSeconds);
+	static void PrintScanError(const ScanFieldLimit* limits);
+	static void PrintFieldName(char formatCharacter);
 
 	static uint8_t PromptForNumberOfPoints();
 	static bool ValidateUserInputNumberOfPoints(char* rx_string);
 	static time_t PromptForGameStartDateTime();
 	static bool ValidateGameStartDateTime(time_t startDateTime);
 	static int32_t PromptForLatitude(bool final);
-	static bool ValidateUserInputLatitude(char* rx_string);
 	static bool ValidateLatitude(int32_t latitude);
 	static int32_t PromptForLongitude(bool final);
-	static bool ValidateUserInputLongitude(char* rx_string);
 	static bool ValidateLongitude(int32_t longitude);
 	static time_t PromptForNextPointDateTime(bool final);
 	static bool ValidateNextPointDateTime(time_t nextPointDateTime);
 	static uint16_t PromptForWindowDuration();
-	static bool ValidateUserInputWindowDuration(char* rx_string);
 	static bool ValidateWindowDuration(uint16_t durationInSeconds);
 
-	static void StoreUnsignedInt32AsBytesInEEPROM(uint32_t data, uint8_t startIndex);
-	static void StoreSignedInt32AsBytesInEEPROM(int32_t data, uint8_t startIndex);
-	static uint32_t ReadUnsignedInt32AsBytesFromEEPROM(uint8_t startIndex);
-	static int32_t ReadSignedInt32AsBytesFromEEPROM(uint8_t startIndex);
-	static void ZeroConfigAndEEPROM();
+	static void RunBatchConfiguration();
+	static uint8_t ReadBatchMessage();
+	static bool ApplyBatchField(uint8_t field, char* value);
+	static int8_t HexDigitValue(char hexDigit);
+
+	static uint8_t EncodeConfig(uint8_t* record);
+	static bool DecodeConfig(const uint8_t* record);
+	static bool WriteVarint(uint8_t* record, uint8_t& position, uint32_t value);
+	static bool ReadVarint(const uint8_t* record, uint8_t& position, uint8_t end, uint32_t& value);
+	static uint32_t ZigZagEncode(int32_t value);
+	static int32_t ZigZagDecode(uint32_t value);
+	static void ZeroConfig();
+	static void ApplyExtension(uint32_t duration, uint8_t fromPoint, bool shiftGameStart, bool shiftWindowOpen);
 
 public:
 	Setup();
 	// ~Setup(); // Removed as is now empty due to class being static. Add back if we make class non-static.
-	static void Initialize();
+	static bool Initialize();
 	static time_t GetGameStartDateTime();
 	static latLongLocation GetCurrentPointLocation();
 	static time_t GetCurrentPointWindowOpenTime();
@@ -76,8 +104,8 @@ public:
 	static void ExtendTime(uint32_t duration, bool isGameStartReached, bool isBeforeWindowOpen);
 	static bool IsTimeExtended();
 
-	static void LoadConfigFromEEPROM();
-	static void SaveConfigToEEPROM();
+	static bool LoadConfigFromEEPROM();
+	static bool SaveConfigToEEPROM();
 };
 
 #endif
@@ -1,13 +1,174 @@
+// Physical.h comes first, as NeoGPS declares names that the Time library defines as macros.
+#include "Physical.h"
 #include "Temporal.h"
 #include <Time.h>
 #include <math.h>
 
-DS1307RTC* Temporal::rtc = new DS1307RTC();
+DS1307RTC* Temporal::rtc = &RTC;
+time_t Temporal::snapshotTime = 0;
+uint32_t Temporal::snapshotMillis = 0;
+bool Temporal::snapshotValid = false;
+ClockModel Temporal::model;
+bool Temporal::modelLoaded = false;
+time_t Temporal::anchorTime = 0;
+int32_t Temporal::anchorRtcOffset = 0;
+uint16_t Temporal::anchorUncertaintyMs = CLOCK_GPS_ANCHOR_UNCERTAINTY_MS;
+uint32_t Temporal::lastAnchorCheckMillis = 0;
+bool Temporal::anchorChecked = false;
 
 Temporal::Temporal()
 {
 }
 
+time_t Temporal::ReadRtc()
+{
+	time_t now = ApplyModel(rtc->get());
+	Trace::Record(traceRtcRead);
+	return now;
+}
+
+// Until the next GPS check, the RTC is measured from the reference.
+void Temporal::LoadModel()
+{
+	EEPROM.get(CLOCK_MODEL_EEPROM_ADDRESS, model);
+	if (model.Crc != Journal::Crc16((const uint8_t*)&model, offsetof(ClockModel, Crc)))
+	{
+		ClockModel unknown;
+		model = unknown;
+	}
+	anchorTime = model.ReferenceTime;
+	anchorRtcOffset = model.ReferenceRtcOffset;
+	anchorUncertaintyMs = model.ReferenceUncertaintyMs;
+	modelLoaded = true;
+}
+
+void Temporal::SaveModel()
+{
+	model.Crc = Journal::Crc16((const uint8_t*)&model, offsetof(ClockModel, Crc));
+	EEPROM.put(CLOCK_MODEL_EEPROM_ADDRESS, model);
+}
+
+// Takes the RTC's offset at the anchor and the drift since then out of a raw reading. A failed read, which DS1307RTC gives as 0, stays 0.
+time_t Temporal::ApplyModel(time_t rtcTime)
+{
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+	if (anchorTime == 0 || rtcTime == 0)
+	{
+		return rtcTime;
+	}
+	time_t rtcAtAnchor = anchorTime + anchorRtcOffset;
+	float driftSeconds = (float)(int32_t)(rtcTime - rtcAtAnchor) * model.DriftCentiPpm / 100000000.0;
+	return rtcTime - anchorRtcOffset - lround(driftSeconds);
+}
+
+// How far the modelled time could be from UTC at utcTime: the anchor's own error plus the drift uncertainty since.
+uint32_t Temporal::GetUncertaintyMs(time_t utcTime)
+{
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+	float sinceAnchor = abs((int32_t)(utcTime - anchorTime));
+	return anchorUncertaintyMs + (uint32_t)(sinceAnchor * model.DriftUncertaintyCentiPpm / 100000.0);
+}
+
+// Whole seconds either side of Now() that UTC could be. Zero if the RTC has never been checked against GPS, in which case it is taken at its word.
+uint32_t Temporal::GetUncertaintySeconds()
+{
+	time_t now = Now();
+	if (anchorTime == 0)
+	{
+		return 0;
+	}
+	return (GetUncertaintyMs(now) + 999) / 1000;
+}
+
+int16_t Temporal::GetDriftCentiPpm()
+{
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+	return model.DriftCentiPpm;
+}
+
+void Temporal::Anchor(time_t utcTime, time_t rtcTime, uint16_t uncertaintyMs)
+{
+	anchorTime = utcTime;
+	anchorRtcOffset = rtcTime - utcTime;
+	anchorUncertaintyMs = uncertaintyMs;
+}
+
+// Checks the model against the time of a GPS fix, at most once every CLOCK_REANCHOR_INTERVAL_MS.
+// The fix becomes the new anchor if that narrows the uncertainty. Once the reference is CLOCK_DRIFT_BASELINE old, the offset the RTC
+// has built up since gives another measure of its drift, which is combined with the one already held and saved along with the fix as the new reference.
+void Temporal::AnchorToGps(time_t gpsTime)
+{
+	if (anchorChecked && millis() - lastAnchorCheckMillis < CLOCK_REANCHOR_INTERVAL_MS)
+	{
+		return;
+	}
+	anchorChecked = true;
+	lastAnchorCheckMillis = millis();
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+
+	time_t rtcTime = rtc->get();
+	if (rtcTime == 0)
+	{
+		return; // The read failed. Measuring against it would save a reference decades out and a drift at its limit.
+	}
+	int32_t sinceReference = gpsTime - model.ReferenceTime;
+	if (model.ReferenceTime == 0 || sinceReference >= CLOCK_DRIFT_BASELINE)
+	{
+		if (model.ReferenceTime != 0)
+		{
+			// Weigh the two by the inverse square of their uncertainties.
+			float gained = (int32_t)(rtcTime - gpsTime) - model.ReferenceRtcOffset;
+			float measured = gained * 100000000.0 / sinceReference;
+			float measuredUncertainty = (float)(model.ReferenceUncertaintyMs + CLOCK_GPS_ANCHOR_UNCERTAINTY_MS) * 100000.0 / sinceReference;
+			float heldWeight = 1.0 / ((float)model.DriftUncertaintyCentiPpm * model.DriftUncertaintyCentiPpm);
+			float measuredWeight = 1.0 / (measuredUncertainty * measuredUncertainty);
+			float drift = (model.DriftCentiPpm * heldWeight + measured * measuredWeight) / (heldWeight + measuredWeight);
+			float uncertainty = 1.0 / sqrt(heldWeight + measuredWeight);
+			model.DriftCentiPpm = constrain(lround(drift), -32767, 32767);
+			model.DriftUncertaintyCentiPpm = constrain(lround(uncertainty), CLOCK_DRIFT_FLOOR_CENTIPPM, CLOCK_UNCALIBRATED_DRIFT_CENTIPPM);
+		}
+		model.ReferenceTime = gpsTime;
+		model.ReferenceRtcOffset = rtcTime - gpsTime;
+		model.ReferenceUncertaintyMs = CLOCK_GPS_ANCHOR_UNCERTAINTY_MS;
+		SaveModel();
+	}
+
+	if (anchorTime == 0 || GetUncertaintyMs(gpsTime) > CLOCK_GPS_ANCHOR_UNCERTAINTY_MS)
+	{
+		Anchor(gpsTime, rtcTime, CLOCK_GPS_ANCHOR_UNCERTAINTY_MS);
+		Resync();
+	}
+}
+
+void Temporal::Resync()
+{
+	snapshotTime = ReadRtc();
+	snapshotMillis = millis();
+	snapshotValid = true;
+}
+
+// Current time from the cached snapshot. Only touches the I2C bus once the snapshot is RTC_RESYNC_MS old.
+time_t Temporal::Now()
+{
+	if (!snapshotValid || (millis() - snapshotMillis >= RTC_RESYNC_MS))
+	{
+		Resync();
+	}
+	return snapshotTime + ((millis() - snapshotMillis) / 1000);
+}
+
 TimeSpanDuration Temporal::ConvertToTimeSpanDuration(uint32_t duration)
 {
 	TimeSpanDuration windowOpenDateTime;
@@ -18,17 +179,171 @@ TimeSpanDuration Temporal::ConvertToTimeSpanDuration(uint32_t duration)
 	return windowOpenDateTime;
 }
 
+// newTime is taken to be UTC to within CLOCK_GPS_ANCHOR_UNCERTAINTY_MS. The RTC then starts again from zero offset, so it is also the new reference.
 bool Temporal::SetCurrentTime(time_t currentTime)
 {
 	rtc->set(currentTime);
-	return (rtc->get() == currentTime);
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+	model.ReferenceTime = currentTime;
+	model.ReferenceRtcOffset = 0;
+	model.ReferenceUncertaintyMs = CLOCK_GPS_ANCHOR_UNCERTAINTY_MS;
+	SaveModel();
+	Anchor(currentTime, currentTime, CLOCK_GPS_ANCHOR_UNCERTAINTY_MS);
+	Resync();
+	return (snapshotTime == currentTime);
+}
+
+// Sets the RTC from GPS on a PPS edge, then finds how fast it runs so that the model can take the drift out.
+// If the reference is old and precise enough, the drift comes from the offset the RTC has built up since.
+// Otherwise it is the slope of CALIBRATION_SAMPLES offsets taken CALIBRATION_SAMPLE_SECONDS apart, which takes about ten minutes.
+// offsetSeconds is how far ahead of UTC the RTC was beforehand. Returns false if the GPS has no PPS or no fix, leaving the RTC as it was;
+// Physical::HasFixTimedOut tells the two apart. Also returns false if the RTC can't be read or isn't ticking, as a new DS1307 isn't.
+bool Temporal::CalibrateFromGps(int32_t& offsetSeconds)
+{
+	time_t utcSecond;
+	uint8_t edgeCount;
+	if (!Physical::GetUtcSecondStart(utcSecond, edgeCount))
+	{
+		return false;
+	}
+	int32_t offsetMicros;
+	if (!MeasureRtcOffset(utcSecond, edgeCount, offsetSeconds, offsetMicros))
+	{
+		return false;
+	}
+
+	if (!modelLoaded)
+	{
+		LoadModel();
+	}
+	bool driftKnown = false;
+	float drift = 0;
+	float driftUncertainty = CALIBRATION_SAMPLED_DRIFT_CENTIPPM;
+	int32_t sinceReference = utcSecond - model.ReferenceTime;
+	if (model.ReferenceTime != 0 && sinceReference > 0 && abs(offsetSeconds) < CALIBRATION_MAX_OFFSET_SECONDS)
+	{
+		float measuredUncertainty = (float)(model.ReferenceUncertaintyMs + CLOCK_PPS_ANCHOR_UNCERTAINTY_MS) * 100000.0 / sinceReference;
+		if (measuredUncertainty < CALIBRATION_SAMPLED_DRIFT_CENTIPPM)
+		{
+			drift = ((float)offsetMicros - model.ReferenceRtcOffset * 1000000.0) * 100 / sinceReference;
+			driftUncertainty = measuredUncertainty;
+			driftKnown = true;
+		}
+	}
+
+	// Writing the seconds restarts the DS1307's countdown to its next tick, so setting it just after a PPS edge keeps its ticks in step with UTC.
+	if (!AwaitPpsEdges(utcSecond, edgeCount, 1))
+	{
+		return false;
+	}
+	SetCurrentTime(utcSecond);
+	model.ReferenceUncertaintyMs = CLOCK_PPS_ANCHOR_UNCERTAINTY_MS;
+	anchorUncertaintyMs = CLOCK_PPS_ANCHOR_UNCERTAINTY_MS;
+	SaveModel();
+
+	if (!driftKnown)
+	{
+		// Least squares slope of offset against time. Offsets are in microseconds, so the slope is in parts per million.
+		float sumTime = 0, sumOffset = 0, sumTimeSquared = 0, sumTimeOffset = 0;
+		time_t firstSecond = utcSecond;
+		for (uint8_t i = 0; i < CALIBRATION_SAMPLES; i++)
+		{
+			if (!AwaitPpsEdges(utcSecond, edgeCount, CALIBRATION_SAMPLE_SECONDS))
+			{
+				return false; // The RTC is set, and the drift from before still applies.
+			}
+			int32_t sampleSeconds, sampleMicros;
+			if (!MeasureRtcOffset(utcSecond, edgeCount, sampleSeconds, sampleMicros))
+			{
+				return false;
+			}
+			float time = utcSecond - firstSecond;
+			float offset = sampleMicros;
+			sumTime += time;
+			sumOffset += offset;
+			sumTimeSquared += time * time;
+			sumTimeOffset += time * offset;
+		}
+		drift = 100 * (CALIBRATION_SAMPLES * sumTimeOffset - sumTime * sumOffset) / (CALIBRATION_SAMPLES * sumTimeSquared - sumTime * sumTime);
+	}
+
+	model.DriftCentiPpm = constrain(lround(drift), -32767, 32767);
+	model.DriftUncertaintyCentiPpm = constrain(lround(driftUncertainty), CLOCK_DRIFT_FLOOR_CENTIPPM, CLOCK_UNCALIBRATED_DRIFT_CENTIPPM);
+	SaveModel();
+	Resync();
+	return true;
+}
+
+// Waits for the given number of PPS edges past edgeCount, moving utcSecond and edgeCount on to the last of them.
+bool Temporal::AwaitPpsEdges(time_t& utcSecond, uint8_t& edgeCount, uint8_t edges)
+{
+	uint32_t start = millis();
+	uint32_t edgeMicros;
+	uint8_t count;
+	do {
+		if (millis() - start > (edges + 1) * 1000UL)
+		{
+			return false;
+		}
+		Physical::GetLastPps(edgeMicros, count);
+	} while ((uint8_t)(count - edgeCount) < edges);
+	utcSecond += (uint8_t)(count - edgeCount);
+	edgeCount = count;
+	return true;
+}
+
+// How far ahead of UTC the raw RTC is, in microseconds, found by timing its next tick against the PPS edge before it.
+// utcSecond is the second that began at edge edgeCount, which must be under 255 edges ago. offsetMicros saturates past CALIBRATION_MAX_OFFSET_SECONDS.
+// Returns false if a read fails, which DS1307RTC gives as 0, or if the RTC doesn't tick within RTC_TICK_TIMEOUT_MS because it is halted.
+bool Temporal::MeasureRtcOffset(time_t utcSecond, uint8_t edgeCount, int32_t& offsetSeconds, int32_t& offsetMicros)
+{
+	time_t before = rtc->get();
+	if (before == 0)
+	{
+		return false;
+	}
+	uint32_t start = millis();
+	time_t tickSecond;
+	while ((tickSecond = rtc->get()) == before)
+	{
+		if (millis() - start > RTC_TICK_TIMEOUT_MS)
+		{
+			return false;
+		}
+	}
+	uint32_t tickMicros = micros();
+	if (tickSecond == 0)
+	{
+		return false;
+	}
+
+	uint32_t edgeMicros;
+	uint8_t tickEdgeCount;
+	Physical::GetLastPps(edgeMicros, tickEdgeCount);
+	int32_t sinceEdge = tickMicros - edgeMicros;
+	if (sinceEdge < 0)
+	{
+		// An edge came between the tick and reading it, so the tick belongs to the one before.
+		sinceEdge += 1000000;
+		tickEdgeCount--;
+	}
+
+	int32_t wholeSeconds = tickSecond - (utcSecond + (uint8_t)(tickEdgeCount - edgeCount));
+	offsetSeconds = wholeSeconds - (sinceEdge >= 500000 ? 1 : 0);
+	wholeSeconds = constrain(wholeSeconds, -CALIBRATION_MAX_OFFSET_SECONDS, CALIBRATION_MAX_OFFSET_SECONDS);
+	offsetMicros = wholeSeconds * 1000000 - sinceEdge;
+	return true;
 }
 
 TimeSpanDuration Temporal::GetTimeUntilGameStart()
 {
-	if (systemConfig.GetGameStartDateTime() > rtc->get())
+	time_t now = Now();
+	if (systemConfig.GetGameStartDateTime() > now)
 	{
-		return ConvertToTimeSpanDuration(systemConfig.GetGameStartDateTime() - rtc->get());
+		return ConvertToTimeSpanDuration(systemConfig.GetGameStartDateTime() - now);
 	}
 	TimeSpanDuration empty;
 	return empty;
@@ -36,9 +351,10 @@ TimeSpanDuration Temporal::GetTimeUntilGameStart()
 
 TimeSpanDuration Temporal::GetTimeUntilWindowOpens()
 {
-	if (systemConfig.GetCurrentPointWindowOpenTime() > rtc->get())
+	time_t now = Now();
+	if (systemConfig.GetCurrentPointWindowOpenTime() > now)
 	{
-		return ConvertToTimeSpanDuration(systemConfig.GetCurrentPointWindowOpenTime() - rtc->get());
+		return ConvertToTimeSpanDuration(systemConfig.GetCurrentPointWindowOpenTime() - now);
 	}
 	TimeSpanDuration empty;
 	return empty;
@@ -46,30 +362,35 @@ TimeSpanDuration Temporal::GetTimeUntilWindowOpens()
 
 TimeSpanDuration Temporal::GetTimeUntilWindowClose()
 {
-	if (systemConfig.GetCurrentPointWindowCloseTime() > rtc->get())
+	time_t now = Now();
+	if (systemConfig.GetCurrentPointWindowCloseTime() > now)
 	{
-		return ConvertToTimeSpanDuration(systemConfig.GetCurrentPointWindowCloseTime() - rtc->get());
+		return ConvertToTimeSpanDuration(systemConfig.GetCurrentPointWindowCloseTime() - now);
 	}
 	TimeSpanDuration empty;
 	return empty;
 }
 
+// Always a fresh read, as this is used to measure the RTC itself.
 time_t Temporal::GetDateTimeInUtc()
 {
-	return rtc->get();
+	Resync();
+	return snapshotTime;
 }
 
+// While the time is uncertain, the players get the benefit of the doubt: the game starts and windows open as soon as they might have,
+// and windows only expire once they certainly have.
 bool Temporal::IsGameStartReached()
 {
-	return(rtc->get() >= systemConfig.GetGameStartDateTime());
+	return(Now() + GetUncertaintySeconds() >= systemConfig.GetGameStartDateTime());
 }
 
 bool Temporal::HasWindowOpened()
 {
-	return(rtc->get() >= systemConfig.GetCurrentPointWindowOpenTime());
+	return(Now() + GetUncertaintySeconds() >= systemConfig.GetCurrentPointWindowOpenTime());
 }
 
 bool Temporal::HasWindowExpired()
 {
-	return(rtc->get() >= systemConfig.GetCurrentPointWindowCloseTime());
+	return(Now() - GetUncertaintySeconds() >= systemConfig.GetCurrentPointWindowCloseTime());
 }
\ No newline at end of file
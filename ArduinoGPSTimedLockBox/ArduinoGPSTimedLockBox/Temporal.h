@@ -8,8 +8,29 @@
 #endif
 
 #include "Setup.h"
+#include "Trace.h"
+#include "Journal.h"
 #include <DS1307RTC.h>
 #include <Time.h>
+#include <EEPROM.h>
+
+// The DS1307 is only read when the cached time is older than this. In between, time is advanced from millis().
+#define RTC_RESYNC_MS 60000
+
+// The clock model takes the EEPROM left at the end of the journal.
+#define CLOCK_MODEL_EEPROM_ADDRESS (JOURNAL_EEPROM_ADDRESS + JOURNAL_EEPROM_BYTES)
+#define CLOCK_GPS_ANCHOR_UNCERTAINTY_MS 2000 // A fix's time and the RTC's are each whole seconds, and the fix arrives some way into the next.
+#define CLOCK_PPS_ANCHOR_UNCERTAINTY_MS 5 // The RTC set just after a PPS edge, as CalibrateFromGps does.
+#define CLOCK_UNCALIBRATED_DRIFT_CENTIPPM 10000 // A DS1307 crystal is within 20 ppm at room temperature, but loses up to 100 ppm more when hot or cold.
+#define CLOCK_DRIFT_FLOOR_CENTIPPM 300 // Temperature moves even a measured drift by a few ppm.
+#define CLOCK_REANCHOR_INTERVAL_MS 600000 // How often a GPS fix is checked against the model. Each check reads the RTC.
+#define CLOCK_DRIFT_BASELINE 86400 // Seconds between anchors before their difference is used to refine the drift.
+
+#define CALIBRATION_SAMPLES 20
+#define CALIBRATION_SAMPLE_SECONDS 30
+#define CALIBRATION_SAMPLED_DRIFT_CENTIPPM 500 // The sampled drift is good to about 2 ppm, plus the temperature allowance.
+#define CALIBRATION_MAX_OFFSET_SECONDS 2000 // Offsets beyond this are not worth measuring to the microsecond.
+#define RTC_TICK_TIMEOUT_MS 1100 // A running DS1307 ticks within a second.
 
 // This is similar to the structure found in the Time.h library.
 // However, that library is based around absolute times from linux epoch rather than times as a length of a duration.
@@ -25,19 +46,57 @@ struct TimeSpanDuration
 	uint8_t Seconds = 0;
 };
 
+// What is known about the RTC: its offset from UTC when it was last checked against GPS (the anchor), and how fast it drifts since.
+// The RTC itself is never trimmed; the model is applied to each reading instead. Uncertainties are bounds, not standard deviations.
+// The anchor is kept in RAM and moves with every useful fix. The reference is the anchor the drift is next measured from, and is what gets saved,
+// so the EEPROM is written about once a CLOCK_DRIFT_BASELINE. After a restart the reference is the anchor until the next fix.
+struct ClockModel
+{
+	time_t ReferenceTime = 0; // UTC at the reference. Zero if the RTC has never been checked against GPS.
+	int32_t ReferenceRtcOffset = 0; // Seconds the raw RTC was ahead of UTC at the reference.
+	uint16_t ReferenceUncertaintyMs = CLOCK_GPS_ANCHOR_UNCERTAINTY_MS;
+	int16_t DriftCentiPpm = 0; // How fast the RTC runs, in hundredths of a part per million. Positive is fast.
+	uint16_t DriftUncertaintyCentiPpm = CLOCK_UNCALIBRATED_DRIFT_CENTIPPM;
+	uint16_t Crc = 0;
+};
+
 class Temporal
 {
 private:
 	static Setup systemConfig;
 	static TimeSpanDuration ConvertToTimeSpanDuration(uint32_t duration);
 	static DS1307RTC* rtc;
+	static time_t ReadRtc();
+	static time_t snapshotTime;
+	static uint32_t snapshotMillis;
+	static bool snapshotValid;
+	static time_t Now();
+	static ClockModel model;
+	static bool modelLoaded;
+	static time_t anchorTime;
+	static int32_t anchorRtcOffset;
+	static uint16_t anchorUncertaintyMs;
+	static uint32_t lastAnchorCheckMillis;
+	static bool anchorChecked;
+	static void LoadModel();
+	static void SaveModel();
+	static void Anchor(time_t utcTime, time_t rtcTime, uint16_t uncertaintyMs);
+	static time_t ApplyModel(time_t rtcTime);
+	static uint32_t GetUncertaintyMs(time_t utcTime);
+	static bool AwaitPpsEdges(time_t& utcSecond, uint8_t& edgeCount, uint8_t edges);
+	static bool MeasureRtcOffset(time_t utcSecond, uint8_t edgeCount, int32_t& offsetSeconds, int32_t& offsetMicros);
 public:
 	Temporal();
 	static bool SetCurrentTime(time_t newTime);
+	static bool CalibrateFromGps(int32_t& offsetSeconds);
+	static int16_t GetDriftCentiPpm();
+	static void AnchorToGps(time_t gpsTime);
+	static uint32_t GetUncertaintySeconds();
 	static TimeSpanDuration GetTimeUntilGameStart();
 	static TimeSpanDuration GetTimeUntilWindowOpens();
 	static TimeSpanDuration GetTimeUntilWindowClose();
 	static time_t GetDateTimeInUtc();
+	static void Resync();
 	static bool HasWindowOpened();
 	static bool IsGameStartReached();
 	static bool HasWindowExpired();
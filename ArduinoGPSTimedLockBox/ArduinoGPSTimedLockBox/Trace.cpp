@@ -0,0 +1,89 @@
+#include "Trace.h"
+
+uint32_t Trace::firstAt[traceEventCount];
+uint8_t Trace::seen = 0;
+TraceEntry Trace::ring[TRACE_RING_SIZE];
+uint8_t Trace::ringHead = 0;
+uint8_t Trace::ringCount = 0;
+
+void Trace::Record(traceEvent event)
+{
+	Record(event, millis());
+}
+
+// For events that are timestamped somewhere Record can't be called from, such as an ISR.
+void Trace::Record(traceEvent event, uint32_t atMillis)
+{
+	if (!(seen & (1 << event)))
+	{
+		seen |= (1 << event);
+		firstAt[event] = atMillis;
+	}
+
+	ring[ringHead].Millis = atMillis;
+	ring[ringHead].Event = event;
+	ringHead = (ringHead + 1) % TRACE_RING_SIZE;
+	if (ringCount < TRACE_RING_SIZE)
+	{
+		ringCount++;
+	}
+}
+
+void Trace::PrintEventName(uint8_t event)
+{
+	switch (event)
+	{
+	case(traceLcdInit):
+		Serial.print(F("LCD init"));
+		break;
+	case(traceRtcRead):
+		Serial.print(F("RTC read"));
+		break;
+	case(traceEepromLoad):
+		Serial.print(F("EEPROM load"));
+		break;
+	case(traceFirstNmeaChar):
+		Serial.print(F("First NMEA char"));
+		break;
+	case(traceFirstValidFix):
+		Serial.print(F("First valid fix"));
+		break;
+	case(traceDistanceComputed):
+		Serial.print(F("Distance computed"));
+		break;
+	case(traceDecisionMade):
+		Serial.print(F("Decision made"));
+		break;
+	case(traceFixTimedOut):
+		Serial.print(F("Fix timed out"));
+		break;
+	default:
+		Serial.print(F("Unknown"));
+		break;
+	}
+}
+
+// Milliseconds since boot for the first of each event, then the recent events oldest first.
+void Trace::Dump()
+{
+	Serial.println(F("TRACE first,ms"));
+	for (uint8_t i = 0; i < traceEventCount; i++)
+	{
+		if (seen & (1 << i))
+		{
+			PrintEventName(i);
+			Serial.print(',');
+			Serial.println(firstAt[i]);
+		}
+	}
+
+	Serial.println(F("TRACE recent,ms"));
+	uint8_t index = (ringHead + TRACE_RING_SIZE - ringCount) % TRACE_RING_SIZE;
+	for (uint8_t i = 0; i < ringCount; i++)
+	{
+		PrintEventName(ring[index].Event);
+		Serial.print(',');
+		Serial.println(ring[index].Millis);
+		index = (index + 1) % TRACE_RING_SIZE;
+	}
+}
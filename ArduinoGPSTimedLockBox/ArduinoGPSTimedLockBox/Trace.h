@@ -0,0 +1,37 @@
+#ifndef _TRACE_h
+#define _TRACE_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#define TRACE_RING_SIZE 16
+
+enum traceEvent { traceLcdInit, traceRtcRead, traceEepromLoad, traceFirstNmeaChar, traceFirstValidFix, traceDistanceComputed, traceDecisionMade, traceFixTimedOut, traceEventCount };
+static_assert(traceEventCount <= 8, "Trace::seen has one bit per event");
+
+struct TraceEntry
+{
+	uint32_t Millis = 0;
+	uint8_t Event = 0;
+};
+
+// Boot timing trace. The first time each event happens is kept for the whole run, and every event also goes into a small ring of the most recent ones.
+class Trace
+{
+private:
+	static uint32_t firstAt[traceEventCount];
+	static uint8_t seen;
+	static TraceEntry ring[TRACE_RING_SIZE];
+	static uint8_t ringHead;
+	static uint8_t ringCount;
+	static void PrintEventName(uint8_t event);
+public:
+	static void Record(traceEvent event);
+	static void Record(traceEvent event, uint32_t atMillis);
+	static void Dump();
+};
+
+#endif
@@ -43,13 +43,13 @@ time_t DS1307RTC::get()   // Aquire data from buffer and convert to time_t
 {
   tmElements_t tm;
   if (read(tm) == false) return 0;
-  return(makeTime(tm));
+  return(makeTimeFast(tm));
 }
 
 bool DS1307RTC::set(time_t t)
 {
   tmElements_t tm;
-  breakTime(t, tm);
+  breakTimeFast(t, tm);
   return write(tm); 
 }
 
@@ -0,0 +1,149 @@
+#include <NMEAGPS.h>
+
+//======================================================================
+//  Program: GeofenceBenchmark.ino
+//
+//  Prerequisites:
+//     1) GPS_FIX_LOCATION has been enabled (only for the Location_t class).
+//     No GPS device is needed.
+//
+//  Description:  Check Geofence_t::contains against the haversine
+//     DistanceKm over a global grid of fence centers, and time both.
+//
+//     For each center and radius, points are placed just inside
+//     (INSIDE_PCT) and just outside (OUTSIDE_PCT) the radius, in
+//     BEARINGS directions.  Any point where contains() disagrees with
+//     DistanceKm is counted as a mismatch.
+//
+//     The report has one line per radius:
+//
+//       radius m,points,mismatches,fence us,haversine us,fence cycles,haversine cycles
+//
+//     Times are per call, averaged over all points.
+//
+//  'Serial' is for the report.
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include <Streamers.h>
+
+using namespace NeoGPS;
+
+static const uint16_t radii[] = { 10, 30, 100, 500 };
+static const uint8_t  RADII       = sizeof(radii)/sizeof(radii[0]);
+static const uint8_t  BEARINGS    = 16;
+static const uint8_t  INSIDE_PCT  = 98;
+static const uint8_t  OUTSIDE_PCT = 102;
+
+// Degrees * 1e7 per meter of latitude
+static const float UNITS_PER_M =
+  1.0 / (Location_t::EARTH_RADIUS_KM * 1000.0 * Location_t::RAD_PER_DEG * Location_t::LOC_SCALE);
+
+//--------------------------
+// Place a point /meters/ away from /center/, in the direction /bearing/.
+//   This uses a local flat projection, which is exact enough at these
+//   distances that the haversine result decides inside or outside.
+
+static Location_t offset( const Location_t & center, float meters, float bearing )
+{
+  float   cosLat = cos( center.latF() * Location_t::RAD_PER_DEG );
+  int32_t dLat   = meters * cos( bearing ) * UNITS_PER_M;
+  int32_t dLon   = meters * sin( bearing ) * UNITS_PER_M / cosLat;
+
+  int32_t lon = center.lon() + dLon;
+  if (lon > 1800000000L)
+    lon = (lon - 1800000000L) - 1800000000L;
+  else if (lon < -1800000000L)
+    lon = (lon + 1800000000L) + 1800000000L;
+
+  return Location_t( center.lat() + dLat, lon );
+
+} // offset
+
+//--------------------------
+
+static void benchmark( uint16_t radius )
+{
+  uint32_t points     = 0;
+  uint32_t mismatches = 0;
+  uint32_t fenceUs    = 0;
+  uint32_t haverUs    = 0;
+
+  for (int16_t lat = -80; lat <= 80; lat += 10) {
+    for (int16_t lon = -180; lon < 180; lon += 30) {
+
+      Location_t center( (int32_t) (lat * 10000000L), (int32_t) (lon * 10000000L) );
+      Geofence_t fence( center, radius );
+
+      for (uint8_t b=0; b < BEARINGS; b++) {
+        float bearing = b * TWO_PI / BEARINGS;
+
+        for (uint8_t side=0; side < 2; side++) {
+          float      meters = radius * (side ? OUTSIDE_PCT : INSIDE_PCT) / 100.0;
+          Location_t p      = offset( center, meters, bearing );
+
+          uint32_t start = micros();
+          bool inFence = fence.contains( p );
+          fenceUs += micros() - start;
+
+          start = micros();
+          bool inHaver = (p.DistanceKm( center ) * 1000.0 <= radius);
+          haverUs += micros() - start;
+
+          points++;
+          if (inFence != inHaver)
+            mismatches++;
+        }
+      }
+    }
+  }
+
+  Serial << radius << ',' << points << ',' << mismatches << ',';
+  Serial.print( (float) fenceUs / points, 1 );
+  Serial << ',';
+  Serial.print( (float) haverUs / points, 1 );
+  Serial << ',';
+  Serial.print( ((float) fenceUs * (F_CPU / 1000000UL)) / points, 0 );
+  Serial << ',';
+  Serial.print( ((float) haverUs * (F_CPU / 1000000UL)) / points, 0 );
+  Serial << '\n';
+
+} // benchmark
+
+//--------------------------
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println( F("GeofenceBenchmark: started") );
+  Serial.print( F("Geofence_t object size = ") );
+  Serial.println( sizeof(Geofence_t) );
+  Serial.println( F("radius m,points,mismatches,fence us,haversine us,fence cycles,haversine cycles") );
+
+  for (uint8_t r=0; r < RADII; r++)
+    benchmark( radii[r] );
+
+  Serial.println( F("GeofenceBenchmark: done") );
+}
+
+//--------------------------
+
+void loop() {}
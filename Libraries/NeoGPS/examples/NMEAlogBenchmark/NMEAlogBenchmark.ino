@@ -0,0 +1,206 @@
+#include <NMEAGPS.h>
+
+//======================================================================
+//  Program: NMEAlogBenchmark.ino
+//
+//  Prerequisites:
+//     1) A recorded NMEA log file (raw receiver output, one sentence
+//          per line) on the host computer.
+//     2) A terminal program or shell that can send a file to the
+//          Serial Monitor port, e.g.:  cat capture.nmea > /dev/ttyACM0
+//
+//  Description:  Replay a recorded NMEA log through the parser and
+//     report the parsing cost for each sentence type.
+//
+//     NMEAbenchmark.ino only times one hard-coded sentence of each type.
+//     This program times the real mix of sentences (and errors) that
+//     a receiver produces, over logs of any length.
+//
+//     Each line is collected in a buffer first, then fed to gps.handle
+//     while the clock is running.  Only parser time is measured, so the
+//     results do not depend on the baud rate of the log transfer.
+//
+//     When no characters have been received for REPORT_IDLE_MS, a table
+//     of the totals is printed and the totals are cleared:
+//
+//       type,sentences,chars,us,us/sentence,cycles/char
+//
+//     followed by the overall bytes/s and sentences/s that the parser
+//     alone could sustain.
+//
+//  'Serial' is used for both the log input and the report output.
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include <Streamers.h>
+
+static NMEAGPS gps;
+
+//--------------------------
+// Longest line that will be timed.  NMEA allows 82 characters;
+//   anything longer is counted in the UNK row without being timed.
+
+static const uint8_t  LINE_MAX       = 96;
+static const uint16_t REPORT_IDLE_MS = 2000;
+
+static char    line[ LINE_MAX ];
+static uint8_t lineLen = 0;
+static bool    lineTooLong = false;
+
+//--------------------------
+// One row of totals per nmea_msg_t.  Lines that did not complete
+//   (bad checksum, unrecognized or truncated sentences) are counted
+//   in the NMEA_UNKNOWN row.
+
+struct sentence_cost_t
+{
+  uint32_t sentences;
+  uint32_t chars;
+  uint32_t us;
+};
+
+static sentence_cost_t costs[ NMEAGPS::NMEAMSG_END ];
+static uint32_t        lastRx = 0;
+static bool            anyRx  = false;
+
+//--------------------------
+
+static void timeLine()
+{
+  uint8_t row = NMEAGPS::NMEA_UNKNOWN;
+
+  uint32_t start = micros();
+  for (uint8_t i=0; i < lineLen; i++) {
+    // The trailing CR/LF reset nmeaMessage, so remember it now.
+    if (gps.handle( line[i] ) == NMEAGPS::DECODE_COMPLETED)
+      row = gps.nmeaMessage;
+  }
+  uint32_t elapsed = micros() - start;
+
+  // Drain the fix buffer so it never overruns.
+  while (gps.available())
+    gps.read();
+
+  costs[ row ].sentences++;
+  costs[ row ].chars += lineLen;
+  costs[ row ].us    += elapsed;
+
+} // timeLine
+
+//--------------------------
+
+static void printRow( const __FlashStringHelper *name, const sentence_cost_t & cost )
+{
+  if (cost.sentences == 0)
+    return;
+
+  Serial << name << ',' << cost.sentences << ',' << cost.chars << ',' << cost.us << ',';
+  Serial.print( (float) cost.us / cost.sentences, 1 );
+  Serial << ',';
+  if (cost.chars)
+    Serial.print( ((float) cost.us * (F_CPU / 1000000UL)) / cost.chars, 1 );
+  Serial << '\n';
+
+} // printRow
+
+//--------------------------
+
+static void report()
+{
+  sentence_cost_t total = { 0, 0, 0 };
+
+  Serial.println( F("type,sentences,chars,us,us/sentence,cycles/char") );
+  for (uint8_t i=NMEAGPS::NMEA_UNKNOWN; i < NMEAGPS::NMEAMSG_END; i++) {
+    printRow( gps.string_for( (NMEAGPS::nmea_msg_t) i ), costs[i] );
+    if (i != NMEAGPS::NMEA_UNKNOWN)
+      total.sentences += costs[i].sentences;
+    total.chars += costs[i].chars;
+    total.us    += costs[i].us;
+  }
+
+  if (total.us) {
+    Serial.print( F("parser bytes/s = ") );
+    Serial.println( (float) total.chars * 1000000.0 / total.us, 0 );
+    Serial.print( F("parser sentences/s = ") );
+    Serial.println( (float) total.sentences * 1000000.0 / total.us, 0 );
+  }
+
+  #ifdef NMEAGPS_STATS
+    Serial << F("stats: ok ") << gps.statistics.ok
+           << F(", errors ") << gps.statistics.errors
+           << F(", chars ") << gps.statistics.chars << '\n';
+    gps.statistics.init();
+  #endif
+
+  memset( costs, 0, sizeof(costs) );
+
+} // report
+
+//--------------------------
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println( F("NMEAlogBenchmark: started") );
+  Serial.print( F("fix object size = ") );
+  Serial.println( sizeof(gps.fix()) );
+  Serial.print( F("NMEAGPS object size = ") );
+  Serial.println( sizeof(gps) );
+  Serial.println( F("Send a recorded NMEA log now...") );
+  Serial.flush();
+}
+
+//--------------------------
+
+void loop()
+{
+  while (Serial.available()) {
+    char c = Serial.read();
+    lastRx = millis();
+    anyRx  = true;
+
+    if (lineLen < LINE_MAX)
+      line[ lineLen++ ] = c;
+    else
+      lineTooLong = true;
+
+    if (c == '\n') {
+      if (lineTooLong) {
+        costs[ NMEAGPS::NMEA_UNKNOWN ].sentences++;
+        gps.reset();
+      } else {
+        timeLine();
+      }
+      lineLen     = 0;
+      lineTooLong = false;
+    }
+  }
+
+  if (anyRx && (millis() - lastRx >= REPORT_IDLE_MS)) {
+    if (lineLen) {
+      timeLine(); // last line had no terminator
+      lineLen     = 0;
+      lineTooLong = false;
+    }
+    report();
+    anyRx = false;
+  }
+}
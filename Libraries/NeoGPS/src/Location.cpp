@@ -134,4 +134,58 @@ void Location_t::OffsetBy( float distR, float bearingR )
   _lat  = (newLat / (RAD_PER_DEG * LOC_SCALE));
   _lon += (dLon   / (RAD_PER_DEG * LOC_SCALE));
 
-} // OffsetBy
\ No newline at end of file
+} // OffsetBy
+
+//---------------------------------------------------------------------
+
+void Geofence_t::init( const Location_t & center, uint16_t radiusM )
+{
+  _center  = center;
+  _radiusM = radiusM;
+  _fast    = (radiusM <= FAST_MAX_M);
+
+  // The integer terms are only used by fast fences.  A larger radius
+  //   squared does not fit in 32 bits.
+  _radiusSq = 0;
+  _maxDLon  = 0;
+  _cosLat   = 0;
+  if (!_fast)
+    return;
+
+  // Only the latitude scale is needed: 1e-7 degrees of latitude is ~11mm.
+  float radius = radiusM /
+    (Location_t::EARTH_RADIUS_KM * 1000.0 * Location_t::RAD_PER_DEG * Location_t::LOC_SCALE);
+  _radiusSq = radius * radius;
+
+  _cosLat = cos( center.lat() * Location_t::RAD_PER_DEG * Location_t::LOC_SCALE ) * 32768.0;
+  if (_cosLat == 0)
+    _maxDLon = 0x7FFFFFFFUL;
+  else
+    _maxDLon = ((uint32_t) MAX_DELTA << 15) / _cosLat;
+
+} // init
+
+//---------------------------------------------------------------------
+
+bool Geofence_t::contains( const Location_t & p ) const
+{
+  if (!_fast)
+    return (Location_t::DistanceKm( p, _center ) * 1000.0 <= _radiusM);
+
+  int32_t dLat = p.lat() - _center.lat();
+  int32_t dLon = safeDLon( p.lon(), _center.lon() );
+  if (dLat < 0)
+    dLat = -dLat;
+  if (dLon < 0)
+    dLon = -dLon;
+
+  // Too far apart to be inside any fast fence, and too far to square.
+  if ((dLat > MAX_DELTA) || ((uint32_t) dLon > _maxDLon))
+    return false;
+
+  uint32_t x = ((uint32_t) dLon * _cosLat) >> 15;
+  uint32_t y = dLat;
+
+  return (x*x + y*y <= _radiusSq);
+
+} // contains
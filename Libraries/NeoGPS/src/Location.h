@@ -121,6 +121,44 @@ public:
 
 } NEOGPS_PACKED;
 
+//-----------------------------------
+//  A circular geofence around a center point.
+//
+//  For radii up to FAST_MAX_M, contains() uses integer equirectangular
+//  math.  The cos(lat) scale of the center is computed once by init(),
+//  and squared distances are compared, so no trig or sqrt is done for
+//  each fix.  Larger fences fall back to the haversine DistanceKm.
+//  The integer path does not handle fences that include a pole.
+
+class Geofence_t
+{
+public:
+    CONST_CLASS_DATA uint16_t FAST_MAX_M = 500;
+
+    Geofence_t() {}
+    Geofence_t( const Location_t & center, uint16_t radiusM )
+      { init( center, radiusM ); }
+
+    void init( const Location_t & center, uint16_t radiusM );
+    bool contains( const Location_t & p ) const;
+
+    const Location_t & center () const { return _center;  };
+          uint16_t     radiusM() const { return _radiusM; };
+          bool         fast   () const { return _fast;    };
+
+private:
+    // Largest scaled difference whose squares still sum within 32 bits
+    CONST_CLASS_DATA uint16_t MAX_DELTA = 46340;
+
+    Location_t _center;
+    uint32_t   _radiusSq; // (radius in degrees * 1e7) squared
+    uint32_t   _maxDLon;  // largest dLon that scales to MAX_DELTA or less
+    uint16_t   _radiusM;
+    uint16_t   _cosLat;   // cos(center latitude) * 2^15
+    bool       _fast;
+
+} NEOGPS_PACKED;
+
 } // NeoGPS
 
 #endif
\ No newline at end of file
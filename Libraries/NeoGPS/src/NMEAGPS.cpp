@@ -77,6 +77,12 @@ NMEAGPS::NMEAGPS()
 
   data_init();
 
+  #if (NMEAGPS_FIX_MAX > 0)
+    _firstFix    = _currentFix = 0;
+    _fixesStored = _fixesRead  = 0;
+  #endif
+  _overruns = 0;
+
   reset();
 }
 
@@ -302,6 +308,44 @@ NMEAGPS::decode_t NMEAGPS::handle( uint8_t c )
 
 //----------------------------------------------------------------
 
+size_t NMEAGPS::handle( const uint8_t *buf, size_t len )
+{
+  size_t         fixes = 0;
+  const uint8_t *end   = buf + len;
+
+  while (buf < end) {
+
+    #if !defined( NMEAGPS_DERIVED_TYPES )
+      // Between sentences, only a '$' is accepted.  Skip everything
+      //   else in one step, with the same side effects as /decode/.
+      //   Derived types may accept other start characters (e.g., UBX).
+      if (rxState == NMEA_IDLE) {
+        const uint8_t *start = (const uint8_t *) memchr( buf, '$', end - buf );
+        if (start == NULL)
+          start = end;
+        if (start != buf) {
+          #ifdef NMEAGPS_STATS
+            statistics.chars += (start - buf);
+          #endif
+          nmeaMessage = NMEA_UNKNOWN;
+          buf         = start;
+          if (buf == end)
+            break;
+        }
+      }
+    #endif
+
+    if ((handle( *buf++ ) == DECODE_COMPLETED) &&
+        ((merging == NO_MERGING) || intervalComplete()))
+      fixes++;
+  }
+
+  return fixes;
+
+} // handle
+
+//----------------------------------------------------------------
+
 void NMEAGPS::storeFix()
 {
   // Room for another fix?
@@ -312,7 +356,10 @@ void NMEAGPS::storeFix()
   if (!room) {
     overrun( true );
 
-    if (keepNewestFixes) {
+    // Only the reader may remove fixes while the parser runs in an ISR,
+    //   so the newest fix is dropped instead.
+
+    if (keepNewestFixes && (processing_style == PS_POLLING)) {
 
       #if NMEAGPS_FIX_MAX > 0
 
@@ -322,15 +369,20 @@ void NMEAGPS::storeFix()
           _firstFix = 0;
 
         // this new one is not available until the interval is complete
-        _fixesAvailable--;
+        _fixesRead++;
 
       #else
         // Write over the one and only fix.  It may not be complete.
         _fixesAvailable = false;
       #endif
 
+      _overruns++;
+
       // Now there's room!
       room = true;
+
+    } else if ((merging == NO_MERGING) || intervalComplete()) {
+      _overruns++;
     }
   }
 
@@ -373,8 +425,9 @@ void NMEAGPS::storeFix()
         if (_currentFix >= NMEAGPS_FIX_MAX)
           _currentFix = 0;
 
-        if (_fixesAvailable < NMEAGPS_FIX_MAX)
-          _fixesAvailable++;
+        // Publish the fix only after it has been written.
+        fifo_barrier();
+        _fixesStored++;
 
       #else // FIX_MAX == 0
         _fixesAvailable = true;
@@ -665,42 +718,197 @@ const __FlashStringHelper *NMEAGPS::string_for( nmea_msg_t msg ) const
 } // string_for
 
 //----------------------------------------------------------------
+//  Field types for the table-driven dispatcher.  Each standard
+//  sentence has a table of these types, indexed by fieldIndex-1.
+//  The sentence-specific types (GSA, GSV and ZDA) are used for
+//  sentences whose fields do not map onto one primitive parser.
+
+enum nmea_field_t {
+  FIELD_SKIP,
+  FIELD_TIME,
+  FIELD_FIX,
+  FIELD_LAT,
+  FIELD_NS,
+  FIELD_LON,
+  FIELD_EW,
+  FIELD_SPEED,
+  FIELD_HEADING,
+  FIELD_DDMMYY,
+  FIELD_ALT,
+  FIELD_GEOID_HEIGHT,
+  FIELD_SATELLITES,
+  FIELD_HDOP,
+  FIELD_LAT_ERR,
+  FIELD_LON_ERR,
+  FIELD_ALT_ERR,
+  FIELD_GSA,
+  FIELD_GSV,
+  FIELD_ZDA
+};
+
+#if defined(NMEAGPS_PARSE_GGA)
+  static const uint8_t gga_fields[] __PROGMEM =
+    {
+      FIELD_TIME,
+      FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+      FIELD_FIX,
+      FIELD_SATELLITES,
+      FIELD_HDOP,
+      FIELD_ALT,
+      FIELD_SKIP,
+      FIELD_GEOID_HEIGHT
+    };
+#endif
+#if defined(NMEAGPS_PARSE_GLL)
+  static const uint8_t gll_fields[] __PROGMEM =
+    {
+      FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+      FIELD_TIME,
+      FIELD_SKIP,
+      FIELD_FIX
+    };
+#endif
+#if defined(NMEAGPS_PARSE_GST)
+  static const uint8_t gst_fields[] __PROGMEM =
+    {
+      FIELD_TIME,
+      FIELD_SKIP, FIELD_SKIP, FIELD_SKIP, FIELD_SKIP,
+      FIELD_LAT_ERR,
+      FIELD_LON_ERR,
+      FIELD_ALT_ERR
+    };
+#endif
+#if defined(NMEAGPS_PARSE_RMC)
+  static const uint8_t rmc_fields[] __PROGMEM =
+    {
+      FIELD_TIME,
+      FIELD_FIX,
+      FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+      FIELD_SPEED,
+      FIELD_HEADING,
+      FIELD_DDMMYY
+      // 12: FIELD_FIX, ublox only!
+    };
+#endif
+#if defined(NMEAGPS_PARSE_VTG)
+  static const uint8_t vtg_fields[] __PROGMEM =
+    {
+      FIELD_HEADING,
+      FIELD_SKIP, FIELD_SKIP, FIELD_SKIP,
+      FIELD_SPEED,
+      FIELD_SKIP, FIELD_SKIP, FIELD_SKIP,
+      FIELD_FIX
+    };
+#endif
 
-bool NMEAGPS::parseField(char chr)
-{
-    switch (nmeaMessage) {
+//  One entry per std_nmea sentence.  Fields past /count/ use the
+//    /others/ type.  A sentence that is recognized but not parsed
+//    has an empty table and skips all fields.
 
-      #if defined(NMEAGPS_PARSE_GGA)
-        case NMEA_GGA: return parseGGA( chr );
-      #endif
+struct nmea_fields_t {
+  uint8_t        count;  // number of entries in /fields/
+  uint8_t        others; // nmea_field_t for fields after /count/
+  const uint8_t *fields; // PROGMEM array of nmea_field_t
+};
 
-      #if defined(NMEAGPS_PARSE_GLL)
-        case NMEA_GLL: return parseGLL( chr );
-      #endif
+#define NMEA_FIELDS(f) { sizeof(f)/sizeof(f[0]), FIELD_SKIP, f }
+#define NMEA_SENTENCE(t) { 0, t, (const uint8_t *) NULL }
+#define NMEA_IGNORED { 0, FIELD_SKIP, (const uint8_t *) NULL }
 
-      #if defined(NMEAGPS_PARSE_GSA)
-        case NMEA_GSA: return parseGSA( chr );
-      #endif
+static const nmea_fields_t std_nmea_fields[] __PROGMEM =
+  {
+    #if defined(NMEAGPS_PARSE_GGA)
+      NMEA_FIELDS( gga_fields ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_GLL)
+      NMEA_FIELDS( gll_fields ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_GSA)
+      NMEA_SENTENCE( FIELD_GSA ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_GST)
+      NMEA_FIELDS( gst_fields ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_GSV)
+      NMEA_SENTENCE( FIELD_GSV ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_RMC)
+      NMEA_FIELDS( rmc_fields ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_VTG)
+      NMEA_FIELDS( vtg_fields ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+    #if defined(NMEAGPS_PARSE_ZDA)
+      NMEA_SENTENCE( FIELD_ZDA ),
+    #elif defined(NMEAGPS_RECOGNIZE_ALL)
+      NMEA_IGNORED,
+    #endif
+  };
 
-      #if defined(NMEAGPS_PARSE_GST)
-        case NMEA_GST: return parseGST( chr );
-      #endif
+#undef NMEA_FIELDS
+#undef NMEA_SENTENCE
+#undef NMEA_IGNORED
 
-      #if defined(NMEAGPS_PARSE_GSV)
-        case NMEA_GSV: return parseGSV( chr );
-      #endif
+//----------------------------------------------------------------
+//  The field type is looked up once, when the first character of
+//  each field arrives.  Every character then goes through the one
+//  switch below, instead of a switch on the sentence type followed
+//  by a switch on the field index.
 
-      #if defined(NMEAGPS_PARSE_RMC)
-        case NMEA_RMC: return parseRMC( chr );
-      #endif
+bool NMEAGPS::parseField(char chr)
+{
+    if (chrCount == 0) {
+      const uint8_t msg = nmeaMessage - NMEA_FIRST_MSG; // UNKNOWN wraps
 
-      #if defined(NMEAGPS_PARSE_VTG)
-        case NMEA_VTG: return parseVTG( chr );
-      #endif
+      if (msg >= sizeof(std_nmea_fields)/sizeof(std_nmea_fields[0])) {
+        fieldType = FIELD_SKIP; // unknown or derived sentence type
 
-      #if defined(NMEAGPS_PARSE_ZDA)
-        case NMEA_ZDA: return parseZDA( chr );
-      #endif
+      } else {
+        const nmea_fields_t *entry = &std_nmea_fields[ msg ];
+        const uint8_t        count = pgm_read_byte( &entry->count );
+
+        if (fieldIndex <= count) {
+          const uint8_t *fields = (const uint8_t *) pgm_read_ptr( &entry->fields );
+          fieldType = pgm_read_byte( &fields[ fieldIndex-1 ] );
+        } else
+          fieldType = pgm_read_byte( &entry->others );
+      }
+    }
+
+    switch (fieldType) {
+      case FIELD_TIME        : return parseTime       ( chr );
+      case FIELD_FIX         : return parseFix        ( chr );
+      case FIELD_LAT         : return parseLat        ( chr );
+      case FIELD_NS          : return parseNS         ( chr );
+      case FIELD_LON         : return parseLon        ( chr );
+      case FIELD_EW          : return parseEW         ( chr );
+      case FIELD_SPEED       : return parseSpeed      ( chr );
+      case FIELD_HEADING     : return parseHeading    ( chr );
+      case FIELD_DDMMYY      : return parseDDMMYY     ( chr );
+      case FIELD_ALT         : return parseAlt        ( chr );
+      case FIELD_GEOID_HEIGHT: return parseGeoidHeight( chr );
+      case FIELD_SATELLITES  : return parseSatellites ( chr );
+      case FIELD_HDOP        : return parseHDOP       ( chr );
+      case FIELD_LAT_ERR     : return parse_lat_err   ( chr );
+      case FIELD_LON_ERR     : return parse_lon_err   ( chr );
+      case FIELD_ALT_ERR     : return parse_alt_err   ( chr );
+      case FIELD_GSA         : return parseGSA        ( chr );
+      case FIELD_GSV         : return parseGSV        ( chr );
+      case FIELD_ZDA         : return parseZDA        ( chr );
 
       default:
           break;
@@ -712,42 +920,6 @@ bool NMEAGPS::parseField(char chr)
 
 //----------------------------------------------------------------
 
-bool NMEAGPS::parseGGA( char chr )
-{
-  #ifdef NMEAGPS_PARSE_GGA
-    switch (fieldIndex) {
-        case  1: return parseTime( chr );
-        PARSE_LOC(2);
-        case  6: return parseFix( chr );
-        case  7: return parseSatellites( chr );
-        case  8: return parseHDOP( chr );
-        case  9: return parseAlt( chr );
-        case 11: return parseGeoidHeight( chr );
-    }
-  #endif
-
-  return true;
-
-} // parseGGA
-
-//----------------------------------------------------------------
-
-bool NMEAGPS::parseGLL( char chr )
-{
-  #ifdef NMEAGPS_PARSE_GLL
-    switch (fieldIndex) {
-        PARSE_LOC(1);
-        case 5: return parseTime( chr );
-        case 7: return parseFix( chr );
-    }
-  #endif
-
-  return true;
-
-} // parseGLL
-
-//----------------------------------------------------------------
-
 bool NMEAGPS::parseGSA( char chr )
 {
   #ifdef NMEAGPS_PARSE_GSA
@@ -833,23 +1005,6 @@ bool NMEAGPS::parseGSA( char chr )
 
 //----------------------------------------------------------------
 
-bool NMEAGPS::parseGST( char chr )
-{
-  #ifdef NMEAGPS_PARSE_GST
-    switch (fieldIndex) {
-      case 1: return parseTime( chr );
-      case 6: return parse_lat_err( chr );
-      case 7: return parse_lon_err( chr );
-      case 8: return parse_alt_err( chr );
-    }
-  #endif
-
-  return true;
-
-} // parseGST
-
-//----------------------------------------------------------------
-
 bool NMEAGPS::parseGSV( char chr )
 {
   #if defined(NMEAGPS_PARSE_GSV) & defined(NMEAGPS_PARSE_SATELLITES)
@@ -924,42 +1079,6 @@ bool NMEAGPS::parseGSV( char chr )
 
 //----------------------------------------------------------------
 
-bool NMEAGPS::parseRMC( char chr )
-{
-  #ifdef NMEAGPS_PARSE_RMC
-    switch (fieldIndex) {
-      case 1:  return parseTime   ( chr );
-      case 2:  return parseFix    ( chr );
-      PARSE_LOC(3);
-      case 7:  return parseSpeed  ( chr );
-      case 8:  return parseHeading( chr );
-      case 9:  return parseDDMMYY ( chr );
-      // case 12: return parseFix    ( chr );  ublox only!
-    }
-  #endif
-
-  return true;
-
-} // parseRMC
-
-//----------------------------------------------------------------
-
-bool NMEAGPS::parseVTG( char chr )
-{
-  #ifdef NMEAGPS_PARSE_VTG
-    switch (fieldIndex) {
-      case 1: return parseHeading( chr );
-      case 5: return parseSpeed( chr );
-      case 9: return parseFix( chr );
-    }
-  #endif
-
-  return true;
-
-} // parseVTG
-
-//----------------------------------------------------------------
-
 bool NMEAGPS::parseZDA( char chr )
 {
   #ifdef NMEAGPS_PARSE_ZDA
@@ -1943,26 +2062,35 @@ const gps_fix NMEAGPS::read()
 {
   gps_fix fix;
 
-  if (_fixesAvailable) {
-    lock();
+  #if (NMEAGPS_FIX_MAX > 0)
+
+    // No lock is needed: storeFix does not touch this slot until
+    //   _fixesRead says it has been released.
+
+    if (_available()) {
+      fifo_barrier();
+      fix = buffer[ _firstFix ];
+      if (merging == EXPLICIT_MERGING)
+        // Prepare to accumulate all fixes in an interval
+        buffer[ _firstFix ].init();
+      if (++_firstFix >= NMEAGPS_FIX_MAX)
+        _firstFix = 0;
+      fifo_barrier();
+      _fixesRead++;
+    }
 
-      #if (NMEAGPS_FIX_MAX > 0)
-        _fixesAvailable--;
-        fix = buffer[ _firstFix ];
-        if (merging == EXPLICIT_MERGING)
-          // Prepare to accumulate all fixes in an interval
-          buffer[ _firstFix ].init();
-        if (++_firstFix >= NMEAGPS_FIX_MAX)
-          _firstFix = 0;
-      #else
+  #else
+
+    if (_fixesAvailable) {
+      lock();
         if (is_safe()) {
           _fixesAvailable = false;
           fix = m_fix;
         }
-      #endif
+      unlock();
+    }
 
-    unlock();
-  }
+  #endif
 
   return fix;
 
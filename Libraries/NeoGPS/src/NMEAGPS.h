@@ -135,6 +135,20 @@ public:
     bool overrun() const { return _overrun; }
     void overrun( bool val ) { _overrun = val; }
 
+    //.......................................................................
+    //  The number of fixes dropped because the buffer was full.  Only
+    //  the parser writes it, so it can be read at any time without
+    //  disabling interrupts.
+
+    uint16_t overruns() const volatile
+      {
+        uint16_t count;
+        do {
+          count = _overruns; // an ISR may update it between the two bytes
+        } while (count != _overruns);
+        return count;
+      }
+
     //.......................................................................
     // As characters are processed, they can be categorized as
     // INVALID (not part of this protocol), OK (accepted),
@@ -149,6 +163,19 @@ public:
 
     decode_t handle( uint8_t c );
 
+    //.......................................................................
+    //  Process a contiguous span of characters, such as a chunk drained
+    //    from the serial port's RX buffer or read from a log file.
+    //    Characters between sentences are skipped without calling /decode/.
+    //    Sentences may be split across calls.
+    //    Returns the number of fixes that were completed by this span;
+    //    they can be retrieved with /available()/ and /read()/.  If the
+    //    span completes more than NMEAGPS_FIX_MAX fixes, /overrun()/ is
+    //    set, just like calling /handle/ for each character.
+    //    This should *not* be used when INTERRUPT_PROCESSING is enabled.
+
+    size_t handle( const uint8_t *buf, size_t len );
+
     //=======================================================================
     // CHARACTER-ORIENTED methods: decode, fix and is_safe
     //=======================================================================
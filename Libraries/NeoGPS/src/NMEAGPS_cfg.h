@@ -126,16 +126,22 @@
 // but you have to be more careful about using gps.fix() structure,
 // because it will be modified as characters are received.
 
-#define NMEAGPS_FIX_MAX 1
+#define NMEAGPS_FIX_MAX 2
 
 #if defined(NMEAGPS_EXPLICIT_MERGING) && (NMEAGPS_FIX_MAX == 0)
   #error You must define FIX_MAX >= 1 to allow EXPLICIT merging in NMEAGPS_cfg.h
 #endif
 
+#if (NMEAGPS_FIX_MAX > 127)
+  #error NMEAGPS_FIX_MAX must be <= 127 for the free-running FIFO counters in NMEAGPS_cfg.h
+#endif
+
 //------------------------------------------------------
 // Define how fixes are dropped when the FIFO is full.
 //   true  = the oldest fix will be dropped, and the new fix will be saved.
 //   false = the new fix will be dropped, and all old fixes will be saved.
+// With INTERRUPT_PROCESSING, the new fix is always dropped, because only
+//   read() may remove fixes from the FIFO.  See gps.overruns().
 
 #define NMEAGPS_KEEP_NEWEST_FIXES true
 
@@ -144,6 +150,9 @@
 // If you are using one of the NeoXXSerial libraries,
 //   to attachInterrupt, this must be defined.
 // Otherwise, it must be commented out.
+//
+// It can also be defined in the build flags, for one sketch only.
+//   The lockbox does that in its board.txt.
 
 //#define NMEAGPS_INTERRUPT_PROCESSING
 
@@ -331,6 +340,9 @@
 //    c) connect the PPS to an Input Capture pin.  Set the 
 //       associated TIMER frequency, calculate the elapsed time
 //       since the PPS edge, and add that to the current micros().
+//
+// It can also be defined in the build flags, for one sketch only.
+//   The lockbox does that in its board.txt.
 
 //#define NMEAGPS_TIMESTAMP_FROM_PPS
 
@@ -111,6 +111,7 @@
     uint8_t      fieldIndex;     // index of current field in the sentence
     uint8_t      chrCount;       // index of current character in current field
     uint8_t      decimal;        // digits received after the decimal point
+    uint8_t      fieldType;      // how to parse the current field, see parseField
     struct {
       bool     negative          NEOGPS_BF(1); // field had a leading '-'
       bool     _comma_needed     NEOGPS_BF(1); // field needs a comma to finish parsing
@@ -163,18 +164,37 @@
 
     //.......................................................................
 
-    uint8_t _available() const volatile { return _fixesAvailable; };
+    #if (NMEAGPS_FIX_MAX > 0)
+      uint8_t _available() const volatile
+        { return (uint8_t) (_fixesStored - _fixesRead); };
+    #else
+      uint8_t _available() const volatile { return _fixesAvailable; };
+    #endif
 
     //.......................................................................
     //  Buffered fixes.
+    //
+    //  The buffer is a single-producer, single-consumer FIFO.  Only
+    //  storeFix writes _currentFix and _fixesStored, and only read writes
+    //  _firstFix and _fixesRead.  The counters are free-running bytes, so
+    //  the number of available fixes is their difference.  Neither side
+    //  has to disable interrupts when the parser runs in an ISR.
 
     #if (NMEAGPS_FIX_MAX > 0)
       gps_fix buffer[ NMEAGPS_FIX_MAX ]; // could be empty, see NMEAGPS_cfg.h
-      uint8_t _fixesAvailable;
       uint8_t _firstFix;
       uint8_t _currentFix;
+      volatile uint8_t _fixesStored;
+      volatile uint8_t _fixesRead;
     #endif
 
+    volatile uint16_t _overruns; // fixes dropped, only written by storeFix
+
+    //  Keep the compiler from moving buffer accesses across the
+    //  FIFO counter updates.
+
+    static void fifo_barrier() { __asm__ __volatile__ ( "" ::: "memory" ); }
+
     //.......................................................................
     // Indicate that the next sentence should initialize the internal data.
     //    This is useful for coherency or custom filtering.
@@ -211,19 +231,16 @@
     decode_t parseCommand( const msg_table_t *msgs, uint8_t cmdCount, char c );
 
     //.......................................................................
-    // Parse various NMEA sentences
+    // Parse NMEA sentences whose fields are not simply a sequence
+    //   of the primary field types below.
 
-    bool parseGGA( char chr );
-    bool parseGLL( char chr );
     bool parseGSA( char chr );
-    bool parseGST( char chr );
     bool parseGSV( char chr );
-    bool parseRMC( char chr );
-    bool parseVTG( char chr );
     bool parseZDA( char chr );
 
     //.......................................................................
     // Depending on the NMEA sentence type, parse one field of an expected type.
+    //   The standard sentences are described by field tables (see NMEAGPS.cpp).
 
     NMEAGPS_VIRTUAL bool parseField( char chr );
 
@@ -48,6 +48,14 @@
 
 #include "I2CIO.h"
 
+// Values per burst transmission, limited by the Wire transmit buffer.
+#if defined(BUFFER_LENGTH)
+#define I2CIO_BURST_MAX BUFFER_LENGTH
+#elif defined(USI_BUF_SIZE)
+#define I2CIO_BURST_MAX (USI_BUF_SIZE - 1)
+#else
+#define I2CIO_BURST_MAX 16
+#endif
 
 
 // CLASS VARIABLES
@@ -62,6 +70,9 @@ I2CIO::I2CIO ( )
    _dirMask     = 0xFF;    // mark all as INPUTs
    _shadow      = 0x0;     // no values set
    _initialised = false;
+   _burst       = false;
+   _burstCount  = 0;
+   _burstStatus = true;
 }
 
 // PUBLIC METHODS
@@ -155,6 +166,23 @@ int I2CIO::write ( uint8_t value )
       // outputs updating the output shadow of the device
       _shadow = ( value & ~(_dirMask) );
 
+      if ( _burst )
+      {
+         if ( _burstCount == I2CIO_BURST_MAX )
+         {
+            _burstStatus &= ( Wire.endTransmission () == 0 );
+            Wire.beginTransmission ( _i2cAddr );
+            _burstCount = 0;
+         }
+#if (ARDUINO <  100)
+         Wire.send ( _shadow );
+#else
+         Wire.write ( _shadow );
+#endif
+         _burstCount++;
+         return ( 1 );
+      }
+
       Wire.beginTransmission ( _i2cAddr );
 #if (ARDUINO <  100)
       Wire.send ( _shadow );
@@ -211,6 +239,34 @@ int I2CIO::digitalWrite ( uint8_t pin, uint8_t level )
    return ( status );
 }
 
+//
+// beginBurst
+bool I2CIO::beginBurst ( void )
+{
+   if ( _initialised && !_burst )
+   {
+      Wire.beginTransmission ( _i2cAddr );
+      _burst       = true;
+      _burstCount  = 0;
+      _burstStatus = true;
+      return ( true );
+   }
+   return ( false );
+}
+
+//
+// endBurst
+int I2CIO::endBurst ( void )
+{
+   if ( _burst )
+   {
+      _burst = false;
+      // An empty transmission is still ended so that the bus is released.
+      _burstStatus &= ( Wire.endTransmission () == 0 );
+   }
+   return ( _burstStatus );
+}
+
 //
 // PRIVATE METHODS
 // ---------------------------------------------------------------------------
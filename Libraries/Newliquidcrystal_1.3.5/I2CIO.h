@@ -135,13 +135,36 @@ public:
     */   
    int digitalWrite ( uint8_t pin, uint8_t level );
    
+   /*!
+    @method
+    @abstract   Start collecting writes into burst transfers.
+    @discussion Until endBurst is called, write and digitalWrite add their
+    value to an open I2C transmission instead of sending a transmission
+    each. A transmission is sent whenever it holds I2CIO_BURST_MAX values.
+    The PCF8574 latches each byte of a transmission onto the port in turn,
+    so the port sees exactly the same sequence of values as without bursts.
+    Do not read the device while a burst is open.
+    @result     true if this call opened the burst, false if one was already
+    open or the device is not initialised. Only the caller that opened a
+    burst should end it.
+    */
+   bool beginBurst ( void );
    
+   /*!
+    @method
+    @abstract   Send any values still held and leave burst mode.
+    @result     1 if every transmission of the burst succeeded, 0 otherwise.
+    */
+   int endBurst ( void );
    
 private:
    uint8_t _shadow;      // Shadow output
    uint8_t _dirMask;     // Direction mask
    uint8_t _i2cAddr;     // I2C address
    bool    _initialised; // Initialised object
+   bool    _burst;       // Writes are being collected into a transmission
+   uint8_t _burstCount;  // Values in the open transmission
+   bool    _burstStatus; // No transmission of the burst has failed
 
   /*!
    @method
@@ -186,6 +186,47 @@ void LiquidCrystal_I2C::setBacklight( uint8_t value )
 }
 
 
+//
+// beginBurst
+void LiquidCrystal_I2C::beginBurst ( void )
+{
+   _i2cio.beginBurst ( );
+}
+
+//
+// endBurst
+int LiquidCrystal_I2C::endBurst ( void )
+{
+   return ( _i2cio.endBurst ( ) );
+}
+
+//
+// write
+#if (ARDUINO <  100)
+void LiquidCrystal_I2C::write(const uint8_t *buffer, size_t size)
+#else
+size_t LiquidCrystal_I2C::write(const uint8_t *buffer, size_t size)
+#endif
+{
+   size_t n = 0;
+   
+   // Inside the caller's own burst, the characters join it and the caller
+   // ends it.
+   bool opened = _i2cio.beginBurst ( );
+   while ( n < size )
+   {
+      send ( buffer[n++], LCD_DATA );
+   }
+   if ( opened )
+   {
+      _i2cio.endBurst ( );
+   }
+#if (ARDUINO >=  100)
+   return ( n );
+#endif
+}
+
+
 // PRIVATE METHODS
 // ---------------------------------------------------------------------------
 
@@ -143,6 +143,39 @@ public:
     @param      value: backlight mode (HIGH|LOW)
     */
    void setBacklight ( uint8_t value );
+   
+   /*!
+    @function
+    @abstract   Start sending LCD accesses in burst transfers.
+    @discussion Every nibble and enable pulse sent until endBurst is called
+    goes into as few I2C transmissions as the Wire buffer allows, instead
+    of one transmission per expander write (six per character). The bytes
+    on the bus are the same as without bursts. Use it around sequences of
+    commands and characters, such as a cursor move and the text after it;
+    commands that need a delay to execute, like clear() and home(), must not
+    be sent inside a burst.
+    */
+   void beginBurst ( void );
+   
+   /*!
+    @function
+    @abstract   Send whatever is left of the burst.
+    @result     1 if all the transfers of the burst succeeded, 0 otherwise.
+    */
+   int endBurst ( void );
+   
+   /*!
+    @function
+    @abstract   Writes a buffer of characters to the LCD.
+    @discussion Sends the whole buffer as one burst, so print() of a string
+    costs a handful of I2C transmissions instead of six per character.
+    */
+#if (ARDUINO <  100)
+   virtual void write(const uint8_t *buffer, size_t size);
+#else
+   virtual size_t write(const uint8_t *buffer, size_t size);
+#endif
+   using LCD::write;
 
 private:
 
@@ -37,6 +37,10 @@ static char dummyvar; // dummy declaration for STUPID IDE!!!!
  *		This is the amount of time it takes to update the full LCD display.
  *
  *
+ * With LCDIF_I2C the FPS test is run a second time with each row sent as
+ * an I2C burst (see LiquidCrystal_I2C::beginBurst) and the burst
+ * ByteXfer/FPS/Ftime are reported as well, along with the speedup.
+ *
  * The sketch will also report "independent" FPS and Ftime values.
  * These are timing values that are independent of the size of the LCD under test.
  * Currently they represent the timing for a 16x2 LCD
@@ -174,7 +178,10 @@ char buf[8];
 	 * Time an FPS test
 	 */
 
-	etime = timeFPS(FPS_iter, LCD_COLS, LCD_ROWS);
+	etime = timeFPS(FPS_iter, LCD_COLS, LCD_ROWS, false);
+#if defined(LCDIF_I2C)
+	unsigned long ntime = etime;
+#endif
 
 	/*
  	 * show the average single byte xfer time during the FPS test
@@ -205,9 +212,25 @@ char buf[8];
 	showFPS(etime, buf);
 #endif
 
+#if defined(LCDIF_I2C)
+	/*
+	 * Same test with every row sent as one I2C burst
+	 */
+	unsigned long btime = timeFPS(FPS_iter, LCD_COLS, LCD_ROWS, true);
+
+	showByteXfer(btime);
+	showFPS(btime, "Burst");
+
+	lcd.clear();
+	lcd.print("Burst gain: ");
+	lcd.print((float) ntime / btime);
+	lcd.print("x");
+	delay(DELAY_TIME);
+#endif
+
 }
 
-unsigned long timeFPS(uint8_t iter, uint8_t cols, uint8_t rows)
+unsigned long timeFPS(uint8_t iter, uint8_t cols, uint8_t rows, bool burst)
 {
 char c;
 unsigned long stime, etime;
@@ -219,11 +242,19 @@ unsigned long stime, etime;
 		{
 			for(uint8_t row = 0; row < rows; row++)
 			{
+#if defined(LCDIF_I2C)
+				if(burst)
+					lcd.beginBurst();
+#endif
 				lcd.setCursor(0, row);
 				for(uint8_t col = 0; col< cols;col++)
 				{
 					lcd.write(c);
 				}
+#if defined(LCDIF_I2C)
+				if(burst)
+					lcd.endBurst();
+#endif
 			}
 		}
 	}
@@ -71,7 +71,11 @@ extern void *__brkval;
  @defined    NUM_BENCHMARKS
  @abstract   Number of benchmarks in the project.
  */
+#ifdef _LCD_I2C_
+#define NUM_BENCHMARKS 5
+#else
 #define NUM_BENCHMARKS 4
+#endif
 
 /*!
  @defined    ITERATIONS
@@ -199,6 +203,9 @@ extern long benchmark1 ( uint8_t );
 extern long benchmark2 ( uint8_t );
 extern long benchmark3 ( uint8_t );
 extern long benchmark4 ( uint8_t );
+#ifdef _LCD_I2C_
+extern long benchmark5 ( uint8_t );
+#endif
 
 //! @brief benchmark structure that will be initialised and 
 static t_benchMarks myBenchMarks[NUM_BENCHMARKS] =
@@ -206,7 +213,10 @@ static t_benchMarks myBenchMarks[NUM_BENCHMARKS] =
    { benchmark1, 0, (LCD_ROWS * LCD_COLUMNS) + 2 },
    { benchmark2, 0, LCD_ROWS * LCD_COLUMNS * 6 * 2 },
    { benchmark3, 0, 40 + 2 },
-   { benchmark4, 0, 40 + 2 }
+   { benchmark4, 0, 40 + 2 },
+#ifdef _LCD_I2C_
+   { benchmark5, 0, (LCD_ROWS * LCD_COLUMNS) + 2 }
+#endif
 };
 
 // Static methods
@@ -445,6 +455,48 @@ long benchmark4 ( uint8_t iterations )
    return ( totalTime );
 }
 
+#ifdef _LCD_I2C_
+/*!
+ @function   benchmark5
+ @abstract   benchmark1 sent as I2C bursts.
+ @discussion Same accesses as benchmark1, but each line (cursor move and
+             characters) goes out as one burst of I2C transmissions rather
+             than one transmission per expander write. Comparing it with
+             benchmark1 gives the gain of the burst mode.
+ 
+ @param[in]  iterations: number of iterations the benchmark is executed before
+             returning the time taken by all iterations.
+ @return     The time take to execute iterations number of benchmarks.
+ */
+long benchmark5 ( uint8_t iterations )
+{
+   unsigned long time, totalTime = 0;
+   int i, j;
+   
+   while ( iterations > 0 )
+   {
+      // Clear the LCD
+      lcd.clear ( );
+   
+      time = micros ();
+      for ( i = 0; i < LCD_ROWS; i++ )
+      {
+         lcd.beginBurst ( );
+         lcd.setCursor ( 0, i );
+         for ( j = 0; j < LCD_COLUMNS; j++ )
+         {
+            lcd.write ( 5 );
+         }
+         lcd.endBurst ( );
+      }
+      totalTime += ( micros() - time );
+      delay ( 200 ); // it doesn't keep up with the LCD refresh rate.
+      iterations--;
+   }
+   return ( totalTime );
+}
+#endif
+
 // Main system setup
 // -----------------
 void setup ()
@@ -494,4 +546,8 @@ void loop ()
    }
    Serial.print( F("avg. write: ") );
    Serial.println( fAllWrites / (float)NUM_BENCHMARKS );
+#ifdef _LCD_I2C_
+   Serial.print( F("burst gain (benchmark0 / benchmark4): ") );
+   Serial.println( myBenchMarks[0].benchTime / (float)myBenchMarks[4].benchTime );
+#endif
  }
\ No newline at end of file
@@ -231,6 +231,81 @@ time_t makeTime(const tmElements_t &tm){
   seconds+= tm.Second;
   return (time_t)seconds; 
 }
+/*============================================================================*/
+/* constant time versions of breakTime and makeTime */
+/* The loops above walk every year since 1970, so their cost grows with the date. These count whole
+   days in years that start on 1 March, so leap days fall at the end of a year and every year but the
+   one ending in February 2100 follows the same four year pattern. All the day arithmetic fits in 16 bits
+   for any date a time_t can hold (1970 to 2106). */
+
+#define DAYS_BEFORE_1970 671  // from 1 March 1968 to 1 January 1970
+#define MARCH_YEARS_TO_2100 132  // March years from 1968 to the one that starts 1 March 2100
+#define DAYS_TO_MARCH_2100 48212  // from 1 March 1968 to 1 March 2100
+
+// the year last converted by civilFromDays, so later days in the same year skip the year arithmetic
+static uint16_t cachedYearStart = 0xFFFF;  // days since 1 March 1968
+static uint16_t cachedYearLength = 0;
+static uint8_t cachedMarchYear = 0;  // March years since 1968
+
+uint16_t daysFromCivil(uint8_t year, uint8_t month, uint8_t day){
+// days from 1 Jan 1970 to the given date. year is offset from 1970, as in tmElements_t
+  uint8_t marchYear = year + 2 - (month <= 2);  // March years since 1968
+  uint8_t marchMonth = (month <= 2) ? month + 9 : month - 3;  // March is 0
+  uint16_t days = marchYear * 365U + (marchYear >> 2) - (marchYear >= MARCH_YEARS_TO_2100);
+  days += (153U * marchMonth + 2) / 5 + day - 1;
+  return days - DAYS_BEFORE_1970;
+}
+
+void civilFromDays(uint16_t daysSince1970, tmElements_t &tm){
+// fills in Year, Month, Day and Wday for a count of days since 1 Jan 1970
+  uint16_t days = daysSince1970 + DAYS_BEFORE_1970;
+  tm.Wday = ((daysSince1970 + 4) % 7) + 1;  // Sunday is day 1
+
+  if ((uint16_t)(days - cachedYearStart) >= cachedYearLength) {
+    // 2100 is not a leap year, so count from March 2100 as if it had been
+    uint16_t cycleDays = days + (days >= DAYS_TO_MARCH_2100);
+    uint8_t cycle = cycleDays / 1461;  // four year cycles, each ending with a leap day
+    uint16_t dayOfCycle = cycleDays - cycle * 1461U;
+    uint8_t yearOfCycle = dayOfCycle / 365;
+    if (yearOfCycle == 4) {
+      yearOfCycle = 3;  // the leap day
+    }
+    cachedMarchYear = cycle * 4 + yearOfCycle;
+    cachedYearStart = days - (dayOfCycle - yearOfCycle * 365U);
+    cachedYearLength = (yearOfCycle == 3 && cachedMarchYear != MARCH_YEARS_TO_2100 - 1) ? 366 : 365;
+  }
+
+  uint16_t dayOfYear = days - cachedYearStart;
+  uint8_t marchMonth = (5 * dayOfYear + 2) / 153;
+  tm.Day = dayOfYear - (153U * marchMonth + 2) / 5 + 1;
+  if (marchMonth < 10) {
+    tm.Month = marchMonth + 3;
+    tm.Year = cachedMarchYear - 2;
+  } else {
+    tm.Month = marchMonth - 9;
+    tm.Year = cachedMarchYear - 1;
+  }
+}
+
+void breakTimeFast(time_t timeInput, tmElements_t &tm){
+// same result as breakTime
+  uint32_t time = (uint32_t)timeInput;
+  uint16_t days = time / SECS_PER_DAY;
+  uint32_t secondOfDay = time - days * SECS_PER_DAY;
+  tm.Hour = (uint16_t)(secondOfDay >> 4) / 225;  // 3600 is 16 * 225, and a day's seconds / 16 fits in 16 bits
+  uint16_t secondOfHour = secondOfDay - tm.Hour * 3600UL;
+  tm.Minute = secondOfHour / 60;
+  tm.Second = secondOfHour - tm.Minute * 60;
+  civilFromDays(days, tm);
+}
+
+time_t makeTimeFast(const tmElements_t &tm){
+// same result as makeTime for months 1 to 12 and days 1 to 31 (days past the end of a month carry into the next, as in makeTime)
+  uint32_t seconds = daysFromCivil(tm.Year, tm.Month, tm.Day) * SECS_PER_DAY;
+  seconds += tm.Hour * 3600UL + tm.Minute * 60U + tm.Second;
+  return (time_t)seconds;
+}
+
 /*=====================================================*/	
 /* Low level system time functions  */
 
@@ -137,6 +137,10 @@ void    setSyncInterval(time_t interval); // set the number of seconds between r
 /* low level functions to convert to and from system time                     */
 void breakTime(time_t time, tmElements_t &tm);  // break time_t into elements
 time_t makeTime(const tmElements_t &tm);  // convert time elements into time_t
+void breakTimeFast(time_t time, tmElements_t &tm);  // as breakTime, in constant time
+time_t makeTimeFast(const tmElements_t &tm);  // as makeTime, in constant time
+uint16_t daysFromCivil(uint8_t year, uint8_t month, uint8_t day);  // days since 1 Jan 1970, year offset from 1970
+void civilFromDays(uint16_t days, tmElements_t &tm);  // sets Year, Month, Day and Wday from days since 1 Jan 1970
 
 } // extern "C++"
 #endif // __cplusplus
@@ -0,0 +1,201 @@
+// Host check and timing of the integer Bearing against NeoGPS's floating point Location_t::BearingTo.
+//   - Atan2 over 2 million vectors in every direction, and its exact answers on the axes and at the ends of int32_t;
+//   - Between and BearingTo against a double precision great circle bearing from the same integer positions, in bands of
+//     distance from 1 m to 100 km, and how often Between gives the same compass point;
+//   - the time per call of each, on the host.
+// The host has an FPU, so the times only show the integer versions aren't slower. On the AVR, without one, the floating
+// point versions cost far more.
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Bearing.h"
+
+static const int ATAN2_VECTORS = 2000000;
+static const int BAND_PAIRS = 200000;
+static const int TIMED_INPUTS = 1 << 16;
+static const int TIMED_ROUNDS = 40;
+
+static int failures = 0;
+
+// The initial great circle bearing in degrees.
+static double ExactBearing(const NeoGPS::Location_t& from, const NeoGPS::Location_t& to)
+{
+	double lat1 = from.lat() * 1e-7 * M_PI / 180;
+	double lat2 = to.lat() * 1e-7 * M_PI / 180;
+	double dLon = (double)to.lon() - from.lon();
+	if (dLon > 1.8e9)
+	{
+		dLon -= 3.6e9;
+	}
+	if (dLon < -1.8e9)
+	{
+		dLon += 3.6e9;
+	}
+	dLon *= 1e-7 * M_PI / 180;
+	double bearing = atan2(sin(dLon) * cos(lat2), cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon)) * 180 / M_PI;
+	return (bearing < 0) ? bearing + 360 : bearing;
+}
+
+static double Wrap(double degrees)
+{
+	while (degrees > 180)
+	{
+		degrees -= 360;
+	}
+	while (degrees < -180)
+	{
+		degrees += 360;
+	}
+	return degrees;
+}
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void CheckAtan2(std::mt19937& random)
+{
+	std::uniform_real_distribution<double> uniform(0, 1);
+	double worst = 0;
+	for (int i = 0; i < ATAN2_VECTORS; i++)
+	{
+		double angle = uniform(random) * 2 * M_PI;
+		double length = pow(10, uniform(random) * 9);
+		if (length < 100)
+		{
+			continue; // Tiny vectors are limited by rounding the inputs, not by Atan2.
+		}
+		int32_t x = lround(length * cos(angle));
+		int32_t y = lround(length * sin(angle));
+		double expected = atan2((double)y, (double)x) * 180 / M_PI;
+		if (expected < 0)
+		{
+			expected += 360;
+		}
+		worst = max(worst, fabs(Wrap(Bearing::Atan2(y, x) / 100.0 - expected)));
+	}
+	printf("  Atan2 worst error %.4f degrees\n", worst);
+	Expect("Atan2 within 0.02 degrees", worst <= 0.02);
+	Expect("Atan2 on the axes", Bearing::Atan2(0, 0) == 0 && Bearing::Atan2(0, 5) == 0 && Bearing::Atan2(5, 0) == 9000
+		&& Bearing::Atan2(0, -5) == 18000 && Bearing::Atan2(-5, 0) == 27000);
+	Expect("Atan2 at the ends of int32_t", Bearing::Atan2(INT32_MIN, INT32_MIN) == 22500 && Bearing::Atan2(INT32_MAX, INT32_MIN) == 13500);
+}
+
+// Between is checked from 10 m to 10 km. Closer, a 1e-7 degree position is a large part of the distance, and further the
+// flat projection it uses drifts from the great circle.
+static void CheckBetween(std::mt19937& random)
+{
+	static const double bands[] = { 1, 10, 100, 1000, 10000, 100000 };
+	std::uniform_real_distribution<double> uniform(0, 1);
+	printf("meters,Between rms,worst,BearingTo rms,worst,same compass point %%\n");
+	for (int b = 0; b + 1 < 6; b++)
+	{
+		double sumSquares = 0;
+		double worst = 0;
+		double floatSumSquares = 0;
+		double floatWorst = 0;
+		int compassAgrees = 0;
+		for (int i = 0; i < BAND_PAIRS; i++)
+		{
+			double lat = uniform(random) * 140 - 70;
+			double lon = uniform(random) * 360 - 180;
+			double distance = bands[b] * pow(10, uniform(random));
+			double heading = uniform(random) * 2 * M_PI;
+			double dLat = distance * cos(heading) / 111320;
+			double lon2 = lon + distance * sin(heading) / (111320 * cos(lat * M_PI / 180));
+			if (lon2 > 180)
+			{
+				lon2 -= 360;
+			}
+			if (lon2 < -180)
+			{
+				lon2 += 360;
+			}
+			NeoGPS::Location_t from((int32_t)lround(lat * 1e7), (int32_t)lround(lon * 1e7));
+			NeoGPS::Location_t to((int32_t)lround((lat + dLat) * 1e7), (int32_t)lround(lon2 * 1e7));
+			double reference = ExactBearing(from, to);
+			uint16_t between = Bearing::Between(from, to);
+			double error = fabs(Wrap(between / 100.0 - reference));
+			double floatError = fabs(Wrap(NeoGPS::Location_t::BearingTo(from, to) * 180 / M_PI - reference));
+			sumSquares += error * error;
+			worst = max(worst, error);
+			floatSumSquares += floatError * floatError;
+			floatWorst = max(floatWorst, floatError);
+			compassAgrees += Bearing::CompassPoint(between) == Bearing::CompassPoint((uint16_t)(lround(reference * 100) % 36000));
+		}
+		printf("%.0f-%.0f,%.3f,%.3f,%.3f,%.3f,%.2f\n", bands[b], bands[b + 1], sqrt(sumSquares / BAND_PAIRS), worst,
+			sqrt(floatSumSquares / BAND_PAIRS), floatWorst, 100.0 * compassAgrees / BAND_PAIRS);
+		if (bands[b] >= 10 && bands[b] < 10000 && worst > 0.5)
+		{
+			printf("FAIL: Between is out by %.3f degrees at %.0f-%.0f m\n", worst, bands[b], bands[b + 1]);
+			failures++;
+		}
+	}
+}
+
+static uint64_t Cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+template <typename Body> static void Time(const char* name, Body body)
+{
+	uint64_t startCycles = Cycles();
+	auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < TIMED_ROUNDS; round++)
+	{
+		for (int i = 0; i < TIMED_INPUTS; i++)
+		{
+			body(i);
+		}
+	}
+	double calls = (double)TIMED_ROUNDS * TIMED_INPUTS;
+	double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	printf("%s,%.1f,%.1f\n", name, nanoseconds / calls, (Cycles() - startCycles) / calls);
+}
+
+static void TimeVersions(std::mt19937& random)
+{
+	static NeoGPS::Location_t froms[TIMED_INPUTS];
+	static NeoGPS::Location_t tos[TIMED_INPUTS];
+	static int32_t xs[TIMED_INPUTS];
+	static int32_t ys[TIMED_INPUTS];
+	std::uniform_real_distribution<double> uniform(0, 1);
+	for (int i = 0; i < TIMED_INPUTS; i++)
+	{
+		froms[i] = NeoGPS::Location_t((int32_t)lround((uniform(random) * 140 - 70) * 1e7), (int32_t)lround((uniform(random) * 360 - 180) * 1e7));
+		tos[i] = NeoGPS::Location_t(froms[i].lat() + (int32_t)(uniform(random) * 200000 - 100000),
+			froms[i].lon() + (int32_t)(uniform(random) * 200000 - 100000));
+		xs[i] = (int32_t)(uniform(random) * 2e6 - 1e6);
+		ys[i] = (int32_t)(uniform(random) * 2e6 - 1e6);
+	}
+	volatile float floatSink = 0;
+	volatile uint32_t sink = 0;
+	printf("function,ns per call,TSC cycles per call\n");
+	Time("Location_t::BearingTo", [&](int i) { floatSink = floatSink + NeoGPS::Location_t::BearingTo(froms[i], tos[i]); });
+	Time("Bearing::Between", [&](int i) { sink = sink + Bearing::Between(froms[i], tos[i]); });
+	Time("atan2f", [&](int i) { floatSink = floatSink + atan2f((float)ys[i], (float)xs[i]); });
+	Time("Bearing::Atan2", [&](int i) { sink = sink + Bearing::Atan2(ys[i], xs[i]); });
+}
+
+int main()
+{
+	std::mt19937 random(7);
+	CheckAtan2(random);
+	CheckBetween(random);
+	TimeVersions(random);
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+// Host check of the Time library's constant time calendar functions against the original loops, over every date a 32 bit
+// time_t can hold (1970 to 2106):
+//   - breakTimeFast against breakTime and the C library's gmtime, for every day at the edges of its hours, every second of
+//     the days around leap days and the end of time_t, and random times in and out of the cached year;
+//   - makeTimeFast against makeTime for every day 1 to 31 of every month, including the days that carry into the next month;
+//   - daysFromCivil and civilFromDays round trips.
+// The times at the end compare the two versions on the host, at the same -O2, for dates in one game year and across the
+// whole range.
+#include <chrono>
+#include <stdio.h>
+#include <time.h>
+#include <TimeLib.h>
+
+static const uint32_t LAST_DAY = 0xFFFFFFFFUL / SECS_PER_DAY;
+static const uint32_t DAY_OFFSETS[] = { 0, 1, 59, 60, 3599, 3600, 43199, 43200, 82800, 86399 };
+// 1 Jan 1970, 29 Feb 1972, 29 Feb 2000, 1 Jan 2000, 1 Mar 2100 and the days either side of it, and the last day.
+static const uint32_t WHOLE_DAYS[] = { 0, 789, 11016, 10956, 48212, 48211, 48213, LAST_DAY };
+static const long RANDOM_TIMES = 5000000;
+static const int TIMED_CALLS = 1000000;
+
+static uint32_t failures = 0;
+
+static bool Same(const tmElements_t& a, const tmElements_t& b)
+{
+	return a.Second == b.Second && a.Minute == b.Minute && a.Hour == b.Hour && a.Wday == b.Wday && a.Day == b.Day
+		&& a.Month == b.Month && a.Year == b.Year;
+}
+
+static void Fail(const char* what, uint32_t t, const tmElements_t& expected, const tmElements_t& actual)
+{
+	if (failures++ < 10)
+	{
+		printf("%s %u: %d-%02d-%02d %02d:%02d:%02d day %d, not %d-%02d-%02d %02d:%02d:%02d day %d\n", what, t,
+			tmYearToCalendar(expected.Year), expected.Month, expected.Day, expected.Hour, expected.Minute, expected.Second, expected.Wday,
+			tmYearToCalendar(actual.Year), actual.Month, actual.Day, actual.Hour, actual.Minute, actual.Second, actual.Wday);
+	}
+}
+
+static void CheckBreak(uint32_t t, bool againstGmtime)
+{
+	tmElements_t slow = {};
+	tmElements_t fast = {};
+	breakTime(t, slow);
+	breakTimeFast(t, fast);
+	if (!Same(slow, fast))
+	{
+		Fail("breakTimeFast", t, slow, fast);
+	}
+	if (againstGmtime)
+	{
+		time_t hostTime = t;
+		struct tm* utc = gmtime(&hostTime);
+		tmElements_t c = {};
+		c.Second = utc->tm_sec;
+		c.Minute = utc->tm_min;
+		c.Hour = utc->tm_hour;
+		c.Wday = utc->tm_wday + 1;
+		c.Day = utc->tm_mday;
+		c.Month = utc->tm_mon + 1;
+		c.Year = CalendarYrToTm(utc->tm_year + 1900);
+		if (!Same(c, fast))
+		{
+			Fail("gmtime", t, c, fast);
+		}
+	}
+}
+
+static uint32_t CheckBreakTime()
+{
+	uint32_t checks = 0;
+	for (uint32_t day = 0; day <= LAST_DAY; day++)
+	{
+		for (uint32_t offset : DAY_OFFSETS)
+		{
+			uint64_t t = (uint64_t)day * SECS_PER_DAY + offset;
+			if (t <= 0xFFFFFFFFUL)
+			{
+				CheckBreak((uint32_t)t, true);
+				checks++;
+			}
+		}
+	}
+	for (uint32_t day : WHOLE_DAYS)
+	{
+		for (uint32_t second = 0; second < SECS_PER_DAY; second++)
+		{
+			uint64_t t = (uint64_t)day * SECS_PER_DAY + second;
+			if (t <= 0xFFFFFFFFUL)
+			{
+				CheckBreak((uint32_t)t, false);
+				checks++;
+			}
+		}
+	}
+	// In random order the cached year is mostly missed. The second time of each pair is often in the same year.
+	uint32_t seed = 7;
+	for (long i = 0; i < RANDOM_TIMES; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		CheckBreak(seed, false);
+		CheckBreak(seed + SECS_PER_DAY * (seed >> 27), false);
+		checks += 2;
+	}
+	return checks;
+}
+
+static uint32_t CheckMakeTime()
+{
+	static const uint8_t hours[] = { 0, 1, 12, 23 };
+	static const uint8_t minutes[] = { 0, 30, 59 };
+	static const uint8_t seconds[] = { 0, 59 };
+	uint32_t checks = 0;
+	for (int year = 0; year <= 136; year++)
+	{
+		for (int month = 1; month <= 12; month++)
+		{
+			for (int day = 1; day <= 31; day++)
+			{
+				if (year == 136 && (month > 2 || (month == 2 && day > 6)))
+				{
+					continue; // Past the end of a 32 bit time_t.
+				}
+				for (uint8_t hour : hours)
+				{
+					for (uint8_t minute : minutes)
+					{
+						for (uint8_t second : seconds)
+						{
+							tmElements_t tm = {};
+							tm.Year = year;
+							tm.Month = month;
+							tm.Day = day;
+							tm.Hour = hour;
+							tm.Minute = minute;
+							tm.Second = second;
+							uint32_t slow = makeTime(tm);
+							uint32_t fast = makeTimeFast(tm);
+							checks++;
+							if (slow != fast && failures++ < 10)
+							{
+								printf("makeTimeFast %d-%02d-%02d %02d:%02d:%02d: %u, not %u\n", tmYearToCalendar(year), month, day, hour, minute, second,
+									fast, slow);
+							}
+						}
+					}
+				}
+				uint16_t days = daysFromCivil(year, month, day);
+				tmElements_t back = {};
+				civilFromDays(days, back);
+				if (day <= 28 && (back.Year != year || back.Month != month || back.Day != day) && failures++ < 10)
+				{
+					printf("round trip %d-%02d-%02d: day %u, back to %d-%02d-%02d\n", tmYearToCalendar(year), month, day, days,
+						tmYearToCalendar(back.Year), back.Month, back.Day);
+				}
+			}
+		}
+	}
+	return checks;
+}
+
+static double NanosecondsPerCall(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / TIMED_CALLS;
+}
+
+static void TimeVersions(const char* name, uint32_t first, uint32_t span)
+{
+	static uint32_t times[TIMED_CALLS];
+	static tmElements_t broken[TIMED_CALLS];
+	uint32_t seed = 11;
+	for (int i = 0; i < TIMED_CALLS; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		times[i] = first + seed % span;
+		breakTime(times[i], broken[i]);
+	}
+	volatile uint32_t sink = 0;
+	tmElements_t tm;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < TIMED_CALLS; i++)
+	{
+		breakTime(times[i], tm);
+		sink += tm.Day;
+	}
+	double breakSlow = NanosecondsPerCall(start);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < TIMED_CALLS; i++)
+	{
+		breakTimeFast(times[i], tm);
+		sink += tm.Day;
+	}
+	double breakFast = NanosecondsPerCall(start);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < TIMED_CALLS; i++)
+	{
+		sink += makeTime(broken[i]);
+	}
+	double makeSlow = NanosecondsPerCall(start);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < TIMED_CALLS; i++)
+	{
+		sink += makeTimeFast(broken[i]);
+	}
+	double makeFast = NanosecondsPerCall(start);
+	printf("%s,%.1f,%.1f,%.1f,%.1f\n", name, breakSlow, breakFast, makeSlow, makeFast);
+}
+
+int main()
+{
+	uint32_t breakChecks = CheckBreakTime();
+	uint32_t makeChecks = CheckMakeTime();
+	printf("breakTime checks %u, makeTime checks %u, failures %u\n", breakChecks, makeChecks, failures);
+
+	printf("dates,breakTime ns,breakTimeFast ns,makeTime ns,makeTimeFast ns\n");
+	TimeVersions("60 days of 2030", 1893456000UL, 60 * SECS_PER_DAY);
+	TimeVersions("1970-2106", 0, 0xFFFFFFFFUL);
+	printf("%s\n", failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
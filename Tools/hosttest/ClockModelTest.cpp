@@ -0,0 +1,171 @@
+// Host check of Temporal's clock model over four week games on a drifting RTC (SimulatedClock), with GPS fixes only now
+// and then and no PPS. Temporal::AnchorToGps is given each fix's time, up to a second late, every 10 s while the GPS is on.
+//   - The modelled time must stay within its own uncertainty bound, give or take the whole second of a reading;
+//   - an open window must never be refused;
+//   - with fixes a day or more apart, the drift's uncertainty must come down from the uncalibrated 100 ppm to 10 ppm, and
+//     the estimate must be within it of the RTC's mean drift, give or take its temperature swing;
+//   - a failed RTC read, which DS1307RTC gives as 0, must leave the model and the anchor as they were.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Physical.h"
+#define private public // To restart the unit, and to see the model.
+#include "Temporal.h"
+#undef private
+#include "SimulatedClock.h"
+
+static const int GAME_DAYS = 28;
+
+static int failures = 0;
+
+struct GameCase
+{
+	const char* name;
+	double meanPpm;
+	double swingPpm;
+	int gpsEveryHours;
+	int gpsSessionMinutes;
+	bool calibrated; // By CalibrateFromGps beforehand, to 12.7 ppm.
+};
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void Restart()
+{
+	Temporal::modelLoaded = false;
+	Temporal::anchorChecked = false;
+	Temporal::snapshotValid = false;
+}
+
+static void CheckGame(const GameCase& game)
+{
+	SimulatedClock::Reset();
+	Restart();
+	Temporal::anchorTime = 0;
+	SimulatedClock::RtcPpm = game.meanPpm;
+	SimulatedClock::RtcSwingPpm = game.swingPpm;
+	SimulatedClock::PpsPresent = false;
+	SimulatedClock::Advance(5e6);
+	SimulatedClock::SetRtc(SimulatedClock::UtcNow() - 12, 0.5); // Set by hand.
+	if (game.calibrated)
+	{
+		Temporal::SetCurrentTime(SimulatedClock::UtcNow());
+		Temporal::model.DriftCentiPpm = 1270;
+		Temporal::model.DriftUncertaintyCentiPpm = CALIBRATION_SAMPLED_DRIFT_CENTIPPM;
+		Temporal::model.ReferenceUncertaintyMs = CLOCK_PPS_ANCHOR_UNCERTAINTY_MS;
+		Temporal::SaveModel();
+		Restart();
+	}
+	SimulatedClock::WindowOpen = SimulatedClock::UTC_START + 20 * 86400 + 3600;
+	SimulatedClock::WindowClose = SimulatedClock::WindowOpen + 120;
+	SimulatedClock::GameStart = SimulatedClock::WindowOpen - 86400;
+
+	double worstError = 0;
+	double worstRawError = 0;
+	uint32_t worstBound = 0;
+	int outside = 0;
+	int refusedOpen = 0;
+	int eepromWrites = 0;
+	uint16_t lastCrc = Temporal::model.Crc;
+	for (int minute = 0; minute < GAME_DAYS * 24 * 60; minute++)
+	{
+		bool gps = (minute / 60) % game.gpsEveryHours == 0 && minute % 60 < game.gpsSessionMinutes;
+		if (minute == 24 * 60 + 5)
+		{
+			Restart();
+		}
+		for (int second = 0; second < 60; second += 10)
+		{
+			SimulatedClock::Advance(10e6);
+			if (gps)
+			{
+				Temporal::AnchorToGps(SimulatedClock::UtcNow() - (rand() % 2));
+			}
+			if (Temporal::model.Crc != lastCrc)
+			{
+				eepromWrites++;
+				lastCrc = Temporal::model.Crc;
+			}
+			time_t utc = SimulatedClock::UtcNow();
+			if (utc >= SimulatedClock::WindowOpen && utc < SimulatedClock::WindowClose && (!Temporal::HasWindowOpened() || Temporal::HasWindowExpired()))
+			{
+				refusedOpen++;
+			}
+		}
+		Temporal::Resync();
+		double error = (double)Temporal::Now() - (SimulatedClock::UTC_START + SimulatedClock::TrueMicros / 1e6);
+		uint32_t bound = Temporal::GetUncertaintySeconds();
+		outside += fabs(error) > bound + 1;
+		worstError = max(worstError, fabs(error));
+		worstBound = max(worstBound, bound);
+		worstRawError = max(worstRawError, fabs((double)RTC.get() - (SimulatedClock::UTC_START + SimulatedClock::TrueMicros / 1e6)));
+	}
+
+	double driftError = Temporal::model.DriftCentiPpm / 100.0 - game.meanPpm;
+	printf("  %s: RTC out by up to %.0f s, model by %.1f s within a bound of up to %u s, drift %+.2f ppm (+-%.2f), %d saves, %d outside the bound, %d refused open\n",
+		game.name, worstRawError, worstError, worstBound, Temporal::model.DriftCentiPpm / 100.0,
+		Temporal::model.DriftUncertaintyCentiPpm / 100.0, eepromWrites, outside, refusedOpen);
+	bool converges = game.gpsEveryHours > GAME_DAYS * 24
+		|| (Temporal::model.DriftUncertaintyCentiPpm <= 1000 && fabs(driftError) <= Temporal::model.DriftUncertaintyCentiPpm / 100.0 + game.swingPpm);
+	Expect(game.name, outside == 0 && refusedOpen == 0 && converges);
+}
+
+// A unit anchored by a week of daily fixes, whose RTC read then fails during a fix.
+static void CheckFailedRead()
+{
+	SimulatedClock::Reset();
+	Restart();
+	Temporal::anchorTime = 0;
+	SimulatedClock::RtcPpm = 40;
+	SimulatedClock::PpsPresent = false;
+	for (int day = 0; day < 7; day++)
+	{
+		Temporal::anchorChecked = false;
+		Temporal::AnchorToGps(SimulatedClock::UtcNow());
+		SimulatedClock::Advance(86400e6);
+	}
+	ClockModel before = Temporal::model;
+	time_t anchorBefore = Temporal::anchorTime;
+	int32_t anchorOffsetBefore = Temporal::anchorRtcOffset;
+
+	SimulatedClock::RtcFailing = true;
+	Temporal::anchorChecked = false;
+	Temporal::AnchorToGps(SimulatedClock::UtcNow());
+	Expect("a failed read leaves the model", memcmp(&before, &Temporal::model, sizeof(ClockModel)) == 0);
+	Expect("a failed read leaves the anchor", Temporal::anchorTime == anchorBefore && Temporal::anchorRtcOffset == anchorOffsetBefore);
+	Expect("a failed read is not corrected into a time", Temporal::GetDateTimeInUtc() == 0);
+
+	SimulatedClock::RtcFailing = false;
+	SimulatedClock::Advance(86400e6);
+	Temporal::anchorChecked = false;
+	Temporal::AnchorToGps(SimulatedClock::UtcNow());
+	Expect("the next good read carries on from it", fabs(Temporal::model.DriftCentiPpm / 100.0 - 40) < 3
+		&& fabs((double)Temporal::GetDateTimeInUtc() - SimulatedClock::UtcNow()) <= 1);
+}
+
+int main()
+{
+	srand(1);
+	static const GameCase games[] = {
+		{ "uncalibrated, +35 ppm, GPS every 3 days", 35, 0, 72, 60, false },
+		{ "uncalibrated, -60 ppm +-4 daily, GPS every 2 days", -60, 4, 48, 30, false },
+		{ "uncalibrated, +20 ppm, GPS once at the start", 20, 0, 100000, 30, false },
+		{ "calibrated +12.5 ppm, +-3 daily, GPS weekly", 12.5, 3, 168, 20, true },
+		{ "uncalibrated, -95 ppm, GPS daily", -95, 0, 24, 10, false },
+	};
+	for (const GameCase& game : games)
+	{
+		CheckGame(game);
+	}
+	CheckFailedRead();
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+// Host check of Setup's stored configuration record, through the shim's EEPROM.
+//   - Random configurations, from a few points in one park on one day to MAX_POINTS anywhere on earth years apart, must
+//     load back exactly as they were saved, or be refused as too large without touching what is stored;
+//   - MAX_POINTS points in one area on one day, as a game is usually set, must always fit;
+//   - saving the same configuration again must write nothing, and a shorter one must leave the cells past it zeroed;
+//   - any single bit flipped in a stored record must be refused at load, and a save cut short at any byte must load
+//     nothing, the old game if none of it was changed yet, or the new one once it is all written.
+#include <stdio.h>
+#include <stdlib.h>
+#define private public // To set and compare the configuration directly.
+#include "Setup.h"
+#undef private
+
+static const int CONFIGS = 2000;
+static const time_t EARLIEST = 1700000000; // November 2023.
+
+static int failures = 0;
+
+struct StoredConfig
+{
+	uint8_t numberOfPoints;
+	uint8_t currentPointIndex;
+	bool timeExtended;
+	time_t gameStart;
+	latLongLocation locations[MAX_POINTS];
+	time_t windowOpen[MAX_POINTS];
+	time_t windowClose[MAX_POINTS];
+};
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static int32_t Random(int32_t low, int32_t high)
+{
+	return low + (int32_t)(((uint32_t)rand() * 2654435761UL ^ (uint32_t)rand()) % (uint32_t)(high - low + 1));
+}
+
+// Near neighbours when local is set, otherwise anywhere.
+static StoredConfig RandomConfig(bool local, uint8_t pointCount)
+{
+	StoredConfig config;
+	config.numberOfPoints = pointCount;
+	config.currentPointIndex = Random(0, pointCount - 1);
+	config.timeExtended = rand() % 2;
+	config.gameStart = EARLIEST + Random(0, local ? 86400 * 365 : 0x7FFFFFFF - 86400 * 365);
+	int32_t latitude = Random(-900000000, 900000000);
+	int32_t longitude = Random(-1800000000, 1800000000);
+	time_t dateTime = config.gameStart;
+	for (uint8_t i = 0; i < pointCount; i++)
+	{
+		if (local)
+		{
+			latitude = constrain(latitude + Random(-50000, 50000), -900000000, 900000000); // About 5 km.
+			longitude = constrain(longitude + Random(-50000, 50000), -1800000000, 1800000000);
+			dateTime += Random(0, 3 * 3600);
+		}
+		else
+		{
+			latitude = Random(-900000000, 900000000);
+			longitude = Random(-1800000000, 1800000000);
+			dateTime += Random(0, 86400 * 365);
+		}
+		config.locations[i] = { latitude, longitude };
+		config.windowOpen[i] = dateTime;
+		dateTime += Random(60, local ? 3600 : 65535);
+		config.windowClose[i] = dateTime;
+	}
+	return config;
+}
+
+static void Apply(const StoredConfig& config)
+{
+	Setup::ZeroConfig();
+	Setup::numberOfPoints = config.numberOfPoints;
+	Setup::currentPointIndex = config.currentPointIndex;
+	Setup::timeExtended = config.timeExtended;
+	Setup::gameStartDateTime = config.gameStart;
+	for (uint8_t i = 0; i < config.numberOfPoints; i++)
+	{
+		Setup::singlePointConfigurationCollection[i].SetLocation(config.locations[i].latitude, config.locations[i].longitude);
+		Setup::singlePointConfigurationCollection[i].SetWindowOpenDateTime(config.windowOpen[i]);
+		Setup::singlePointConfigurationCollection[i].SetWindowCloseDateTime(config.windowClose[i]);
+	}
+}
+
+// Whether the configuration loaded is the one given.
+static bool Matches(const StoredConfig& config)
+{
+	bool same = Setup::numberOfPoints == config.numberOfPoints && Setup::currentPointIndex == config.currentPointIndex
+		&& Setup::timeExtended == config.timeExtended && Setup::gameStartDateTime == config.gameStart;
+	for (uint8_t i = 0; same && i < config.numberOfPoints; i++)
+	{
+		latLongLocation location = Setup::singlePointConfigurationCollection[i].GetLocation();
+		same = location.latitude == config.locations[i].latitude && location.longitude == config.locations[i].longitude
+			&& Setup::singlePointConfigurationCollection[i].GetWindowOpenDateTime() == config.windowOpen[i]
+			&& Setup::singlePointConfigurationCollection[i].GetWindowCloseDateTime() == config.windowClose[i];
+	}
+	return same;
+}
+
+// Loads from the EEPROM as at boot, from a cleared configuration.
+static bool Load()
+{
+	Setup::ZeroConfig();
+	return Setup::LoadConfigFromEEPROM();
+}
+
+static uint32_t TotalWrites()
+{
+	uint32_t total = 0;
+	for (int i = 0; i < EEPROMClass::SIZE; i++)
+	{
+		total += EEPROM.Writes[i];
+	}
+	return total;
+}
+
+static void CheckRoundTrips()
+{
+	int lost = 0;
+	int tooLarge = 0;
+	int localTooLarge = 0;
+	int clobbered = 0;
+	int largest = 0;
+	for (int n = 0; n < CONFIGS; n++)
+	{
+		bool local = n % 2 == 0;
+		StoredConfig config = RandomConfig(local, Random(1, MAX_POINTS));
+		uint8_t before[CONFIG_EEPROM_BYTES];
+		memcpy(before, EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, CONFIG_EEPROM_BYTES);
+		Apply(config);
+		if (!Setup::SaveConfigToEEPROM())
+		{
+			tooLarge++;
+			localTooLarge += local;
+			clobbered += memcmp(before, EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, CONFIG_EEPROM_BYTES) != 0;
+			continue;
+		}
+		largest = max(largest, 4 + EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + 1]);
+		lost += !Load() || !Matches(config);
+	}
+	printf("  %d random configurations: %d too large to store, the largest stored took %d of %d bytes\n", CONFIGS, tooLarge,
+		largest, CONFIG_EEPROM_BYTES);
+	Expect("every stored configuration loads back as it was", lost == 0);
+	Expect("local games always fit", localTooLarge == 0);
+	Expect("one too large leaves the stored one intact", clobbered == 0);
+
+	int full = 0;
+	for (int n = 0; n < 200; n++)
+	{
+		StoredConfig config = RandomConfig(true, MAX_POINTS);
+		Apply(config);
+		full += Setup::SaveConfigToEEPROM() && Load() && Matches(config);
+	}
+	Expect("MAX_POINTS local points always fit", full == 200);
+}
+
+static void CheckWear()
+{
+	StoredConfig longer = RandomConfig(false, 4);
+	StoredConfig shorter = RandomConfig(true, 1);
+	Apply(longer);
+	Setup::SaveConfigToEEPROM();
+	uint32_t writes = TotalWrites();
+	Apply(longer);
+	Setup::SaveConfigToEEPROM();
+	Expect("saving the same configuration again writes nothing", TotalWrites() == writes);
+
+	Apply(shorter);
+	Setup::SaveConfigToEEPROM();
+	uint8_t end = 4 + EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + 1];
+	bool tailZeroed = true;
+	for (uint8_t i = end; i < CONFIG_EEPROM_BYTES; i++)
+	{
+		tailZeroed &= EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + i] == 0;
+	}
+	Expect("a shorter configuration zeroes the rest of the longer", tailZeroed && Load() && Matches(shorter));
+}
+
+static void CheckCorruption()
+{
+	StoredConfig config = RandomConfig(true, MAX_POINTS);
+	Apply(config);
+	Setup::SaveConfigToEEPROM();
+	uint8_t length = 4 + EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + 1];
+	int accepted = 0;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + i] ^= 1 << bit;
+			accepted += Load();
+			EEPROM.Bytes[CONFIG_EEPROM_ADDRESS + i] ^= 1 << bit;
+		}
+	}
+	Expect("every single bit flip is refused", accepted == 0);
+
+	// The save is cut short after each byte in turn, over the old record or over an erased part.
+	int wrongGame = 0;
+	for (int erased = 0; erased < 2; erased++)
+	{
+		for (int cut = 0; cut < CONFIG_EEPROM_BYTES; cut++)
+		{
+			StoredConfig old = RandomConfig(true, Random(1, MAX_POINTS)); // Always stored.
+			StoredConfig next = RandomConfig(rand() % 2, Random(1, MAX_POINTS));
+			Apply(next);
+			uint8_t record[CONFIG_EEPROM_BYTES];
+			if (Setup::EncodeConfig(record) == 0)
+			{
+				continue;
+			}
+			if (erased)
+			{
+				memset(EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, 0xFF, CONFIG_EEPROM_BYTES);
+			}
+			else
+			{
+				Apply(old);
+				Setup::SaveConfigToEEPROM();
+			}
+			Apply(next);
+			Setup::SaveConfigToEEPROM();
+			uint8_t saved[CONFIG_EEPROM_BYTES];
+			memcpy(saved, EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, CONFIG_EEPROM_BYTES);
+			if (erased)
+			{
+				memset(EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, 0xFF, CONFIG_EEPROM_BYTES);
+			}
+			else
+			{
+				Apply(old);
+				Setup::SaveConfigToEEPROM();
+			}
+			memcpy(EEPROM.Bytes + CONFIG_EEPROM_ADDRESS, saved, cut);
+			// Once the whole record is written, the rest is only tidying.
+			bool complete = cut >= 4 + saved[1];
+			bool loaded = Load();
+			wrongGame += complete ? !(loaded && Matches(next)) : (loaded && !Matches(next) && (erased || !Matches(old)));
+		}
+	}
+	Expect("a save cut short loads nothing, the old game or the new", wrongGame == 0);
+}
+
+int main()
+{
+	srand(7);
+	memset(EEPROM.Bytes, 0xFF, sizeof(EEPROM.Bytes));
+	memset(EEPROM.Writes, 0, sizeof(EEPROM.Writes));
+	CheckRoundTrips();
+	CheckWear();
+	CheckCorruption();
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
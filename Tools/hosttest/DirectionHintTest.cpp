@@ -0,0 +1,76 @@
+// Host check of DirectionHint's warmer/colder trend on a walk: 40 m towards the target, a minute standing still, then 40 m
+// away, with a fix a second. Each fix has 2 m of slowly wandering error, as a real receiver's does, and 0.5 m of noise.
+// The trend must follow the walk on most fixes without flipping while the player stands still, and go back to unknown
+// when the target changes.
+#include <random>
+#include <stdio.h>
+#include "DirectionHint.h"
+
+static const double TARGET_LAT = -36.8485; // As in genlog.py.
+static const double UNITS_PER_M = 89.83; // 1e-7 degrees of latitude per meter.
+
+static int failures = 0;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+int main()
+{
+	std::mt19937 random(7);
+	std::normal_distribution<double> gaussian(0, 1);
+	latLongLocation target = { -368485000, 1747633000 };
+	double biasNorth = 0;
+	double biasEast = 0;
+	double wander = exp(-1 / 30.0); // The error wanders with a time constant of 30 s.
+	int closerFixes = 0;
+	int warmerWhileCloser = 0;
+	int awayFixes = 0;
+	int colderWhileAway = 0;
+	int changesStanding = 0;
+	hintTrend previous = trendUnknown;
+	for (int second = 0; second < 180; second++)
+	{
+		double north = (second < 30) ? 80 - 1.3 * second : (second < 90) ? 41 : 41 + 1.3 * (second - 90);
+		biasNorth = wander * biasNorth + gaussian(random) * 2.0 * sqrt(1 - wander * wander);
+		biasEast = wander * biasEast + gaussian(random) * 2.0 * sqrt(1 - wander * wander);
+		latLongLocation here = { target.latitude + (int32_t)lround((north + biasNorth + gaussian(random) * 0.5) * UNITS_PER_M),
+			target.longitude + (int32_t)lround((biasEast + gaussian(random) * 0.5) * UNITS_PER_M / cos(TARGET_LAT * M_PI / 180)) };
+		DirectionHint::AddFix(here, target);
+		hintTrend trend = DirectionHint::GetTrend();
+		// The first few seconds of each part are left for the trend to catch up.
+		if (second >= 5 && second < 30)
+		{
+			closerFixes++;
+			warmerWhileCloser += (trend == trendWarmer);
+		}
+		if (second >= 95 && second < 120)
+		{
+			awayFixes++;
+			colderWhileAway += (trend == trendColder);
+		}
+		if (second >= 35 && second < 90 && trend != previous)
+		{
+			changesStanding++;
+		}
+		previous = trend;
+	}
+	printf("  warmer on %d/%d fixes walking closer, colder on %d/%d walking away, %d changes in a minute standing\n", warmerWhileCloser,
+		closerFixes, colderWhileAway, awayFixes, changesStanding);
+	Expect("warmer on most fixes walking closer", warmerWhileCloser >= closerFixes * 8 / 10);
+	Expect("colder on most fixes walking away", colderWhileAway >= awayFixes * 8 / 10);
+	Expect("at most two changes standing still", changesStanding <= 2);
+
+	latLongLocation next = { target.latitude + 1000, target.longitude };
+	latLongLocation here = { target.latitude + 5000, target.longitude };
+	DirectionHint::AddFix(here, next);
+	Expect("a new target starts the trend again", DirectionHint::GetTrend() == trendUnknown);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
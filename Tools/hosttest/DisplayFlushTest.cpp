@@ -0,0 +1,191 @@
+// Host check of Display's shadow frame, through the real LiquidCrystal_I2C and I2CIO on the shim's Wire, which counts the
+// bytes sent. LcdModel reads the bytes back into what the LCD would show.
+//   - After every message and every clear, the LCD must show the frame;
+//   - drawing what is already shown must send nothing, not even an empty transmission, whether it is the same message
+//     again or the distance page refreshed with nothing changed;
+//   - a count that changes by one digit must send one cursor move and one character;
+//   - the message set must take fewer bytes than the original Display, which cleared both lines and rewrote both for every
+//     message, one I2C transmission per byte.
+#include <stdio.h>
+#include <Arduino.h>
+#include <Wire.h>
+#define private public // To redraw pages directly, and to compare the frame with the LCD.
+#include "Display.h"
+#undef private
+#include "LcdModel.h"
+
+static int failures = 0;
+
+// Every message's slots filled, with values that fit.
+static const uint32_t VALUES[3] = { 12, 7, 45 };
+
+static uint32_t distanceMeters = 250;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static uint32_t Distance()
+{
+	return distanceMeters;
+}
+
+static directionHint Hint()
+{
+	directionHint hint = { 4500, trendWarmer };
+	return hint;
+}
+
+static bool ShowsFrame()
+{
+	LcdModel::Update();
+	return LcdModel::Shows(Display::frame[0], Display::frame[1]);
+}
+
+// The original Display: a clear was both lines written over with spaces, and a message was a clear and then both lines,
+// each printed without its trailing spaces.
+static void OriginalPrint(uint8_t row, const char* text)
+{
+	uint8_t length = DISPLAY_COLUMNS;
+	while (length > 0 && text[length - 1] == ' ')
+	{
+		length--;
+	}
+	Display::lcd->setCursor(0, row);
+	for (uint8_t i = 0; i < length; i++)
+	{
+		Display::lcd->write(text[i]);
+	}
+}
+
+static void OriginalClear()
+{
+	static const char blank[] = "                ";
+	Display::lcd->setCursor(0, 0);
+	for (uint8_t i = 0; i < DISPLAY_COLUMNS; i++)
+	{
+		Display::lcd->write(blank[i]);
+	}
+	Display::lcd->setCursor(0, 1);
+	for (uint8_t i = 0; i < DISPLAY_COLUMNS; i++)
+	{
+		Display::lcd->write(blank[i]);
+	}
+}
+
+static void OriginalWrite(displayMessage message)
+{
+	Display::Compose(message, VALUES[0], VALUES[1], VALUES[2]);
+	OriginalClear();
+	OriginalPrint(0, Display::frame[0]);
+	OriginalPrint(1, Display::frame[1]);
+}
+
+static void CheckMessageSet()
+{
+	size_t start = Wire.SentCount;
+	int wrong = 0;
+	for (int message = 0; message < messageCount; message++)
+	{
+		Display::Write((displayMessage)message, VALUES[0], VALUES[1], VALUES[2]);
+		wrong += !ShowsFrame();
+		Display::Clear();
+		wrong += !ShowsFrame();
+	}
+	size_t flushed = Wire.SentCount - start;
+	Expect("the LCD shows every message and clear", wrong == 0);
+
+	start = Wire.SentCount;
+	uint32_t transmissions = Wire.Transmissions;
+	for (int message = 0; message < messageCount; message++)
+	{
+		OriginalWrite((displayMessage)message);
+		OriginalClear();
+	}
+	size_t original = Wire.SentCount - start;
+	printf("  %d messages, each then cleared: %u bytes, originally %u bytes in %u transmissions\n", (int)messageCount,
+		(unsigned)flushed, (unsigned)original, Wire.Transmissions - transmissions);
+	// The original path left the LCD blank, as Display last drew it.
+	Expect("the message set takes fewer bytes than the original", flushed < original);
+}
+
+// What drawing sends: bytes, transmissions, and the commands and characters the LCD takes in.
+struct Sent
+{
+	size_t Bytes;
+	uint32_t Transmissions;
+	uint32_t Commands;
+	uint32_t Characters;
+};
+
+static Sent Before()
+{
+	LcdModel::Update();
+	Sent sent = { Wire.SentCount, Wire.Transmissions, LcdModel::Commands, LcdModel::Characters };
+	return sent;
+}
+
+static Sent Since(const Sent& before)
+{
+	LcdModel::Update();
+	Sent sent = { Wire.SentCount - before.Bytes, Wire.Transmissions - before.Transmissions, LcdModel::Commands - before.Commands,
+		LcdModel::Characters - before.Characters };
+	return sent;
+}
+
+static void CheckRedraws()
+{
+	int sentSomething = 0;
+	for (int message = 0; message < messageCount; message++)
+	{
+		Display::Write((displayMessage)message, VALUES[0], VALUES[1], VALUES[2]);
+		Sent before = Before();
+		Display::Write((displayMessage)message, VALUES[0], VALUES[1], VALUES[2]);
+		Sent again = Since(before);
+		sentSomething += again.Bytes != 0 || again.Transmissions != 0;
+	}
+	Expect("the same message again sends nothing", sentSomething == 0);
+
+	Display::distanceSource = Distance;
+	Display::hintSource = Hint;
+	Display::RefreshDistancePage();
+	Sent before = Before();
+	Display::RefreshDistancePage();
+	Sent unchanged = Since(before);
+	Expect("an unchanged distance page sends nothing", unchanged.Bytes == 0 && unchanged.Transmissions == 0);
+
+	distanceMeters = 251;
+	before = Before();
+	Display::RefreshDistancePage();
+	Sent oneDigit = Since(before);
+	printf("  distance 250 to 251 m: %u bytes in %u transmission, %u command, %u character\n", (unsigned)oneDigit.Bytes,
+		oneDigit.Transmissions, oneDigit.Commands, oneDigit.Characters);
+	Expect("one digit of the distance sends one move and one character", oneDigit.Transmissions == 1 && oneDigit.Commands == 1
+		&& oneDigit.Characters == 1 && ShowsFrame());
+
+	Display::WriteTimeExtensionValues(1, 15);
+	before = Before();
+	Display::WriteTimeExtensionValues(1, 16);
+	oneDigit = Since(before);
+	Expect("one digit of an extension sends one move and one character", oneDigit.Commands == 1 && oneDigit.Characters == 1
+		&& ShowsFrame());
+}
+
+int main()
+{
+	Wire.Acknowledge = true;
+	LcdModel::Reset();
+	Display::Initialize();
+	Expect("the LCD starts blank", ShowsFrame() && LcdModel::Shows("                ", "                "));
+	CheckMessageSet();
+	CheckRedraws();
+	Expect("nothing is written outside a transmission", Wire.WritesOutside == 0);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+// Host check of Display's flash message catalog and every page drawn from it, through the real LCD library on the shim's
+// Wire, with LcdModel reading back what the LCD holds.
+//   - Each entry must be exactly two rows of 16 printable characters, with its slots inside a row, over blanks, and
+//     clear of the text on either side;
+//   - each entry drawn with its numbers at 0, 1, the widest that fits, one more than that, and the largest uint32_t must
+//     show its text unchanged and each number right aligned in its slot, or all nines if it doesn't fit;
+//   - every public page at the extremes of its arguments, including a drift of -32768, must show only printable
+//     characters within 16x2, and leave the LCD's cells past the 16th column blank.
+#include <stdio.h>
+#include <Arduino.h>
+#include <Wire.h>
+#define private public // To read the catalog, and to compare the frame with the LCD.
+#include "Display.h"
+#undef private
+#include "LcdModel.h"
+
+static int failures = 0;
+
+static uint32_t distanceMeters = 0;
+static directionHint hintGiven = { 0, trendUnknown };
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static uint32_t Distance()
+{
+	return distanceMeters;
+}
+
+static directionHint Hint()
+{
+	return hintGiven;
+}
+
+static bool Printable(const char* text, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		if (text[i] < ' ' || text[i] > '~')
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// What the LCD shows is the frame, printable, and nothing past the 16th column.
+static bool ShowsFrameWithin16x2()
+{
+	LcdModel::Update();
+	return Printable(&Display::frame[0][0], sizeof(Display::frame)) && LcdModel::Shows(Display::frame[0], Display::frame[1])
+		&& LcdModel::OffScreenBlank();
+}
+
+static uint32_t PowerOfTen(uint8_t exponent)
+{
+	uint32_t value = 1;
+	while (exponent--)
+	{
+		value *= 10;
+	}
+	return value;
+}
+
+static void CheckCatalog()
+{
+	int badText = 0;
+	int badSlots = 0;
+	for (int message = 0; message < messageCount; message++)
+	{
+		const DisplayMessage& entry = Display::messages[message];
+		badText += strlen(entry.Text) != DISPLAY_ROWS * DISPLAY_COLUMNS || !Printable(entry.Text, strlen(entry.Text));
+		bool covered[DISPLAY_ROWS * DISPLAY_COLUMNS] = {};
+		for (uint8_t i = 0; i < DISPLAY_MAX_SLOTS; i++)
+		{
+			const MessageSlot& slot = entry.Slots[i];
+			if (slot.Width == 0)
+			{
+				continue;
+			}
+			if (slot.Row >= DISPLAY_ROWS || slot.Column + slot.Width > DISPLAY_COLUMNS || slot.Fill < ' ' || slot.Fill > '~')
+			{
+				badSlots++;
+				continue;
+			}
+			const char* row = &entry.Text[slot.Row * DISPLAY_COLUMNS];
+			for (uint8_t column = slot.Column; column < slot.Column + slot.Width; column++)
+			{
+				badSlots += row[column] != ' ' || covered[slot.Row * DISPLAY_COLUMNS + column];
+				covered[slot.Row * DISPLAY_COLUMNS + column] = true;
+			}
+			// A number can fill its slot, so the text either side must be a blank away.
+			uint8_t after = slot.Column + slot.Width;
+			badSlots += (slot.Column > 0 && row[slot.Column - 1] != ' ') || (after < DISPLAY_COLUMNS && row[after] != ' ');
+		}
+	}
+	Expect("each entry is two rows of 16 printable characters", badText == 0);
+	Expect("each slot is within a row, over blanks, clear of the text", badSlots == 0);
+}
+
+static void CheckRendering()
+{
+	int wrong = 0;
+	int notShown = 0;
+	for (int message = 0; message < messageCount; message++)
+	{
+		const DisplayMessage& entry = Display::messages[message];
+		for (int trial = 0; trial < 5; trial++)
+		{
+			uint32_t values[DISPLAY_MAX_SLOTS];
+			char expected[DISPLAY_ROWS * DISPLAY_COLUMNS + 1];
+			memcpy(expected, entry.Text, sizeof(expected));
+			for (uint8_t i = 0; i < DISPLAY_MAX_SLOTS; i++)
+			{
+				const MessageSlot& slot = entry.Slots[i];
+				uint32_t widest = slot.Width < 10 ? PowerOfTen(slot.Width) - 1 : 0xFFFFFFFF;
+				static const uint32_t overflow[] = { 0, 1, 0, 0, 0xFFFFFFFF };
+				values[i] = (trial == 2) ? widest : (trial == 3) ? widest + 1 : overflow[trial];
+				if (slot.Width == 0)
+				{
+					continue;
+				}
+				char number[16];
+				if (slot.Width < 10 && values[i] > widest)
+				{
+					memset(number, '9', slot.Width);
+				}
+				else
+				{
+					snprintf(number, sizeof(number), "%*u", slot.Width, (unsigned)values[i]);
+					for (char* cell = number; *cell == ' '; cell++)
+					{
+						*cell = slot.Fill;
+					}
+				}
+				memcpy(&expected[slot.Row * DISPLAY_COLUMNS + slot.Column], number, slot.Width);
+			}
+			Display::Write((displayMessage)message, values[0], values[1], values[2]);
+			wrong += memcmp(Display::frame, expected, sizeof(Display::frame)) != 0;
+			notShown += !ShowsFrameWithin16x2();
+		}
+	}
+	printf("  %d entries, %u bytes of flash\n", (int)messageCount, (unsigned)sizeof(Display::messages));
+	Expect("each entry draws its text and numbers as expected", wrong == 0);
+	Expect("each entry drawn fits 16x2 on the LCD", notShown == 0);
+}
+
+// Draws a page, then whatever follows it once the hold is over, checking each.
+static bool ShowsPageAndNext(const char* name, void (*draw)())
+{
+	draw();
+	bool ok = ShowsFrameWithin16x2();
+	while (Display::IsBusy())
+	{
+		hostAdvanceMicros(DISPLAY_REFRESH_MS * 1000UL);
+		Display::Update();
+		ok &= ShowsFrameWithin16x2();
+	}
+	if (!ok)
+	{
+		printf("  %s: |%.16s|%.16s|\n", name, Display::frame[0], Display::frame[1]);
+	}
+	return ok;
+}
+
+static void CheckPages()
+{
+	int bad = 0;
+	bad += !ShowsPageAndNext("search begins in", [] { Display::WriteSearchBeginsIn(255, 255, 255); });
+	bad += !ShowsPageAndNext("less than a minute", [] { Display::WriteSearchBeginsIn(0, 0, 0); });
+	bad += !ShowsPageAndNext("window starts in", [] { Display::WriteTimeToUnlock(255, 23, 59); });
+	bad += !ShowsPageAndNext("window lasts for", [] { Display::WriteUnlockTimeRemaining(255, 255, 255); });
+	bad += !ShowsPageAndNext("stage complete", [] { Display::WriteStageXOfYComplete(255, 255); });
+	bad += !ShowsPageAndNext("rtc off by", [] { Display::WriteRTCOffBy(0xFFFFFFFF); });
+	bad += !ShowsPageAndNext("extension", [] { Display::WriteTimeExtensionValues(255, 255); });
+	bad += !ShowsPageAndNext("passcode", [] {
+		Display::WriteEnterPasscode();
+		for (uint8_t dots = 0; dots <= DISPLAY_COLUMNS + 1; dots++)
+		{
+			Display::CharTyped(dots);
+		}
+	});
+	Display::distanceSource = Distance;
+	Display::hintSource = Hint;
+	for (uint32_t bearing = 0; bearing < 36000; bearing += 500)
+	{
+		distanceMeters = (bearing % 1000 == 0) ? 0xFFFFFFFF : bearing;
+		hintGiven.bearing = bearing;
+		hintGiven.trend = (hintTrend)(bearing / 500 % 3);
+		bad += !ShowsPageAndNext("distance", [] { Display::WriteDistanceRemaining(Distance, Hint); });
+	}
+	Expect("every page at its extremes fits 16x2", bad == 0);
+
+	static const int16_t drifts[] = { -32768, -32767, -1, 0, 1, 32767 };
+	int wrongDrift = 0;
+	for (int16_t drift : drifts)
+	{
+		Display::WriteRtcDrift(drift);
+		bool slow = memcmp(Display::frame[0], "RTC runs slow by", DISPLAY_COLUMNS) == 0;
+		// Over 327 ppm is more than 9999 ms a day, so the extremes show all nines.
+		bool nines = memcmp(Display::frame[1], "9999", 4) == 0;
+		wrongDrift += !ShowsFrameWithin16x2() || slow != (drift < 0) || nines != (drift <= -32767 || drift == 32767);
+	}
+	Expect("drifts out to -32768 show within their slot", wrongDrift == 0);
+}
+
+int main()
+{
+	hostManualClock = true;
+	Wire.Acknowledge = true;
+	LcdModel::Reset();
+	Display::Initialize();
+	CheckCatalog();
+	CheckRendering();
+	CheckPages();
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+// Two-thread check of the NMEAGPS fix FIFO with NMEAGPS_INTERRUPT_PROCESSING: one thread plays the receive ISR, feeding
+// GGA+RMC pairs to handle(), while the other calls read() the way the sketch's loop does. Each second's sentences carry the
+// second in both the time and the latitude, so a fix copied while the parser was still writing it shows up as a mismatch.
+//
+// The FIFO only has a compiler barrier, which is enough on a single-core AVR. On the host that also relies on x86's store
+// ordering, so run this on an x86 machine.
+#include <atomic>
+#include <string>
+#include <thread>
+#include <stdio.h>
+#include <NMEAGPS.h>
+
+#ifndef NMEAGPS_INTERRUPT_PROCESSING
+#error Build with -DNMEAGPS_INTERRUPT_PROCESSING
+#endif
+
+static NMEAGPS gps;
+static std::atomic<bool> producerDone(false);
+
+static const uint32_t SECONDS = 100000;
+static const uint32_t SECONDS_PER_DAY = 86400;
+
+static std::string Sentence(const char* body)
+{
+	uint8_t check = 0;
+	for (const char* p = body; *p; p++)
+	{
+		check ^= *p;
+	}
+	char line[128];
+	snprintf(line, sizeof(line), "$%s*%02X\r\n", body, check);
+	return line;
+}
+
+// The latitude for second s of the day, in 1e-7 degrees: 10 degrees plus s/10000 minutes.
+static int32_t LatitudeFor(uint32_t secondOfDay)
+{
+	return 100000000L + (int32_t)((secondOfDay / 10000.0 / 60.0) * 1e7 + 0.5);
+}
+
+static std::string SecondOfLog(uint32_t second)
+{
+	uint32_t s = second % SECONDS_PER_DAY;
+	char time[16];
+	char latitude[16];
+	char body[120];
+	snprintf(time, sizeof(time), "%02u%02u%02u.00", s / 3600, (s / 60) % 60, s % 60);
+	snprintf(latitude, sizeof(latitude), "10%08.5f", s / 10000.0);
+	snprintf(body, sizeof(body), "GPGGA,%s,%s,N,17445.79681,E,1,08,0.9,10.0,M,0.0,M,,", time, latitude);
+	std::string pair = Sentence(body);
+	snprintf(body, sizeof(body), "GPRMC,%s,A,%s,N,17445.79681,E,0.01,0.0,010130,,,A", time, latitude);
+	return pair + Sentence(body);
+}
+
+static void Spin(uint32_t count)
+{
+	for (volatile uint32_t i = 0; i < count; i++)
+	{
+	}
+}
+
+int main()
+{
+	uint32_t completed = 0;
+	std::thread producer([&]
+	{
+		uint32_t seed = 1;
+		for (uint32_t second = 0; second < SECONDS; second++)
+		{
+			std::string pair = SecondOfLog(second);
+			for (char c : pair)
+			{
+				if (gps.handle((uint8_t)c) == NMEAGPS::DECODE_COMPLETED && gps.nmeaMessage == LAST_SENTENCE_IN_INTERVAL)
+				{
+					completed++;
+				}
+				seed = seed * 1103515245 + 12345;
+				Spin((seed >> 16) & 63); // Characters arrive unevenly.
+				if (((seed >> 22) & 31) == 0)
+				{
+					std::this_thread::yield(); // Lets the reader in part way through a sentence, even on a single core.
+				}
+			}
+		}
+		producerDone = true;
+	});
+
+	uint32_t read = 0;
+	uint32_t torn = 0;
+	uint32_t outOfOrder = 0;
+	int32_t lastSecond = -1;
+	std::thread consumer([&]
+	{
+		uint32_t seed = 7;
+		while (!producerDone || gps.available())
+		{
+			if (!gps.available())
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			gps_fix fix = gps.read();
+			read++;
+			uint32_t secondOfDay = fix.dateTime.hours * 3600UL + fix.dateTime.minutes * 60 + fix.dateTime.seconds;
+			if (!fix.valid.time || !fix.valid.location || abs(fix.location.lat() - LatitudeFor(secondOfDay)) > 1)
+			{
+				torn++;
+			}
+			int32_t second = secondOfDay;
+			if (lastSecond >= 0 && second <= lastSecond && lastSecond - second < (int32_t)SECONDS_PER_DAY / 2) // Allow for midnight.
+			{
+				outOfOrder++;
+			}
+			lastSecond = second;
+			seed = seed * 1103515245 + 12345;
+			Spin(((seed >> 16) & 63) ? 0 : 20000); // Now and then the loop is slow enough for the FIFO to fill.
+		}
+	});
+
+	producer.join();
+	consumer.join();
+
+	uint16_t overruns = gps.overruns(); // 16 bits, so compare modulo 65536.
+	printf("completed %u, read %u, overruns %u, torn %u, out of order %u\n", completed, read, overruns, torn, outOfOrder);
+	bool ok = ((uint16_t)(completed - read) == overruns) && torn == 0 && outOfOrder == 0 && read != 0 && overruns != 0;
+	printf("%s\n", ok ? "ok" : "FAIL");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// Host check of Physical's fix quality policy. Synthetic 1 Hz GGA+RMC streams are fed through the GPS receive ISR and
+// ReadFix, as the sketch's loop calls it, on a clock that only moves a second per fix. Each case checks which fixes the
+// policy lets through and that rejected ones never reach the position estimator.
+#include <string>
+#include <stdio.h>
+#define private public // The cases reset Physical's settle state and call its ISR directly.
+#include "Physical.h"
+#undef private
+
+static int failures = 0;
+static int streamSecond = 0;
+
+static std::string Sentence(const char* body)
+{
+	uint8_t check = 0;
+	for (const char* p = body; *p; p++)
+	{
+		check ^= *p;
+	}
+	char line[128];
+	snprintf(line, sizeof(line), "$%s*%02X\r\n", body, check);
+	return line;
+}
+
+// Sends one second of sentences and returns what ReadFix does. A quality below 0 leaves out the GGA, and rmcStatus is 'A'
+// or 'V'. A void RMC without a GGA has no position at all.
+static bool Feed(int quality, int satellites, double hdop, char rmcStatus = 'A')
+{
+	char time[16];
+	char body[112];
+	snprintf(time, sizeof(time), "%02d%02d%02d.00", (streamSecond / 3600) % 24, (streamSecond / 60) % 60, streamSecond % 60);
+	std::string sentences;
+	if (quality >= 0)
+	{
+		snprintf(body, sizeof(body), "GPGGA,%s,3650.90751,S,17445.79681,E,%d,%02d,%.2f,30.0,M,0.0,M,,", time, quality, satellites, hdop);
+		sentences += Sentence(body);
+	}
+	if (rmcStatus == 'V' && quality < 0)
+	{
+		snprintf(body, sizeof(body), "GPRMC,%s,V,,,,,,,010130,,,N", time);
+	}
+	else
+	{
+		snprintf(body, sizeof(body), "GPRMC,%s,%c,3650.90751,S,17445.79681,E,0.01,0.0,010130,,,A", time, rmcStatus);
+	}
+	sentences += Sentence(body);
+	for (char c : sentences)
+	{
+		Physical::GpsIsr(c);
+	}
+	streamSecond++;
+	hostAdvanceMicros(1000000);
+	return Physical::ReadFix();
+}
+
+static void Reset(const FixQualityPolicy& policy)
+{
+	Physical::SetFixQualityPolicy(policy);
+	Physical::settleStarted = false;
+	Physical::settled = false;
+	Physical::acceptedFixes = 0;
+	Physical::rejectedFixes = 0;
+	Physical::fix.init();
+	PositionEstimator::Reset();
+}
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+int main()
+{
+	hostManualClock = true;
+	FixQualityPolicy standard = { FIX_MIN_SATELLITES, FIX_MAX_HDOP, FIX_MIN_STATUS, FIX_SETTLE_MS };
+
+	// Cold start: 20 s of 3 satellites at HDOP 9, then a good sky. Nothing is accepted until 10 s after the first good fix.
+	Reset(standard);
+	int firstAccepted = -1;
+	for (int i = 0; i < 60; i++)
+	{
+		bool good = (i >= 20);
+		if (Feed(1, good ? 7 : 3, good ? 1.2 : 9.0) && firstAccepted < 0)
+		{
+			firstAccepted = i;
+		}
+	}
+	printf("  cold start: first accepted at %d s, accepted %u rejected %u, estimator saw %u\n", firstAccepted,
+		Physical::GetAcceptedFixCount(), Physical::GetRejectedFixCount(), PositionEstimator::fixesSinceReset);
+	Expect("cold start waits for the sky and the settle time", firstAccepted == 30);
+	Expect("cold start counts", Physical::GetAcceptedFixCount() == 30 && Physical::GetRejectedFixCount() == 30);
+	Expect("rejected fixes never reach the estimator", PositionEstimator::fixesSinceReset == Physical::GetAcceptedFixCount());
+
+	// After settling, single bad fixes are dropped but the good ones around them still come through.
+	bool fewSatellites = Feed(1, 4, 1.0);
+	bool overHdop = Feed(1, 8, 4.5);
+	bool atHdop = Feed(1, 8, 4.0);
+	bool goodAgain = Feed(1, 8, 1.0);
+	Expect("too few satellites rejected", !fewSatellites);
+	Expect("HDOP over the limit rejected", !overHdop);
+	Expect("HDOP at the limit accepted", atHdop);
+	Expect("good fix after bad ones accepted", goodAgain);
+	Expect("the kept fix is the last good one", Physical::fix.satellites == 8 && Physical::fix.hdop == 1000);
+
+	// Quality 6 is a dead-reckoned estimate. NeoGPS keeps the better status of the GGA and RMC, so the RMC says void too.
+	// A missing GGA leaves satellites and HDOP unknown.
+	Expect("dead-reckoned fix rejected", !Feed(6, 8, 1.0, 'V'));
+	Expect("fix without GGA rejected", !Feed(-1, 0, 0));
+	Expect("no-fix GGA with a void RMC rejected", !Feed(0, 0, 99.9, 'V'));
+	uint16_t rejected = Physical::GetRejectedFixCount();
+	Expect("30 from the cold start and 5 since", rejected == 35);
+
+	// Sentences without a position aren't fixes, so they count as neither.
+	Feed(-1, 0, 0, 'V');
+	Expect("position-less RMC not counted", Physical::GetRejectedFixCount() == rejected);
+
+	// A policy of zeros accepts anything with a location and time, straight away.
+	FixQualityPolicy open = { 0, 0, gps_fix::STATUS_NONE, 0 };
+	Reset(open);
+	Expect("open policy accepts a 3 satellite fix", Feed(1, 3, 9.0));
+	Expect("open policy accepts a fix without GGA", Feed(-1, 0, 0));
+
+	// The settle time doesn't start until a fix passes the other checks, and isn't needed again once served.
+	Reset(standard);
+	int accepted = 0;
+	for (int i = 0; i < 15; i++)
+	{
+		accepted += Feed(1, 4, 1.0);
+	}
+	Expect("no settle progress on rejected fixes", accepted == 0 && !Physical::settleStarted);
+	for (int i = 0; i < 11; i++)
+	{
+		accepted += Feed(1, 6, 1.0);
+	}
+	Expect("settle runs from the first passing fix", accepted == 1);
+	for (int i = 0; i < 20; i++)
+	{
+		Feed(1, 3, 1.0);
+	}
+	Expect("settle is not repeated after an outage", Feed(1, 6, 1.0));
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+// Host check of the sketch's GameTask state machine, from checkingTime through to poweringDown. The sketch itself is
+// compiled in, with the lockbox's modules replaced by the stubs below, so each case sets what the RTC, the GPS, the keys
+// and the display report and records the messages written and the phases passed through. Covers the game not started,
+// the window already expired, fixes that never come or stop coming, and inside or outside with the window open or not,
+// on the final point or not. While a message is held, IsBusy is true for the next two polls, and the messages GameTask
+// shows in turn must wait for it; only a decision may replace one early.
+#include <stdio.h>
+#include <string>
+
+// The prototypes the Arduino IDE generates for the sketch.
+void setup();
+void loop();
+void RunNormal();
+void GpsTask();
+void DisplayTask();
+void InputTask();
+void RtcTask();
+void GameTask();
+uint32_t DistanceToCurrentPoint();
+struct directionHint HintToCurrentPoint();
+void RunOverride();
+void RunExtraTime();
+void RunCalibrateRTC();
+void RunConfigureUnit();
+void Lock(bool lock);
+void TooLate();
+void Die();
+void PowerDown();
+
+#include "ArduinoGPSTimedLockBox.ino"
+
+static const int MAX_STEPS = 200;
+static const int NEVER = -1;
+
+struct GameCase
+{
+	const char* name;
+	bool gameStarted;
+	int windowExpiresAt; // The step at which HasWindowExpired becomes true.
+	bool windowOpen;
+	bool finalPoint;
+	const char* decisions; // One per fix: p(ending), I(nside) or O(utside). The last repeats.
+	int fixesStopAt; // Fixes arrive every step until this one.
+	int fixTimesOutAt;
+	int keyTurnedAt;
+	const char* expected;
+};
+
+static int failures = 0;
+
+static std::string events;
+static int step = 0;
+static const GameCase* current;
+static const char* nextDecision;
+static int busyPolls = 0;
+static int writtenWhileBusy = 0;
+static int decisionsAsked = 0;
+
+static const char* phaseNames[] = { "inactive", "checkingTime", "awaitingFix", "showingTimeToUnlock", "showingWindowRemaining",
+	"showingStageComplete", "showingNextStage", "awaitingKeys", "sayingGoodbye", "poweringDown", "finished" };
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+// Repeats of the same event, such as the key prompt redrawn while waiting, are recorded once.
+static void Event(const std::string& name)
+{
+	size_t last = events.rfind(' ');
+	if (events.compare(last == std::string::npos ? 0 : last + 1, std::string::npos, name) == 0)
+	{
+		return;
+	}
+	if (!events.empty())
+	{
+		events += ' ';
+	}
+	events += name;
+}
+
+// A message written straight away, as a decision or a new phase does.
+static void Show(const char* name)
+{
+	Event(name);
+	busyPolls = 2;
+}
+
+// A message GameTask only writes once the one before has been held long enough.
+static void ShowAfter(const char* name)
+{
+	writtenWhileBusy += busyPolls > 0;
+	Show(name);
+}
+
+Display::Display() {}
+void Display::Initialize() {}
+void Display::Update() {}
+void Display::Wait() {}
+bool Display::IsBusy()
+{
+	if (busyPolls > 0)
+	{
+		busyPolls--;
+		return true;
+	}
+	return false;
+}
+void Display::WriteSearchBeginsIn(uint8_t, uint8_t, uint8_t) { Show("SearchBeginsIn"); }
+void Display::WriteTooLate() { Show("TooLate"); }
+void Display::WriteObtainingGPSLocationFix() { Show("ObtainingFix"); }
+void Display::WriteLocationReached() { Show("LocationReached"); }
+void Display::WriteDistanceRemaining(uint32_t (*)(), directionHint (*)()) { Show("DistanceRemaining"); }
+void Display::WriteNoGpsFix() { Show("NoGpsFix"); }
+void Display::WriteConfigInvalid() { Show("ConfigInvalid"); }
+void Display::WriteTimeToUnlock(uint8_t, uint8_t, uint8_t) { ShowAfter("TimeToUnlock"); }
+void Display::WriteUnlockTimeRemaining(uint8_t, uint8_t, uint8_t) { ShowAfter("UnlockTimeRemaining"); }
+void Display::WriteStageXOfYComplete(uint8_t, uint8_t) { ShowAfter("StageComplete"); }
+void Display::WriteNextStageBeginsNow() { ShowAfter("NextStageBeginsNow"); }
+void Display::WriteInsertBothKeys() { ShowAfter("InsertBothKeys"); }
+void Display::WriteGoodbye() { ShowAfter("Goodbye"); }
+void Display::Clear() { ShowAfter("Clear"); }
+void Display::LcdOff() {}
+void Display::WriteAccessGranted() {}
+void Display::WriteAccessDenied() {}
+void Display::WriteTimeExtended() {}
+void Display::WriteCalibratingRTC() {}
+void Display::WriteRTCOffBy(uint32_t) {}
+void Display::WriteRtcDrift(int16_t) {}
+void Display::WriteSerialMode() {}
+
+bool UserInput::IsKeyStateUnlocked() { return current->keyTurnedAt != NEVER && step >= current->keyTurnedAt; }
+bool UserInput::ValidateCodeForStartupMode(startupMode) { return false; }
+uint32_t UserInput::GetExtraTimeValue() { return 0; }
+void UserInput::AwaitKeyLock() {}
+
+Physical::Physical() {}
+bool Physical::ReadFix() { return current->fixesStopAt == NEVER || step < current->fixesStopAt; }
+time_t Physical::GetFixDateTime() { return 0; }
+latLongLocation Physical::GetFixLocation() { latLongLocation location = { 0, 0 }; return location; }
+uint32_t Physical::GetDistanceFromPoint(latLongLocation) { return 0; }
+uint16_t Physical::GetBearingToPoint(latLongLocation) { return 0; }
+bool Physical::HasFixTimedOut() { return current->fixTimesOutAt != NEVER && step >= current->fixTimesOutAt; }
+uint16_t Physical::GetAcceptedFixCount() { return 0; }
+uint16_t Physical::GetRejectedFixCount() { return 0; }
+void Physical::RequestPowerSave() {}
+void Physical::SerialBegin() {}
+void Physical::SerialEnd() {}
+void Physical::PowerDown() { Event("PowerDown"); }
+time_t Physical::GetDateTimeInUtc() { return 0; }
+positionDecision Physical::DecideWithinRadius(latLongLocation)
+{
+	decisionsAsked++;
+	char decision = *nextDecision;
+	if (nextDecision[1] != '\0')
+	{
+		nextDecision++;
+	}
+	return (decision == 'I') ? decisionInside : (decision == 'O') ? decisionOutside : decisionPending;
+}
+
+Setup::Setup() {}
+bool Setup::LoadConfigFromEEPROM() { return true; }
+bool Setup::Initialize() { return false; }
+latLongLocation Setup::GetCurrentPointLocation() { latLongLocation location = { 0, 0 }; return location; }
+bool Setup::IsFinalPoint() { return current->finalPoint; }
+uint8_t Setup::GetCurrentPointNumber() { return 1; }
+uint8_t Setup::GetTotalPointCount() { return 2; }
+void Setup::ProgressToNextPoint() { Event("NextPoint"); }
+void Setup::ExtendTime(uint32_t, bool, bool) {}
+
+Temporal::Temporal() {}
+void Temporal::AnchorToGps(time_t) {}
+bool Temporal::IsGameStartReached() { return current->gameStarted; }
+bool Temporal::HasWindowOpened() { return current->windowOpen; }
+bool Temporal::HasWindowExpired() { return current->windowExpiresAt != NEVER && step >= current->windowExpiresAt; }
+TimeSpanDuration Temporal::GetTimeUntilGameStart() { TimeSpanDuration span; return span; }
+TimeSpanDuration Temporal::GetTimeUntilWindowOpens() { TimeSpanDuration span; return span; }
+TimeSpanDuration Temporal::GetTimeUntilWindowClose() { TimeSpanDuration span; return span; }
+bool Temporal::CalibrateFromGps(int32_t&) { return false; }
+int16_t Temporal::GetDriftCentiPpm() { return 0; }
+time_t Temporal::GetDateTimeInUtc() { return 0; }
+bool Temporal::SetCurrentTime(time_t) { return true; }
+
+void DirectionHint::AddFix(latLongLocation, latLongLocation) {}
+hintTrend DirectionHint::GetTrend() { return trendUnknown; }
+
+// Runs the tasks as the scheduler would, one pass a step, from checkingTime until the unit powers down.
+static void Run(const GameCase& game)
+{
+	current = &game;
+	nextDecision = game.decisions;
+	events.clear();
+	busyPolls = 0;
+	writtenWhileBusy = 0;
+	decisionsAsked = 0;
+	hostServoDegrees = 0;
+	long powerDowns = hostPowerDownCount;
+	phase = checkingTime;
+	fixReady = false;
+	windowExpired = false;
+	keyUnlocked = false;
+	for (step = 0; step < MAX_STEPS && phase != finished; step++)
+	{
+		GpsTask();
+		InputTask();
+		RtcTask();
+		gamePhase before = phase;
+		GameTask();
+		if (phase != before)
+		{
+			Event(std::string("[") + phaseNames[phase] + "]");
+		}
+	}
+	bool unlocked = hostServoDegrees == servoDegreesUnlock;
+	printf("  %s\n", events.c_str());
+	Expect(game.name, events == game.expected && writtenWhileBusy == 0 && hostPowerDownCount == powerDowns + 1
+		&& unlocked == (game.keyTurnedAt != NEVER));
+}
+
+int main()
+{
+	static const GameCase games[] = {
+		{ "before the game starts", false, NEVER, false, false, "p", NEVER, NEVER, NEVER,
+			"SearchBeginsIn [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "after the window has expired", true, 0, true, false, "p", NEVER, NEVER, NEVER,
+			"TooLate [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "no fix comes", true, NEVER, true, false, "p", 0, 5, NEVER,
+			"ObtainingFix [awaitingFix] NoGpsFix [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "fixes pending, then they stop and time out", true, NEVER, true, false, "p", 6, 12, NEVER,
+			"ObtainingFix [awaitingFix] NoGpsFix [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "inside before the window opens", true, NEVER, false, false, "ppI", NEVER, NEVER, NEVER,
+			"ObtainingFix [awaitingFix] LocationReached [showingTimeToUnlock] TimeToUnlock [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "outside before the window opens", true, NEVER, false, false, "pO", NEVER, NEVER, NEVER,
+			"ObtainingFix [awaitingFix] DistanceRemaining [showingTimeToUnlock] TimeToUnlock [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "outside while the window is open", true, NEVER, true, false, "O", NEVER, NEVER, NEVER,
+			"ObtainingFix [awaitingFix] DistanceRemaining [showingWindowRemaining] UnlockTimeRemaining [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "inside an open window, not the final point", true, NEVER, true, false, "pI", NEVER, NEVER, NEVER,
+			"ObtainingFix [awaitingFix] LocationReached [showingStageComplete] StageComplete [showingNextStage] NextStageBeginsNow NextPoint [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "inside an open window at the final point, keys turned", true, NEVER, true, true, "I", NEVER, NEVER, 30,
+			"ObtainingFix [awaitingFix] LocationReached [awaitingKeys] InsertBothKeys [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+		{ "waiting for the keys when the window expires", true, 30, true, true, "I", NEVER, NEVER, NEVER,
+			"ObtainingFix [awaitingFix] LocationReached [awaitingKeys] InsertBothKeys TooLate [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" },
+	};
+	for (const GameCase& game : games)
+	{
+		Run(game);
+	}
+
+	// A decision is only asked for once per fix.
+	static const GameCase noFixes = { "no decision without a new fix", true, NEVER, true, false, "I", 0, 20, NEVER,
+		"ObtainingFix [awaitingFix] NoGpsFix [sayingGoodbye] Goodbye [poweringDown] Clear PowerDown [finished]" };
+	Run(noFixes);
+	Expect("no decision is asked for without a fix", decisionsAsked == 0);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+// Host check of NeoGPS's Geofence_t::contains over a global grid of fence centers, including the poles' neighbourhood and
+// the antimeridian. For each center and radius, points are placed just inside and just outside the radius in BEARINGS
+// directions with double precision spherical geometry, and contains() must agree with a double haversine. The radii cover
+// both the integer path (up to Geofence_t::FAST_MAX_M) and the haversine path above it.
+//
+// The Makefile builds this with -fsanitize=float-cast-overflow, so a radius too large for the integer terms fails the run.
+#include <math.h>
+#include <stdio.h>
+#include <Location.h>
+
+using namespace NeoGPS;
+
+static const uint16_t radii[] = { 10, 30, 100, 500, 501, 5000, 65535 };
+static const uint8_t RADII = sizeof(radii) / sizeof(radii[0]);
+static const uint8_t BEARINGS = 16;
+static const double scales[] = { 0.99, 1.01 }; // Just inside and just outside.
+
+static const double EARTH_RADIUS_M = Location_t::EARTH_RADIUS_KM * 1000.0;
+static const double RAD_PER_DEG = M_PI / 180.0;
+
+static int32_t ToUnits(double degrees)
+{
+	return (int32_t)lround(degrees * 1e7);
+}
+
+static double HaversineM(const Location_t& p1, const Location_t& p2)
+{
+	double lat1 = p1.lat() * 1e-7 * RAD_PER_DEG;
+	double lat2 = p2.lat() * 1e-7 * RAD_PER_DEG;
+	double dLat = lat2 - lat1;
+	double dLon = ((double)p2.lon() - p1.lon()) * 1e-7 * RAD_PER_DEG;
+	double a = sin(dLat / 2) * sin(dLat / 2) + cos(lat1) * cos(lat2) * sin(dLon / 2) * sin(dLon / 2);
+	return 2 * EARTH_RADIUS_M * asin(sqrt(fmin(1.0, a)));
+}
+
+// The point /meters/ from /center/ along the great circle leaving at /bearing/ radians, wrapped to +/-180 degrees.
+static Location_t Destination(const Location_t& center, double meters, double bearing)
+{
+	double lat1 = center.lat() * 1e-7 * RAD_PER_DEG;
+	double lon1 = center.lon() * 1e-7 * RAD_PER_DEG;
+	double d = meters / EARTH_RADIUS_M;
+	double lat2 = asin(sin(lat1) * cos(d) + cos(lat1) * sin(d) * cos(bearing));
+	double lon2 = lon1 + atan2(sin(bearing) * sin(d) * cos(lat1), cos(d) - sin(lat1) * sin(lat2));
+	double lon = remainder(lon2 / RAD_PER_DEG, 360.0);
+	return Location_t(ToUnits(lat2 / RAD_PER_DEG), ToUnits(lon));
+}
+
+int main()
+{
+	uint32_t failures = 0;
+	printf("radius m,fast,points,mismatches\n");
+	for (uint8_t r = 0; r < RADII; r++)
+	{
+		uint32_t points = 0;
+		uint32_t mismatches = 0;
+		Geofence_t fence;
+		for (int lat = -85; lat <= 85; lat += 5)
+		{
+			for (int lon = -180; lon <= 180; lon += 10)
+			{
+				fence.init(Location_t(ToUnits(lat), ToUnits(lon)), radii[r]);
+				for (uint8_t b = 0; b < BEARINGS; b++)
+				{
+					double bearing = b * 2 * M_PI / BEARINGS + 0.1; // Off the axes, so both deltas are non-zero.
+					for (double scale : scales)
+					{
+						Location_t p = Destination(fence.center(), radii[r] * scale, bearing);
+						bool inside = HaversineM(fence.center(), p) <= radii[r];
+						points++;
+						if (fence.contains(p) != inside)
+						{
+							if (mismatches < 5)
+							{
+								printf("  center %d,%d, bearing %.2f, %.0f%% of the radius: contains() says %s\n", lat, lon, bearing,
+									scale * 100, inside ? "outside" : "inside");
+							}
+							mismatches++;
+						}
+					}
+				}
+			}
+		}
+		printf("%u,%s,%u,%u\n", radii[r], fence.fast() ? "yes" : "no", points, mismatches);
+		failures += mismatches;
+	}
+	printf("%s\n", failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
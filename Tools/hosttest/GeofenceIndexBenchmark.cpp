@@ -0,0 +1,122 @@
+// Host comparison of the lockbox's GeofenceIndex against a linear scan of the same zones, for 10, 100 and 1000 zones.
+// Zones are scattered over a few degrees around New Zealand, with a tenth of them on the antimeridian. Half of the queries
+// land near a zone, the other half anywhere in the area. FindContaining must return exactly what FindContainingLinear
+// returns for every query, or the exit status is 1. The times are per query on the host, so they compare the two
+// approaches rather than predict AVR cycles.
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include "GeofenceIndex.h"
+
+static const int QUERIES = 20000;
+static const int TIMING_PASSES = 10;
+static const uint8_t MAX_FOUND = 16;
+
+static int32_t WrapLongitude(int64_t longitude)
+{
+	if (longitude > 1800000000LL)
+	{
+		longitude -= 3600000000LL;
+	}
+	else if (longitude < -1800000000LL)
+	{
+		longitude += 3600000000LL;
+	}
+	return (int32_t)longitude;
+}
+
+static bool RunZones(int numberOfZones)
+{
+	std::mt19937 rng(numberOfZones);
+	std::uniform_int_distribution<int32_t> latitude(-360000000L, -350000000L);
+	std::uniform_int_distribution<int32_t> longitude(1740000000L, 1799999999L);
+	std::uniform_int_distribution<int> radius(10, 500);
+	std::uniform_int_distribution<int32_t> nearby(-3000, 3000);
+
+	std::vector<GeofenceZone> zones(numberOfZones);
+	std::vector<GeofenceCell> cells(numberOfZones * 8);
+	for (int z = 0; z < numberOfZones; z++)
+	{
+		latLongLocation location = { latitude(rng), longitude(rng) };
+		zoneKind kind = zoneTarget;
+		if (z < numberOfZones / 10)
+		{
+			location.longitude = (z & 1) ? 1799990000L : -1799990000L; // Boxes that cross +/-180 degrees.
+			kind = zoneDecoy;
+		}
+		GeofenceIndex::SetZone(zones[z], location, radius(rng), kind);
+	}
+	GeofenceIndex index(zones.data(), cells.data(), cells.size());
+	if (!index.Build(numberOfZones))
+	{
+		printf("%d,FAIL: the cell array is too small\n", numberOfZones);
+		return false;
+	}
+
+	std::vector<NeoGPS::Location_t> queries;
+	for (int q = 0; q < QUERIES; q++)
+	{
+		if (q & 1)
+		{
+			const NeoGPS::Location_t& center = zones[rng() % numberOfZones].Fence.center();
+			queries.push_back(NeoGPS::Location_t(center.lat() + nearby(rng), WrapLongitude((int64_t)center.lon() + nearby(rng))));
+		}
+		else
+		{
+			queries.push_back(NeoGPS::Location_t(latitude(rng), longitude(rng)));
+		}
+	}
+
+	uint32_t hits = 0;
+	uint32_t mismatches = 0;
+	uint16_t indexed[MAX_FOUND];
+	uint16_t linear[MAX_FOUND];
+	for (const NeoGPS::Location_t& query : queries)
+	{
+		uint8_t indexedCount = index.FindContaining(query, indexed, MAX_FOUND);
+		uint8_t linearCount = index.FindContainingLinear(query, linear, MAX_FOUND);
+		hits += indexedCount;
+		if (indexedCount != linearCount || !std::equal(indexed, indexed + indexedCount, linear))
+		{
+			mismatches++;
+		}
+	}
+
+	volatile uint32_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < TIMING_PASSES; pass++)
+	{
+		for (const NeoGPS::Location_t& query : queries)
+		{
+			sink += index.FindContaining(query, indexed, MAX_FOUND);
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < TIMING_PASSES; pass++)
+	{
+		for (const NeoGPS::Location_t& query : queries)
+		{
+			sink += index.FindContainingLinear(query, linear, MAX_FOUND);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	double perQuery = 1.0 / ((double)TIMING_PASSES * QUERIES);
+	printf("%d,%u,%u,%u,%.0f,%.0f\n", numberOfZones, index.GetCellCount(), hits, mismatches,
+		std::chrono::duration<double, std::nano>(middle - start).count() * perQuery,
+		std::chrono::duration<double, std::nano>(end - middle).count() * perQuery);
+	return mismatches == 0;
+}
+
+int main()
+{
+	bool ok = true;
+	printf("zones,cells,hits,mismatches,index ns/query,linear ns/query\n");
+	for (int numberOfZones : { 10, 100, 1000 })
+	{
+		ok &= RunZones(numberOfZones);
+	}
+	printf("%s\n", ok ? "ok" : "FAIL");
+	return ok ? 0 : 1;
+}
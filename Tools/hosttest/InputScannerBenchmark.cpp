@@ -0,0 +1,231 @@
+// Host timing of InputScanner against the checks and conversions Setup made before it, which checked an entry in one pass
+// per rule and then read it again to convert it. Each is given the same valid entries with random digits, the date/time
+// converted to its six fields rather than a time_t, so makeTime isn't timed.
+//   - Both must give the same values for every timed entry;
+//   - the time per entry of each, on the host.
+// The old date/time check never held the fields to their limits, which Scan does as it goes.
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Arduino.h>
+#include "InputScanner.h"
+
+static const int TIMED_ENTRIES = 1 << 14;
+static const int TIMED_ROUNDS = 100;
+static const int ENTRY_SIZE = 24;
+
+static int failures = 0;
+
+// As in Setup.cpp.
+static const char dateTimeFormat[] PROGMEM = "yyyy-nn-ddThh:mm:ss";
+static const char latitudeFormat[] PROGMEM = "+cc.ccccccc";
+static const char longitudeFormat[] PROGMEM = "+ccc.ccccccc";
+static const char windowDurationFormat[] PROGMEM = "ww";
+static const ScanFieldLimit dateTimeLimits[] PROGMEM = { { 1970, 2105 }, { 1, 12 }, { 1, 31 }, { 0, 23 }, { 0, 59 }, { 0, 59 } };
+
+static char entries[TIMED_ENTRIES][ENTRY_SIZE];
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+// The old checks, without the messages they printed.
+static bool OldDigits(const char* text, uint8_t from, uint8_t to)
+{
+	for (uint8_t i = from; i < to; i++)
+	{
+		if (text[i] < '0' || text[i] > '9')
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool OldLength(const char* text, uint8_t length)
+{
+	for (uint8_t i = 0; i < length; i++)
+	{
+		if (text[i] == '\0')
+		{
+			return false;
+		}
+	}
+	return text[length] == '\0';
+}
+
+static bool OldValidateDateTime(const char* text)
+{
+	if (!OldLength(text, 19) || !OldDigits(text, 0, 4))
+	{
+		return false;
+	}
+	uint16_t year = (text[0] - 48) * 1000 + (text[1] - 48) * 100 + (text[2] - 48) * 10 + (text[3] - 48);
+	return year >= 1970 && text[4] == '-' && OldDigits(text, 5, 7) && text[7] == '-' && OldDigits(text, 8, 10) && text[10] == 'T'
+		&& OldDigits(text, 11, 13) && text[13] == ':' && OldDigits(text, 14, 16) && text[16] == ':' && OldDigits(text, 17, 19);
+}
+
+static void OldParseDateTime(const char* text, int32_t* fields)
+{
+	fields[0] = (text[0] - 48) * 1000 + (text[1] - 48) * 100 + (text[2] - 48) * 10 + (text[3] - 48);
+	fields[1] = (text[5] - 48) * 10 + (text[6] - 48);
+	fields[2] = (text[8] - 48) * 10 + (text[9] - 48);
+	fields[3] = (text[11] - 48) * 10 + (text[12] - 48);
+	fields[4] = (text[14] - 48) * 10 + (text[15] - 48);
+	fields[5] = (text[17] - 48) * 10 + (text[18] - 48);
+}
+
+static bool OldValidateLocation(const char* text, uint8_t decimalPosition)
+{
+	return OldLength(text, decimalPosition + 8) && (text[0] == '+' || text[0] == '-') && text[decimalPosition] == '.'
+		&& OldDigits(text, 1, decimalPosition) && OldDigits(text, decimalPosition + 1, decimalPosition + 8);
+}
+
+// Removed the decimal point in place, then the sign into a copy, then atol.
+static int32_t OldParseLocation(char* text, uint8_t decimalPosition)
+{
+	uint8_t stringLength = decimalPosition + 9;
+	for (uint8_t i = decimalPosition; i < stringLength - 1; i++)
+	{
+		text[i] = text[i + 1];
+	}
+	char absoluteValAsString[13];
+	strncpy(absoluteValAsString, text + 1, stringLength - 2);
+	int32_t absoluteVal = atol(absoluteValAsString);
+	return (text[0] == '-') ? -absoluteVal : absoluteVal;
+}
+
+static bool OldValidateWindowDuration(const char* text)
+{
+	return OldLength(text, 2) && OldDigits(text, 0, 2);
+}
+
+static uint16_t OldParseWindowDuration(const char* text)
+{
+	return (text[0] - 48) * 600 + (text[1] - 48) * 60;
+}
+
+// Valid entries for the format, with random digits and signs, longitudes within 199 degrees, and date/time fields in range.
+static void MakeEntries(std::mt19937& random, const char* format)
+{
+	for (int e = 0; e < TIMED_ENTRIES; e++)
+	{
+		char* entry = entries[e];
+		for (size_t i = 0; i <= strlen(format); i++)
+		{
+			entry[i] = (format[i] >= 'a' && format[i] <= 'z') ? '0' + random() % 10 : (format[i] == '+') ? "+-"[random() % 2] : format[i];
+		}
+		if (format == longitudeFormat)
+		{
+			entry[1] = '0' + random() % 2;
+		}
+		if (format == dateTimeFormat)
+		{
+			snprintf(entry, ENTRY_SIZE, "%04u-%02u-%02uT%02u:%02u:%02u", (unsigned)(1970 + random() % 136), (unsigned)(1 + random() % 12),
+				(unsigned)(1 + random() % 28), (unsigned)(random() % 24), (unsigned)(random() % 60), (unsigned)(random() % 60));
+		}
+	}
+}
+
+template <typename Body> static double NanosecondsPerEntry(Body body)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < TIMED_ROUNDS; round++)
+	{
+		for (int e = 0; e < TIMED_ENTRIES; e++)
+		{
+			body(e);
+		}
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)TIMED_ROUNDS * TIMED_ENTRIES);
+}
+
+// The old path converts a location in place, so it works on a copy, as Setup's input buffer was.
+template <typename Old> static void TimeEntry(std::mt19937& random, const char* name, const char* format, const ScanFieldLimit* limits,
+	int fieldCount, Old old)
+{
+	MakeEntries(random, format);
+	int differ = 0;
+	for (int e = 0; e < TIMED_ENTRIES; e++)
+	{
+		int32_t oldFields[6];
+		int32_t newFields[6];
+		char copy[ENTRY_SIZE];
+		memcpy(copy, entries[e], ENTRY_SIZE);
+		bool oldOk = old(copy, oldFields);
+		bool newOk = InputScanner::Scan(entries[e], format, limits, newFields);
+		differ += !oldOk || !newOk || memcmp(oldFields, newFields, fieldCount * sizeof(int32_t)) != 0;
+	}
+	volatile int32_t sink = 0;
+	double oldNs = NanosecondsPerEntry([&](int e) {
+		char copy[ENTRY_SIZE];
+		memcpy(copy, entries[e], ENTRY_SIZE);
+		int32_t fields[6];
+		if (old(copy, fields))
+		{
+			sink = sink + fields[fieldCount - 1];
+		}
+	});
+	double newNs = NanosecondsPerEntry([&](int e) {
+		char copy[ENTRY_SIZE];
+		memcpy(copy, entries[e], ENTRY_SIZE);
+		int32_t fields[6];
+		if (InputScanner::Scan(copy, format, limits, fields))
+		{
+			sink = sink + fields[fieldCount - 1];
+		}
+	});
+	printf("%s,%.1f,%.1f\n", name, oldNs, newNs);
+	char check[80];
+	snprintf(check, sizeof(check), "%s: both give the same values", name);
+	Expect(check, differ == 0);
+}
+
+int main()
+{
+	std::mt19937 random(7);
+	printf("entry,old ns per entry,InputScanner ns per entry\n");
+	TimeEntry(random, "date/time", dateTimeFormat, dateTimeLimits, 6, [](char* text, int32_t* fields) {
+		if (!OldValidateDateTime(text))
+		{
+			return false;
+		}
+		OldParseDateTime(text, fields);
+		return true;
+	});
+	TimeEntry(random, "latitude", latitudeFormat, NULL, 1, [](char* text, int32_t* fields) {
+		if (!OldValidateLocation(text, 3))
+		{
+			return false;
+		}
+		fields[0] = OldParseLocation(text, 3);
+		return true;
+	});
+	TimeEntry(random, "longitude", longitudeFormat, NULL, 1, [](char* text, int32_t* fields) {
+		if (!OldValidateLocation(text, 4))
+		{
+			return false;
+		}
+		fields[0] = OldParseLocation(text, 4);
+		return true;
+	});
+	// The old conversion went straight to seconds, so it is compared in minutes.
+	TimeEntry(random, "window", windowDurationFormat, NULL, 1, [](char* text, int32_t* fields) {
+		if (!OldValidateWindowDuration(text))
+		{
+			return false;
+		}
+		fields[0] = OldParseWindowDuration(text) / 60;
+		return true;
+	});
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,343 @@
+// Host fuzz test of InputScanner with Setup's four entry formats, against a reference that checks the whole entry against
+// the format's character classes first and only then reads the fields. Entries are valid ones with random digits, those
+// mutated, and random strings, each copied into a heap block of exactly its length, so reading past its NUL stops the run.
+//   - Scan must accept exactly the entries the reference accepts, with the same field values, saturated past int32_t;
+//   - a rejected entry's error must be at or before its end and name a character that breaks the format, with everything
+//     before it matching, or the start of a field that is out of range;
+//   - every kind of error must be produced.
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Arduino.h>
+#include "InputScanner.h"
+
+static const long ENTRIES_PER_FORMAT = 500000;
+static const int MAX_ENTRY_LENGTH = 24;
+static const int MAX_FIELDS = 6;
+
+static int failures = 0;
+
+// As in Setup.cpp.
+static const char dateTimeFormat[] PROGMEM = "yyyy-nn-ddThh:mm:ss";
+static const char latitudeFormat[] PROGMEM = "+cc.ccccccc";
+static const char longitudeFormat[] PROGMEM = "+ccc.ccccccc";
+static const char windowDurationFormat[] PROGMEM = "ww";
+static const ScanFieldLimit dateTimeLimits[] PROGMEM = { { 1970, 2105 }, { 1, 12 }, { 1, 31 }, { 0, 23 }, { 0, 59 }, { 0, 59 } };
+
+struct EntryFormat
+{
+	const char* Format;
+	const ScanFieldLimit* Limits;
+};
+
+static const EntryFormat FORMATS[] = {
+	{ dateTimeFormat, dateTimeLimits },
+	{ latitudeFormat, NULL },
+	{ longitudeFormat, NULL },
+	{ windowDurationFormat, NULL },
+};
+static const int FORMAT_COUNT = sizeof(FORMATS) / sizeof(FORMATS[0]);
+
+// What mutations put in: the formats' own characters, and some they never take.
+static const char ALPHABET[] = "0123456789+-.:T 9x\x7f\x80\xff";
+
+// The fields of an entry, as the reference reads them: where each lies in the format, and its value if all of it matches.
+struct Fields
+{
+	int Count;
+	int Starts[MAX_FIELDS];
+	int Ends[MAX_FIELDS];
+	int64_t Values[MAX_FIELDS];
+	size_t Matching;
+};
+
+struct Tally
+{
+	long Entries;
+	long Accepted;
+	long Disagree;
+	long WrongValue;
+	long BadError;
+	long Errors[scanOutOfRange + 1];
+};
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static bool IsLetter(char c)
+{
+	return c >= 'a' && c <= 'z';
+}
+
+static bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool Matches(char formatCharacter, char inputCharacter)
+{
+	if (IsLetter(formatCharacter))
+	{
+		return IsDigit(inputCharacter);
+	}
+	if (formatCharacter == '+')
+	{
+		return inputCharacter == '+' || inputCharacter == '-';
+	}
+	return inputCharacter == formatCharacter;
+}
+
+// How many characters from the start match the format's character classes, and the fields those cover, read in 64 bits,
+// saturated as Scan does, and each signed by the last '+' before it.
+static void ReadFields(const char* input, const char* format, Fields& fields)
+{
+	fields.Matching = 0;
+	while (format[fields.Matching] && Matches(format[fields.Matching], input[fields.Matching]))
+	{
+		fields.Matching++;
+	}
+	fields.Count = 0;
+	char letter = 0;
+	bool negative = false;
+	bool negatives[MAX_FIELDS] = {};
+	for (int i = 0; format[i]; i++)
+	{
+		if (format[i] == '+')
+		{
+			negative = i < (int)fields.Matching && input[i] == '-';
+		}
+		else if (IsLetter(format[i]))
+		{
+			if (format[i] != letter)
+			{
+				letter = format[i];
+				fields.Starts[fields.Count] = i;
+				fields.Values[fields.Count] = 0;
+				negatives[fields.Count++] = negative;
+				negative = false;
+			}
+			fields.Ends[fields.Count - 1] = i;
+			if (i < (int)fields.Matching)
+			{
+				fields.Values[fields.Count - 1] = fields.Values[fields.Count - 1] * 10 + (input[i] - '0');
+			}
+		}
+	}
+	for (int i = 0; i < fields.Count; i++)
+	{
+		if (fields.Values[i] > SCAN_SATURATED)
+		{
+			fields.Values[i] = SCAN_SATURATED;
+		}
+		fields.Values[i] = negatives[i] ? -fields.Values[i] : fields.Values[i];
+	}
+}
+
+static bool OutOfRange(const Fields& fields, const ScanFieldLimit* limits, int field)
+{
+	return limits && (fields.Values[field] < limits[field].Minimum || fields.Values[field] > limits[field].Maximum);
+}
+
+// Whether the whole entry matches its format and every field is in range.
+static bool Valid(const char* input, const EntryFormat& entryFormat, const Fields& fields)
+{
+	if (fields.Matching != strlen(entryFormat.Format) || input[fields.Matching] != '\0')
+	{
+		return false;
+	}
+	for (int i = 0; i < fields.Count; i++)
+	{
+		if (OutOfRange(fields, entryFormat.Limits, i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// The first field Scan would find out of range, or -1. A field is only checked once the first digit of the next has
+// matched, or the whole format has.
+static int FirstOutOfRange(const EntryFormat& entryFormat, const Fields& fields)
+{
+	for (int i = 0; i < fields.Count; i++)
+	{
+		size_t checkedBy = (i + 1 < fields.Count) ? fields.Starts[i + 1] + 1 : strlen(entryFormat.Format);
+		if (fields.Matching < checkedBy)
+		{
+			return -1;
+		}
+		if (OutOfRange(fields, entryFormat.Limits, i))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Whether the error Scan gave for a rejected entry is the one the reference expects: the first field out of range, or
+// else the first character that breaks the format.
+static bool ErrorFits(const char* input, const EntryFormat& entryFormat, const Fields& fields)
+{
+	const char* format = entryFormat.Format;
+	size_t position = InputScanner::GetErrorPosition();
+	char formatCharacter = InputScanner::GetErrorFormatCharacter();
+	if (position > strlen(input) || position > strlen(format) || formatCharacter != format[position])
+	{
+		return false;
+	}
+	int field = FirstOutOfRange(entryFormat, fields);
+	if (field >= 0)
+	{
+		return InputScanner::GetError() == scanOutOfRange && InputScanner::GetErrorField() == field
+			&& (int)position == fields.Starts[field];
+	}
+	if (position != fields.Matching)
+	{
+		return false;
+	}
+	char inputCharacter = input[position];
+	switch (InputScanner::GetError())
+	{
+	case scanTooShort:
+		return inputCharacter == '\0' && formatCharacter != '\0';
+	case scanTooLong:
+		return inputCharacter != '\0' && formatCharacter == '\0';
+	case scanExpectedSign:
+		return formatCharacter == '+' && inputCharacter != '\0';
+	case scanExpectedDigit:
+		return IsLetter(formatCharacter) && inputCharacter != '\0';
+	case scanExpectedCharacter:
+		return !IsLetter(formatCharacter) && formatCharacter != '+' && formatCharacter != '\0' && inputCharacter != '\0';
+	default:
+		return false;
+	}
+}
+
+// A valid entry with random digits and signs, then mutated half the time, or a random string.
+static void MakeEntry(std::mt19937& random, const char* format, char* entry)
+{
+	size_t length = strlen(format);
+	if (random() % 8 == 0)
+	{
+		length = random() % (MAX_ENTRY_LENGTH + 1);
+		for (size_t i = 0; i < length; i++)
+		{
+			entry[i] = ALPHABET[random() % (sizeof(ALPHABET) - 1)];
+		}
+		entry[length] = '\0';
+		return;
+	}
+	for (size_t i = 0; i <= length; i++)
+	{
+		entry[i] = IsLetter(format[i]) ? '0' + random() % 10 : (format[i] == '+') ? "+-"[random() % 2] : format[i];
+	}
+	if (random() % 2)
+	{
+		return;
+	}
+	for (int mutation = random() % 3; mutation >= 0; mutation--)
+	{
+		length = strlen(entry);
+		size_t at = length ? random() % length : 0;
+		char c = ALPHABET[random() % (sizeof(ALPHABET) - 1)];
+		switch (random() % 3)
+		{
+		case 0:
+			if (length)
+			{
+				entry[at] = c;
+			}
+			break;
+		case 1:
+			if (length)
+			{
+				memmove(entry + at, entry + at + 1, length - at);
+			}
+			break;
+		default:
+			if (length < (size_t)MAX_ENTRY_LENGTH)
+			{
+				memmove(entry + at + 1, entry + at, length - at + 1);
+				entry[at] = c;
+			}
+			break;
+		}
+	}
+}
+
+static void Fuzz(std::mt19937& random, const EntryFormat& entryFormat, Tally& tally)
+{
+	char entry[MAX_ENTRY_LENGTH + 2];
+	for (long n = 0; n < ENTRIES_PER_FORMAT; n++)
+	{
+		MakeEntry(random, entryFormat.Format, entry);
+		size_t size = strlen(entry) + 1;
+		char* input = (char*)malloc(size);
+		memcpy(input, entry, size);
+
+		Fields expected;
+		ReadFields(input, entryFormat.Format, expected);
+		bool accept = Valid(input, entryFormat, expected);
+		int32_t fields[MAX_FIELDS];
+		bool accepted = InputScanner::Scan(input, entryFormat.Format, entryFormat.Limits, fields);
+
+		tally.Entries++;
+		tally.Accepted += accepted;
+		if (accepted != accept)
+		{
+			if (tally.Disagree++ < 5)
+			{
+				printf("  '%s' against '%s': Scan %s it\n", entry, entryFormat.Format, accepted ? "accepts" : "rejects");
+			}
+		}
+		else if (accepted)
+		{
+			for (int i = 0; i < expected.Count; i++)
+			{
+				tally.WrongValue += fields[i] != expected.Values[i];
+			}
+		}
+		else
+		{
+			tally.Errors[InputScanner::GetError()]++;
+			if (!ErrorFits(input, entryFormat, expected) && tally.BadError++ < 5)
+			{
+				printf("  '%s' against '%s': error %d at %u\n", entry, entryFormat.Format, (int)InputScanner::GetError(),
+					InputScanner::GetErrorPosition());
+			}
+		}
+		free(input);
+	}
+}
+
+int main()
+{
+	std::mt19937 random(7);
+	Tally tally = {};
+	for (int f = 0; f < FORMAT_COUNT; f++)
+	{
+		Fuzz(random, FORMATS[f], tally);
+	}
+	printf("  %ld entries, %ld accepted; rejected too short %ld, too long %ld, sign %ld, digit %ld, character %ld, range %ld\n",
+		tally.Entries, tally.Accepted, tally.Errors[scanTooShort], tally.Errors[scanTooLong], tally.Errors[scanExpectedSign],
+		tally.Errors[scanExpectedDigit], tally.Errors[scanExpectedCharacter], tally.Errors[scanOutOfRange]);
+	Expect("Scan accepts what the reference accepts", tally.Disagree == 0);
+	Expect("accepted fields have the reference's values", tally.WrongValue == 0);
+	Expect("each error names the bad character or field", tally.BadError == 0);
+	bool everyError = tally.Errors[scanOk] == 0;
+	for (int error = scanTooShort; error <= scanOutOfRange; error++)
+	{
+		everyError &= tally.Errors[error] > 0;
+	}
+	Expect("every kind of error is produced", everyError);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+// Host check of the Journal's EEPROM wear over a year of heavy use: 600 games of up to MAX_POINTS points, with two to
+// seven boots at each point, each boot recording itself and the fix it decided on, as the sketch does. The shim's EEPROM
+// counts the writes to each cell.
+//   - Every boot must recover the state recorded before it;
+//   - the appends must be spread evenly over the slots, so no journal cell is written more than once per
+//     JOURNAL_SLOT_COUNT appends, rounded up;
+//   - at that rate the busiest cell must last ten years within the ATmega328P's rated 100,000 cycles;
+//   - nothing may be written outside the journal's region.
+#include <stdio.h>
+#include <stdlib.h>
+#include "Journal.h"
+#include "Setup.h"
+
+static const int GAMES = 600; // About 50 games a month.
+static const uint32_t RATED_CYCLES = 100000;
+
+static int failures = 0;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+int main()
+{
+	srand(3);
+	memset(EEPROM.Bytes, 0xFF, sizeof(EEPROM.Bytes));
+	memset(EEPROM.Writes, 0, sizeof(EEPROM.Writes));
+	uint32_t appends = 0;
+	int lostState = 0;
+	uint16_t bootCount = 0;
+	for (int game = 0; game < GAMES; game++)
+	{
+		uint16_t configCrc = 0x1000 + game;
+		Journal::StartGame(configCrc);
+		appends++;
+		int points = 1 + rand() % MAX_POINTS;
+		for (int point = 0; point < points; point++)
+		{
+			int boots = 2 + rand() % 6;
+			for (int boot = 0; boot < boots; boot++)
+			{
+				// Each boot starts from what the EEPROM holds.
+				bool recovered = Journal::Recover(configCrc);
+				lostState += !recovered || Journal::GetPointIndex() != point || Journal::GetBootCount() != bootCount;
+				Journal::RecordBoot();
+				bootCount++;
+				latLongLocation fix = { -368485000 + rand() % 1000, 1747633000 + point * 1000 };
+				Journal::RecordFix(fix);
+				appends += 2;
+			}
+			if (point + 1 < points)
+			{
+				Journal::RecordPointIndex(point + 1);
+				appends++;
+			}
+		}
+	}
+
+	uint32_t worstJournal = 0;
+	uint32_t outside = 0;
+	for (int i = 0; i < EEPROMClass::SIZE; i++)
+	{
+		if (i >= JOURNAL_EEPROM_ADDRESS && i < JOURNAL_EEPROM_ADDRESS + JOURNAL_SLOT_COUNT * sizeof(JournalRecord))
+		{
+			worstJournal = max(worstJournal, EEPROM.Writes[i]);
+		}
+		else
+		{
+			outside += EEPROM.Writes[i];
+		}
+	}
+	uint32_t evenShare = (appends + JOURNAL_SLOT_COUNT - 1) / JOURNAL_SLOT_COUNT;
+	printf("  %u appends over %u slots of %u bytes: the busiest cell written %u times, an even share is %u, one fixed slot would take %u\n",
+		appends, (unsigned)JOURNAL_SLOT_COUNT, (unsigned)sizeof(JournalRecord), worstJournal, evenShare, appends);
+	Expect("every boot recovers the recorded state", lostState == 0);
+	Expect("writes spread evenly over the slots", worstJournal <= evenShare);
+	Expect("the busiest cell lasts ten years of this", worstJournal * 10 < RATED_CYCLES);
+	Expect("nothing written outside the journal", outside == 0);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+// Host check of the I2C burst mode in I2CIO and LiquidCrystal_I2C, on the shim's Wire, which records every byte sent.
+// The same LCD operations are sent one value per transmission, as without bursts, and then in bursts.
+//   - The bytes on the bus must be exactly the same either way, so the expander's pins go through the same sequence;
+//   - no transmission may hold more than the Wire buffer, and no byte may be written outside one;
+//   - print() inside a burst must join it rather than end it, and print() outside one must send its own.
+#include <stdio.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+
+static int failures = 0;
+
+static const char* LONG_TEXT = "Longer than one transmission holds";
+static uint8_t box[8] = { 0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F, 0x00 };
+
+static LiquidCrystal_I2C lcd(0x27, 2, 1, 0, 4, 5, 6, 7, 3, POSITIVE);
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void WriteEach(const char* text)
+{
+	while (*text)
+	{
+		lcd.write((uint8_t)*text++);
+	}
+}
+
+// Characters, cursor moves, a glyph, a clear and the backlight, each one value per transmission.
+static void SendSeparately()
+{
+	for (uint8_t row = 0; row < 2; row++)
+	{
+		lcd.setCursor(0, row);
+		WriteEach("0123456789ABCDEF");
+	}
+	lcd.setCursor(3, 1);
+	WriteEach(LONG_TEXT);
+	lcd.createChar(1, box);
+	lcd.clear();
+	lcd.setCursor(5, 0);
+	lcd.write(1);
+	lcd.noBacklight();
+	lcd.backlight();
+}
+
+// The same, in bursts, with print() both inside one and on its own.
+static void SendInBursts()
+{
+	for (uint8_t row = 0; row < 2; row++)
+	{
+		lcd.beginBurst();
+		lcd.setCursor(0, row);
+		lcd.print("0123456789");
+		WriteEach("ABCDEF");
+		lcd.endBurst();
+	}
+	lcd.setCursor(3, 1);
+	lcd.print(LONG_TEXT);
+	lcd.beginBurst();
+	lcd.createChar(1, box);
+	lcd.clear();
+	lcd.setCursor(5, 0);
+	lcd.write(1);
+	lcd.noBacklight();
+	lcd.backlight();
+	lcd.endBurst();
+}
+
+int main()
+{
+	static uint8_t separate[TwoWire::SENT_CAPACITY];
+	Wire.Acknowledge = true;
+	lcd.begin(16, 2);
+
+	Wire.Reset();
+	SendSeparately();
+	size_t separateCount = Wire.SentCount;
+	uint32_t separateTransmissions = Wire.Transmissions;
+	memcpy(separate, Wire.Sent, separateCount);
+
+	Wire.Reset();
+	SendInBursts();
+	printf("  %u bytes: %u transmissions one at a time, %u in bursts, the longest %u bytes\n", (unsigned)separateCount,
+		separateTransmissions, Wire.Transmissions, Wire.LongestTransmission);
+	Expect("bursts send the same bytes", Wire.SentCount == separateCount && memcmp(separate, Wire.Sent, separateCount) == 0);
+	Expect("bursts take fewer transmissions", Wire.Transmissions * 8 < separateTransmissions);
+	Expect("no transmission holds more than the Wire buffer", Wire.LongestTransmission <= BUFFER_LENGTH);
+	Expect("nothing is written outside a transmission", Wire.WritesOutside == 0);
+
+	// Each character or command is two nibbles, each a byte with EN high and one with it low. A cursor move and four characters
+	// are 20 bytes: one transmission if print() joins the burst, more if it ends it.
+	Wire.Reset();
+	lcd.beginBurst();
+	lcd.setCursor(0, 0);
+	lcd.print("ab");
+	lcd.write('c');
+	lcd.print("d");
+	lcd.endBurst();
+	Expect("print() inside a burst joins it", Wire.Transmissions == 1 && Wire.SentCount == 20);
+
+	Wire.Reset();
+	lcd.print("ab");
+	Expect("print() on its own sends its own burst", Wire.Transmissions == 1 && Wire.SentCount == 8);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
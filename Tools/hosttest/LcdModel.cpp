@@ -0,0 +1,144 @@
+#include "LcdModel.h"
+
+// The PCF8574's bits, as passed to LiquidCrystal_I2C by Display.cpp.
+static const uint8_t RS = 1 << 0;
+static const uint8_t EN = 1 << 2;
+static const uint8_t DATA_SHIFT = 4;
+
+static const uint8_t ROW_ADDRESS[2] = { 0x00, 0x40 };
+
+uint32_t LcdModel::Commands = 0;
+uint32_t LcdModel::Characters = 0;
+
+static char ddram[0x80];
+static uint8_t address = 0;
+static bool fourBit = false;
+static bool highNibbleHeld = false;
+static uint8_t highNibble = 0;
+static bool toCgram = false;
+static uint8_t lastPort = 0;
+static size_t decoded = 0; // How much of Wire.Sent has been taken in.
+
+void LcdModel::Reset()
+{
+	memset(ddram, ' ', sizeof(ddram));
+	address = 0;
+	fourBit = false;
+	highNibbleHeld = false;
+	toCgram = false;
+	lastPort = 0;
+	decoded = Wire.SentCount;
+	Commands = 0;
+	Characters = 0;
+}
+
+// Two lines of 40 cells each, at 0x00 and 0x40.
+static void Advance()
+{
+	address++;
+	if (address == 0x28)
+	{
+		address = 0x40;
+	}
+	else if (address == 0x68)
+	{
+		address = 0;
+	}
+}
+
+static void Command(uint8_t command)
+{
+	if (command & 0x80)
+	{
+		address = command & 0x7F;
+		toCgram = false;
+	}
+	else if (command & 0x40)
+	{
+		toCgram = true;
+	}
+	else if (command & 0x20)
+	{
+		fourBit = !(command & 0x10);
+	}
+	else if (command & 0x02)
+	{
+		address = 0;
+	}
+	else if (command & 0x01)
+	{
+		memset(ddram, ' ', sizeof(ddram));
+		address = 0;
+	}
+}
+
+// The LCD takes the data lines when EN falls.
+static void Latch(uint8_t port)
+{
+	uint8_t nibble = port >> DATA_SHIFT;
+	bool data = port & RS;
+	if (!fourBit)
+	{
+		// Only the upper four data lines are wired, and those are all that a command in 8 bit mode needs.
+		Command(nibble << 4);
+		return;
+	}
+	if (!highNibbleHeld)
+	{
+		highNibble = nibble;
+		highNibbleHeld = true;
+		return;
+	}
+	highNibbleHeld = false;
+	uint8_t value = (highNibble << 4) | nibble;
+	if (!data)
+	{
+		LcdModel::Commands++;
+		Command(value);
+	}
+	else if (!toCgram)
+	{
+		LcdModel::Characters++;
+		ddram[address] = value;
+		Advance();
+	}
+}
+
+void LcdModel::Update()
+{
+	size_t end = min(Wire.SentCount, TwoWire::SENT_CAPACITY);
+	for (; decoded < end; decoded++)
+	{
+		uint8_t port = Wire.Sent[decoded];
+		if ((lastPort & EN) && !(port & EN))
+		{
+			Latch(lastPort);
+		}
+		lastPort = port;
+	}
+}
+
+char LcdModel::Cell(uint8_t row, uint8_t column)
+{
+	return ddram[ROW_ADDRESS[row] + column];
+}
+
+bool LcdModel::Shows(const char* row0, const char* row1)
+{
+	return memcmp(&ddram[ROW_ADDRESS[0]], row0, 16) == 0 && memcmp(&ddram[ROW_ADDRESS[1]], row1, 16) == 0;
+}
+
+bool LcdModel::OffScreenBlank()
+{
+	for (uint8_t row = 0; row < 2; row++)
+	{
+		for (uint8_t column = 16; column < 0x28; column++)
+		{
+			if (ddram[ROW_ADDRESS[row] + column] != ' ')
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
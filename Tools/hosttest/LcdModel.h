@@ -0,0 +1,27 @@
+#ifndef _LCD_MODEL_h
+#define _LCD_MODEL_h
+
+// An HD44780 behind a PCF8574, wired as on the lockbox's backpack, for the tests that link Display. It reads back what the
+// shim's Wire has sent and keeps the characters the LCD would hold, so a test can check what is on the screen rather than
+// how it got there.
+#include <Arduino.h>
+#include <Wire.h>
+
+class LcdModel
+{
+public:
+	static uint32_t Commands; // Taken in since the last Reset.
+	static uint32_t Characters;
+
+	// Powered on, before begin(): in 8 bit mode, with every cell blank.
+	static void Reset();
+	// Takes in everything sent since the last call.
+	static void Update();
+	static char Cell(uint8_t row, uint8_t column);
+	// Whether the two 16 character rows shown are row0 and row1.
+	static bool Shows(const char* row0, const char* row1);
+	// Whether the cells past the 16th column of each line, which the LCD holds but doesn't show, are still blank.
+	static bool OffScreenBlank();
+};
+
+#endif
@@ -0,0 +1,262 @@
+// Host check of MotionPredictor against walked tracks. Each track is a set of legs at a steady speed and heading, sampled
+// every 10 ms. A 1 Hz GGA+RMC stream is made from it, with the slowly wandering position error, speed noise and course
+// noise of a real receiver, and parsed with NMEAGPS. Every 250 ms, as the display refreshes, the distance to a target is
+// compared with the true distance for:
+//   - the averaged position, as shown before the predictor;
+//   - the last fix;
+//   - MotionPredictor::GetDistanceDm, which is what Physical::GetDistanceFromPoint shows while moving.
+// The run fails if the prediction isn't closer than the last fix on the moving tracks, or if GetDistanceDm strays from the
+// great circle distance to Predict's position. Spot checks cover the trig table, the antimeridian, the horizon and a
+// target out of the local grid's range.
+#include <random>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <NMEAGPS.h>
+#include "PositionEstimator.h"
+#include "MotionPredictor.h"
+
+static const double ORIGIN_LAT = -36.8485; // As in genlog.py.
+static const double ORIGIN_LON = 174.7633;
+static const double M_PER_DEG = 111320.0;
+static const double FIX_DELAY_S = 0.25; // From the PPS edge to the end of the second's sentences.
+
+struct Leg
+{
+	double Speed; // m/s
+	double Heading; // degrees
+	double Seconds;
+};
+
+struct ErrorStats
+{
+	double Sum = 0;
+	double SumSquares = 0;
+	double Worst = 0;
+	int Count = 0;
+
+	void Add(double error)
+	{
+		error = fabs(error);
+		Sum += error;
+		SumSquares += error * error;
+		Worst = max(Worst, error);
+		Count++;
+	}
+	double Rms() const { return sqrt(SumSquares / Count); }
+};
+
+static NMEAGPS gps;
+static int failures = 0;
+static double worstDisagreementM = 0;
+
+static std::string Sentence(const char* body)
+{
+	uint8_t check = 0;
+	for (const char* p = body; *p; p++)
+	{
+		check ^= *p;
+	}
+	char line[160];
+	snprintf(line, sizeof(line), "$%s*%02X\r\n", body, check);
+	return line;
+}
+
+// Degrees and minutes, as NMEA writes them.
+static void DegreesMinutes(double degrees, bool latitude, char* text, char* hemisphere)
+{
+	*hemisphere = latitude ? (degrees >= 0 ? 'N' : 'S') : (degrees >= 0 ? 'E' : 'W');
+	degrees = fabs(degrees);
+	int whole = (int)degrees;
+	sprintf(text, latitude ? "%02d%08.5f" : "%03d%08.5f", whole, (degrees - whole) * 60);
+}
+
+static NeoGPS::Location_t LocationAt(double northM, double eastM)
+{
+	return NeoGPS::Location_t((int32_t)lround((ORIGIN_LAT + northM / M_PER_DEG) * 1e7),
+		(int32_t)lround((ORIGIN_LON + eastM / (M_PER_DEG * cos(ORIGIN_LAT * M_PI / 180))) * 1e7));
+}
+
+// In double precision, where NeoGPS's DistanceKm is float.
+static double HaversineM(const NeoGPS::Location_t& from, const NeoGPS::Location_t& to)
+{
+	double lat1 = from.lat() * 1e-7 * M_PI / 180;
+	double lat2 = to.lat() * 1e-7 * M_PI / 180;
+	double dLon = (to.lon() - (double)from.lon()) * 1e-7 * M_PI / 180;
+	double a = sq(sin((lat2 - lat1) / 2)) + cos(lat1) * cos(lat2) * sq(sin(dLon / 2));
+	return 2 * 6371009.0 * asin(sqrt(a));
+}
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void Walk(const char* name, const Leg* legs, int legCount, double targetNorthM, double targetEastM, unsigned seed, bool moving)
+{
+	std::mt19937 random(seed);
+	std::normal_distribution<double> gaussian(0, 1);
+	std::vector<double> trueNorth, trueEast, trueSpeed, trueHeading;
+	double north = 0;
+	double east = 0;
+	for (int l = 0; l < legCount; l++)
+	{
+		for (int i = 0; i < legs[l].Seconds * 100; i++)
+		{
+			double heading = legs[l].Heading * M_PI / 180;
+			north += legs[l].Speed * cos(heading) / 100;
+			east += legs[l].Speed * sin(heading) / 100;
+			trueNorth.push_back(north);
+			trueEast.push_back(east);
+			trueSpeed.push_back(legs[l].Speed);
+			trueHeading.push_back(legs[l].Heading);
+		}
+	}
+	NeoGPS::Location_t target = LocationAt(targetNorthM, targetEastM);
+	PositionEstimator::Reset();
+	MotionPredictor::Reset();
+
+	ErrorStats averaged, last, predicted;
+	bool haveFix = false;
+	NeoGPS::Location_t lastFix;
+	double biasNorth = 0;
+	double biasEast = 0;
+	double wander = exp(-1 / 30.0); // The position error wanders with a time constant of 30 s.
+	int delay = FIX_DELAY_S * 100;
+	for (size_t at = 0; at < trueNorth.size(); at += 25)
+	{
+		if (at % 100 == (size_t)delay)
+		{
+			size_t edge = at - delay;
+			int second = edge / 100;
+			biasNorth = wander * biasNorth + gaussian(random) * 2.0 * sqrt(1 - wander * wander);
+			biasEast = wander * biasEast + gaussian(random) * 2.0 * sqrt(1 - wander * wander);
+			double fixNorth = trueNorth[edge] + biasNorth + gaussian(random) * 0.5;
+			double fixEast = trueEast[edge] + biasEast + gaussian(random) * 0.5;
+			double speed = fmax(0.0, trueSpeed[edge] + gaussian(random) * 0.15);
+			double course = fmod(trueHeading[edge] + gaussian(random) * (speed > 0.3 ? 8.0 / speed : 120.0) + 720, 360);
+			char lat[20], lon[20], time[32], body[160];
+			char ns, ew;
+			DegreesMinutes(ORIGIN_LAT + fixNorth / M_PER_DEG, true, lat, &ns);
+			DegreesMinutes(ORIGIN_LON + fixEast / (M_PER_DEG * cos(ORIGIN_LAT * M_PI / 180)), false, lon, &ew);
+			snprintf(time, sizeof(time), "%02d%02d%02d.00", second / 3600, (second / 60) % 60, second % 60);
+			std::string sentences;
+			snprintf(body, sizeof(body), "GPGGA,%s,%s,%c,%s,%c,1,08,1.10,30.0,M,0.0,M,,", time, lat, ns, lon, ew);
+			sentences += Sentence(body);
+			snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%c,%s,%c,%.3f,%.2f,010130,,,A", time, lat, ns, lon, ew, speed / 0.514444, course);
+			sentences += Sentence(body);
+			for (char c : sentences)
+			{
+				gps.handle(c);
+			}
+			while (gps.available())
+			{
+				gps_fix fix = gps.read();
+				PositionEstimator::Add(fix);
+				MotionPredictor::Add(fix, (uint32_t)edge * 10000);
+				lastFix = fix.location;
+				haveFix = true;
+			}
+		}
+		if (!haveFix)
+		{
+			continue;
+		}
+		uint32_t now = (uint32_t)at * 10000;
+		double trueM = LocationAt(trueNorth[at], trueEast[at]).DistanceKm(target) * 1000;
+		double lastFixM = lastFix.DistanceKm(target) * 1000;
+		averaged.Add(PositionEstimator::GetDistanceDm(target) / 10.0 - trueM);
+		last.Add(lastFixM - trueM);
+		if (MotionPredictor::IsMoving())
+		{
+			double predictedM = MotionPredictor::GetDistanceDm(target, now) / 10.0;
+			predicted.Add(predictedM - trueM);
+			worstDisagreementM = max(worstDisagreementM, fabs(predictedM - HaversineM(MotionPredictor::Predict(now), target)));
+		}
+		else
+		{
+			predicted.Add(lastFixM - trueM);
+		}
+	}
+	printf("%s,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", name, averaged.Sum / averaged.Count, averaged.Rms(), averaged.Worst,
+		last.Sum / last.Count, last.Rms(), last.Worst, predicted.Sum / predicted.Count, predicted.Rms(), predicted.Worst);
+	if (moving && predicted.Rms() >= last.Rms())
+	{
+		printf("FAIL: %s: the prediction is no closer than the last fix\n", name);
+		failures++;
+	}
+}
+
+static gps_fix MovingFix(int32_t lat, int32_t lon, uint16_t knots, uint16_t heading)
+{
+	gps_fix fix;
+	fix.init();
+	fix.location = NeoGPS::Location_t(lat, lon);
+	fix.valid.location = true;
+	fix.spd.whole = knots;
+	fix.spd.frac = 0;
+	fix.valid.speed = true;
+	fix.hdg.whole = heading;
+	fix.hdg.frac = 0;
+	fix.valid.heading = true;
+	return fix;
+}
+
+static void SpotChecks()
+{
+	double worstSine = 0;
+	for (int32_t centidegrees = -36000; centidegrees <= 72000; centidegrees += 7)
+	{
+		worstSine = max(worstSine, fabs(MotionPredictor::Sine(centidegrees) / 32768.0 - sin(centidegrees * M_PI / 18000)));
+	}
+	printf("  worst sine error %.6f\n", worstSine);
+	Expect("sine within 2e-4", worstSine < 2e-4);
+
+	gps_fix fix = MovingFix(600000000L, 1799999000L, 10, 90);
+	MotionPredictor::Add(fix, 0);
+	NeoGPS::Location_t p = MotionPredictor::Predict(4000000);
+	double moved = NeoGPS::Location_t::DistanceKm(fix.location, p) * 1000;
+	printf("  10 kn east for 4 s at 60N across the antimeridian: %.2f m, lon %ld\n", moved, (long)p.lon());
+	Expect("extrapolates 20.58 m and wraps the longitude", fabs(moved - 20.58) < 0.1 && p.lon() < -1799990000L);
+	Expect("measures from across the antimeridian", abs((int32_t)MotionPredictor::GetDistanceDm(fix.location, 4000000) - 206) <= 2);
+	p = MotionPredictor::Predict(60000000);
+	Expect("stops at the horizon", fabs(NeoGPS::Location_t::DistanceKm(fix.location, p) * 1000 - 25.72) < 0.1);
+
+	// 0.03 degrees east on the equator is 3.3 km, past the local grid, and would overflow it.
+	MotionPredictor::Add(MovingFix(0, 1000000000L, 10, 0), 0);
+	NeoGPS::Location_t farTarget(0, 1000300000L);
+	double farM = MotionPredictor::GetDistanceDm(farTarget, 1000000) / 10.0;
+	double farExpectedM = MotionPredictor::Predict(1000000).DistanceKm(farTarget) * 1000;
+	Expect("a target out of range is measured in floating point", fabs(farM - farExpectedM) < 0.2);
+
+	fix.spd.whole = 0;
+	fix.spd.frac = 500;
+	MotionPredictor::Add(fix, 0);
+	Expect("slower than the threshold is standing still", !MotionPredictor::IsMoving());
+}
+
+int main()
+{
+	static const Leg walk[] = { { 1.4, 45, 120 }, { 1.4, 135, 90 }, { 0, 0, 30 }, { 1.3, 260, 120 }, { 1.5, 10, 60 } };
+	static const Leg jog[] = { { 3.0, 90, 60 }, { 3.0, 0, 60 }, { 3.0, 270, 60 }, { 3.0, 180, 60 } };
+	static const Leg wander[] = { { 1.0, 0, 20 }, { 1.0, 60, 20 }, { 1.0, 120, 20 }, { 1.0, 180, 20 }, { 1.0, 240, 20 }, { 1.0, 300, 20 }, { 0, 0, 60 } };
+	static const Leg cycle[] = { { 5.5, 30, 120 }, { 5.5, 300, 120 }, { 5.5, 200, 120 } };
+	static const Leg still[] = { { 0, 0, 300 } };
+
+	printf("track,averaged mean m,rms,worst,last fix mean m,rms,worst,predicted mean m,rms,worst\n");
+	Walk("walk with a stop", walk, 5, 150, 250, 1, true);
+	Walk("jog round a block", jog, 4, 100, 100, 2, true);
+	Walk("slow wander then stop", wander, 7, 30, -40, 3, true);
+	Walk("cycle", cycle, 3, 500, 200, 4, true);
+	Walk("standing still", still, 1, 60, 20, 5, false);
+	printf("  worst difference from the great circle distance %.2f m\n", worstDisagreementM);
+	Expect("integer distance within 0.3 m of the great circle", worstDisagreementM < 0.3); // The display shows whole meters.
+
+	SpotChecks();
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+// Host build of NeoGPS's NMEAlogBenchmark: replays a recorded NMEA log file of any size through the parser and reports the
+// parsing cost of each sentence type. Lines are handled as the sketch does, but timed with the host's clock, so the figures
+// compare one parser change against another rather than predict AVR cycles.
+//
+// The whole log is then parsed again two ways, one character at a time and through handle(buf, len) in CHUNK_SIZE pieces,
+// to compare their throughput. Both must complete the same fixes with the same statistics, or the exit status is 1.
+//
+//     NMEAlogBenchmark capture.nmea
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <NMEAGPS.h>
+
+static NMEAGPS gps;
+
+static const size_t LINE_MAX = 96; // As in the sketch. Longer lines are counted in the UNK row without being timed.
+static const size_t CHUNK_SIZE = 64; // Roughly what a serial RX buffer holds.
+
+struct SentenceCost
+{
+	uint32_t Sentences;
+	uint64_t Chars;
+	uint64_t Nanoseconds;
+};
+
+static SentenceCost costs[NMEAGPS::NMEAMSG_END];
+static uint32_t fixes = 0;
+
+static void TimeLine(const char* line, size_t length)
+{
+	uint8_t row = NMEAGPS::NMEA_UNKNOWN;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < length; i++)
+	{
+		// The trailing CR/LF reset nmeaMessage, so remember it now.
+		if (gps.handle(line[i]) == NMEAGPS::DECODE_COMPLETED)
+		{
+			row = gps.nmeaMessage;
+		}
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	while (gps.available())
+	{
+		gps.read();
+		fixes++;
+	}
+	costs[row].Sentences++;
+	costs[row].Chars += length;
+	costs[row].Nanoseconds += elapsed;
+}
+
+static void Report()
+{
+	SentenceCost total = { 0, 0, 0 };
+	printf("type,sentences,chars,ns,ns/sentence,ns/char\n");
+	for (uint8_t i = NMEAGPS::NMEA_UNKNOWN; i < NMEAGPS::NMEAMSG_END; i++)
+	{
+		const SentenceCost& cost = costs[i];
+		if (cost.Sentences != 0)
+		{
+			printf("%s,%u,%llu,%llu,%.1f,%.2f\n", (const char*)gps.string_for((NMEAGPS::nmea_msg_t)i), cost.Sentences,
+				(unsigned long long)cost.Chars, (unsigned long long)cost.Nanoseconds, (double)cost.Nanoseconds / cost.Sentences,
+				cost.Chars ? (double)cost.Nanoseconds / cost.Chars : 0.0);
+		}
+		if (i != NMEAGPS::NMEA_UNKNOWN)
+		{
+			total.Sentences += cost.Sentences;
+		}
+		total.Chars += cost.Chars;
+		total.Nanoseconds += cost.Nanoseconds;
+	}
+	if (total.Nanoseconds)
+	{
+		printf("parser bytes/s = %.0f\n", total.Chars * 1e9 / total.Nanoseconds);
+		printf("parser sentences/s = %.0f\n", total.Sentences * 1e9 / total.Nanoseconds);
+	}
+	printf("fixes = %u\n", fixes);
+#ifdef NMEAGPS_STATS
+	printf("stats: ok %u, errors %u, chars %lu\n", gps.statistics.ok, gps.statistics.errors, (unsigned long)gps.statistics.chars);
+#endif
+}
+
+struct WholeLogResult
+{
+	uint32_t Fixes;
+	uint64_t Nanoseconds;
+	uint32_t Ok;
+	uint32_t Errors;
+};
+
+static WholeLogResult ParseWholeLog(NMEAGPS& parser, const std::vector<uint8_t>& log, bool spans)
+{
+	WholeLogResult result = { 0, 0, 0, 0 };
+	auto start = std::chrono::steady_clock::now();
+	if (spans)
+	{
+		for (size_t i = 0; i < log.size(); i += CHUNK_SIZE)
+		{
+			result.Fixes += parser.handle(&log[i], min(CHUNK_SIZE, log.size() - i));
+		}
+	}
+	else
+	{
+		for (uint8_t c : log)
+		{
+			if (parser.handle(c) == NMEAGPS::DECODE_COMPLETED && parser.nmeaMessage == LAST_SENTENCE_IN_INTERVAL)
+			{
+				result.Fixes++;
+			}
+		}
+	}
+	result.Nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+#ifdef NMEAGPS_STATS
+	result.Ok = parser.statistics.ok;
+	result.Errors = parser.statistics.errors;
+#endif
+	return result;
+}
+
+static bool CompareWholeLog(const std::vector<uint8_t>& log)
+{
+	static NMEAGPS charParser;
+	static NMEAGPS spanParser;
+	WholeLogResult chars = ParseWholeLog(charParser, log, false);
+	WholeLogResult spans = ParseWholeLog(spanParser, log, true);
+	printf("whole log,fixes,ok,errors,MB/s\n");
+	printf("per char,%u,%u,%u,%.1f\n", chars.Fixes, chars.Ok, chars.Errors, log.size() * 1e3 / chars.Nanoseconds);
+	printf("spans of %u,%u,%u,%u,%.1f\n", (unsigned)CHUNK_SIZE, spans.Fixes, spans.Ok, spans.Errors, log.size() * 1e3 / spans.Nanoseconds);
+	bool same = chars.Fixes == spans.Fixes && chars.Ok == spans.Ok && chars.Errors == spans.Errors;
+	if (!same)
+	{
+		printf("FAIL: handle(buf, len) and handle(c) disagree\n");
+	}
+	return same;
+}
+
+int main(int argc, char** argv)
+{
+	FILE* log = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+	if (!log)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	std::vector<uint8_t> whole;
+	char line[LINE_MAX];
+	size_t lineLength = 0;
+	bool lineTooLong = false;
+	int c;
+	while ((c = getc(log)) != EOF)
+	{
+		whole.push_back(c);
+		if (lineLength < LINE_MAX)
+		{
+			line[lineLength++] = c;
+		}
+		else
+		{
+			lineTooLong = true;
+		}
+		if (c == '\n')
+		{
+			if (lineTooLong)
+			{
+				costs[NMEAGPS::NMEA_UNKNOWN].Sentences++;
+				gps.reset();
+			}
+			else
+			{
+				TimeLine(line, lineLength);
+			}
+			lineLength = 0;
+			lineTooLong = false;
+		}
+	}
+	if (lineLength)
+	{
+		TimeLine(line, lineLength); // The last line had no terminator.
+	}
+	Report();
+	return CompareWholeLog(whole) ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+// Host run of NeoGPS's NMEAtest sketch, built from a copy of the library with every sentence and fix member enabled. The
+// sketch's output is printed without its CRs, and without the object sizes, which change with the parser's members and
+// aren't parsing results. make test compares it with NMEAtest.expected, the output of the parser before the field tables.
+#include <string>
+#include <stdio.h>
+
+extern std::string hostSerialOutput;
+
+void setup();
+void loop();
+
+int main()
+{
+	setup();
+	loop();
+	size_t start = 0;
+	while (start < hostSerialOutput.size())
+	{
+		size_t end = hostSerialOutput.find('\n', start);
+		end = (end == std::string::npos) ? hostSerialOutput.size() : end + 1;
+		std::string line = hostSerialOutput.substr(start, end - start);
+		start = end;
+		if (line.find("object size") != std::string::npos)
+		{
+			continue;
+		}
+		for (char c : line)
+		{
+			if (c != '\r')
+			{
+				putchar(c);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,154 @@
+// Host replay of jittery NMEA logs through the lockbox's PositionEstimator. Each log is from a receiver standing still a
+// known distance from a FENCE_RADIUS_M fence, as genlog.py stand writes them, with the distance in the file name
+// (stand_31m.nmea). Every log is replayed from a start point every START_STEP fixes, as if the box booted there, and the
+// decision the estimator reaches is compared with deciding on the first fix alone.
+//
+//     PositionReplay stand_05m.nmea stand_31m.nmea ...
+//
+// The run fails if the estimator is wrong more often than single fixes, or if it is ever confidently wrong (before
+// ESTIMATE_MAX_FIXES) for a receiver more than CLEAR_OF_BOUNDARY_M from the boundary. It also checks that a fix out of
+// the estimator's range starts a new window rather than being averaged in.
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <NMEAGPS.h>
+#include "PositionEstimator.h"
+
+static const double ORIGIN_LAT = -36.8485; // As in genlog.py.
+static const double ORIGIN_LON = 174.7633;
+static const uint16_t FENCE_RADIUS_M = 30; // WITHIN_RADIUS_METERS
+static const int START_STEP = 7;
+static const double CLEAR_OF_BOUNDARY_M = 10;
+
+static NMEAGPS gps;
+
+static std::vector<gps_fix> Load(const char* path)
+{
+	std::vector<gps_fix> fixes;
+	FILE* log = fopen(path, "rb");
+	if (!log)
+	{
+		perror(path);
+		exit(2);
+	}
+	int c;
+	while ((c = getc(log)) != EOF)
+	{
+		gps.handle((uint8_t)c);
+		while (gps.available())
+		{
+			fixes.push_back(gps.read());
+		}
+	}
+	fclose(log);
+	return fixes;
+}
+
+static gps_fix FixAt(double lat, double lon)
+{
+	gps_fix fix;
+	fix.location = NeoGPS::Location_t(lat, lon);
+	fix.valid.location = true;
+	fix.hdop = 900;
+	fix.valid.hdop = true;
+	return fix;
+}
+
+// A fix just outside the range east of the window's origin, on the equator where longitude units are longest, must start
+// a new window at itself. Scaling it to decimeters overflowed 32 bits when only MAX_LOCAL_LON_UNITS was checked.
+static bool CheckFarFixRestarts()
+{
+	bool ok = true;
+	for (double eastDegrees : { 0.03, 0.04, 0.05 })
+	{
+		PositionEstimator::Reset();
+		for (int i = 0; i < ESTIMATE_WINDOW; i++)
+		{
+			PositionEstimator::Add(FixAt(0, 100));
+		}
+		gps_fix far = FixAt(0, 100 + eastDegrees);
+		PositionEstimator::Add(far);
+		int32_t lon = PositionEstimator::GetLocation().lon();
+		if (PositionEstimator::GetKeptCount() != 1 || lon != far.location.lon())
+		{
+			printf("FAIL: a fix %.2f degrees east was averaged in, giving longitude %.7f\n", eastDegrees, lon * 1e-7);
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	NeoGPS::Geofence_t fence(NeoGPS::Location_t(ORIGIN_LAT, ORIGIN_LON), FENCE_RADIUS_M);
+	uint32_t totalBoots = 0;
+	uint32_t totalSingleWrong = 0;
+	uint32_t totalEstimatorWrong = 0;
+	uint32_t clearConfidentWrong = 0;
+	printf("log,boots,single fix wrong %%,estimator wrong %%,wrong before the cap,mean fixes,max fixes,decided by the cap\n");
+	for (int a = 1; a < argc; a++)
+	{
+		const char* name = strrchr(argv[a], '/') ? strrchr(argv[a], '/') + 1 : argv[a];
+		double distanceM;
+		if (sscanf(name, "stand_%lfm", &distanceM) != 1)
+		{
+			fprintf(stderr, "%s: the name must give the distance, as stand_31m.nmea\n", argv[a]);
+			return 2;
+		}
+		bool inside = distanceM <= FENCE_RADIUS_M;
+		std::vector<gps_fix> fixes = Load(argv[a]);
+
+		uint32_t boots = 0;
+		uint32_t singleWrong = 0;
+		uint32_t estimatorWrong = 0;
+		uint32_t confidentWrong = 0;
+		uint32_t byCap = 0;
+		uint32_t fixesUsed = 0;
+		uint32_t maxUsed = 0;
+		for (size_t start = 0; start + ESTIMATE_MAX_FIXES < fixes.size(); start += START_STEP)
+		{
+			boots++;
+			if (fence.contains(fixes[start].location) != inside)
+			{
+				singleWrong++;
+			}
+			PositionEstimator::Reset();
+			positionDecision decision = decisionPending;
+			uint32_t used = 0;
+			while (decision == decisionPending)
+			{
+				PositionEstimator::Add(fixes[start + used++]);
+				decision = PositionEstimator::DecideWithin(fence.center(), fence.radiusM());
+			}
+			if (used >= ESTIMATE_MAX_FIXES)
+			{
+				byCap++;
+			}
+			if ((decision == decisionInside) != inside)
+			{
+				estimatorWrong++;
+				if (used < ESTIMATE_MAX_FIXES)
+				{
+					confidentWrong++;
+				}
+			}
+			fixesUsed += used;
+			maxUsed = max(maxUsed, used);
+		}
+		printf("%s,%u,%.1f,%.1f,%u,%.1f,%u,%u\n", name, boots, 100.0 * singleWrong / boots, 100.0 * estimatorWrong / boots,
+			confidentWrong, (double)fixesUsed / boots, maxUsed, byCap);
+		totalBoots += boots;
+		totalSingleWrong += singleWrong;
+		totalEstimatorWrong += estimatorWrong;
+		if (fabs(distanceM - FENCE_RADIUS_M) > CLEAR_OF_BOUNDARY_M)
+		{
+			clearConfidentWrong += confidentWrong;
+		}
+	}
+	printf("all: %u boots, single fix wrong %u, estimator wrong %u, confidently wrong clear of the boundary %u\n", totalBoots,
+		totalSingleWrong, totalEstimatorWrong, clearConfidentWrong);
+
+	bool ok = CheckFarFixRestarts() && totalEstimatorWrong < totalSingleWrong && clearConfidentWrong == 0;
+	printf("%s\n", ok ? "ok" : "FAIL");
+	return ok ? 0 : 1;
+}
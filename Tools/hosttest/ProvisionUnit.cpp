@@ -0,0 +1,115 @@
+// A lockbox in configure mode on a PC, for Tools/test_provision.py. Setup::Initialize runs against stdin and stdout in place
+// of the USB serial port, and the EEPROM is kept in a file between runs, so a test can send a unit several messages in turn.
+//
+//     ProvisionUnit eeprom.bin          run setup, as RunConfigureUnit does
+//     ProvisionUnit eeprom.bin dump     print the stored game in provision.py's game file format
+//
+// Setup waits for more input after a NAK, as the unit does, so the run ends when stdin is closed. The EEPROM is saved then.
+#include <string>
+#include <stdio.h>
+#include <unistd.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "Setup.h"
+
+extern std::string hostSerialInput;
+extern std::string hostSerialOutput;
+
+static const char* eepromPath;
+
+static void FlushOutput()
+{
+	fwrite(hostSerialOutput.data(), 1, hostSerialOutput.size(), stdout);
+	fflush(stdout);
+	hostSerialOutput.clear();
+}
+
+static void LoadEeprom()
+{
+	memset(EEPROM.Bytes, 0xFF, sizeof(EEPROM.Bytes)); // As an erased part reads.
+	FILE* file = fopen(eepromPath, "rb");
+	if (file)
+	{
+		fread(EEPROM.Bytes, 1, sizeof(EEPROM.Bytes), file);
+		fclose(file);
+	}
+}
+
+static void SaveEeprom()
+{
+	FILE* file = fopen(eepromPath, "wb");
+	if (!file || fwrite(EEPROM.Bytes, 1, sizeof(EEPROM.Bytes), file) != sizeof(EEPROM.Bytes))
+	{
+		perror(eepromPath);
+		exit(1);
+	}
+	fclose(file);
+}
+
+// Blocks for the next characters from the sender, as the sketch's busy loops do for the serial port.
+static void ReadStdin()
+{
+	FlushOutput();
+	char buffer[256];
+	ssize_t length = ::read(0, buffer, sizeof(buffer));
+	if (length <= 0)
+	{
+		SaveEeprom();
+		exit(0);
+	}
+	hostSerialInput.append(buffer, length);
+}
+
+static void PrintTime(time_t t)
+{
+	tmElements_t tm;
+	breakTime(t, tm);
+	printf("%04d-%02d-%02dT%02d:%02d:%02d\n", tmYearToCalendar(tm.Year), tm.Month, tm.Day, tm.Hour, tm.Minute, tm.Second);
+}
+
+static void PrintCoordinate(int32_t units)
+{
+	uint32_t magnitude = (units < 0) ? -(uint32_t)units : units;
+	printf("%c%u.%07u\n", (units < 0) ? '-' : '+', (unsigned)(magnitude / 10000000UL), (unsigned)(magnitude % 10000000UL));
+}
+
+static int Dump()
+{
+	if (!Setup::LoadConfigFromEEPROM())
+	{
+		printf("# no game stored\n");
+		return 1;
+	}
+	PrintTime(Setup::GetGameStartDateTime());
+	for (uint8_t point = 0; point < Setup::GetTotalPointCount(); point++)
+	{
+		latLongLocation location = Setup::GetCurrentPointLocation();
+		PrintCoordinate(location.latitude);
+		PrintCoordinate(location.longitude);
+		PrintTime(Setup::GetCurrentPointWindowOpenTime());
+		printf("%u\n", (unsigned)((Setup::GetCurrentPointWindowCloseTime() - Setup::GetCurrentPointWindowOpenTime()) / 60));
+		Setup::ProgressToNextPoint();
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: ProvisionUnit eeprom.bin [dump]\n");
+		return 2;
+	}
+	eepromPath = argv[1];
+	LoadEeprom();
+	if (argc > 2)
+	{
+		return Dump();
+	}
+
+	hostSerialRefill = ReadStdin;
+	bool configured = Setup::Initialize();
+	FlushOutput();
+	SaveEeprom();
+	return configured ? 0 : 1;
+}
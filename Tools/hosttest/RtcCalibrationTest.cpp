@@ -0,0 +1,117 @@
+// Host check of Temporal::CalibrateFromGps against a simulated DS1307 and PPS (SimulatedClock), for RTCs from 150 ppm slow
+// to 87 ppm fast, with millis() running up to 2000 ppm off and up to 1 ms of jitter on the edges. Each unit starts with its
+// RTC 17 s behind and part way through a second. The short, sampled calibration must find the offset and the drift to
+// within 2.5 ppm, and a second calibration a month later, over the long baseline, to within 0.1 ppm, so that a year on
+// the model is within 4 s of UTC.
+// Without a PPS, or with an RTC that can't be read or has stopped, calibration must give up promptly and leave the drift.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Physical.h"
+#define private public // To start each case from a fresh unit.
+#include "Temporal.h"
+#undef private
+#include "SimulatedClock.h"
+
+static int failures = 0;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void FreshUnit()
+{
+	SimulatedClock::Reset();
+	Temporal::modelLoaded = false;
+	Temporal::anchorChecked = false;
+	Temporal::snapshotValid = false;
+	Temporal::anchorTime = 0;
+}
+
+// The model's error against UTC, in seconds.
+static double ModelError()
+{
+	return (double)Temporal::GetDateTimeInUtc() - SimulatedClock::UtcNow();
+}
+
+static void CheckCalibration(double rtcPpm, double mcuPpm, double jitterMicros)
+{
+	FreshUnit();
+	SimulatedClock::RtcPpm = rtcPpm;
+	SimulatedClock::McuPpm = mcuPpm;
+	SimulatedClock::PpsJitterMicros = jitterMicros;
+	SimulatedClock::Advance(3.37e6);
+	SimulatedClock::SetRtc(SimulatedClock::UTC_START - 17, 0.42);
+	Temporal::Resync();
+
+	int32_t offset;
+	double start = SimulatedClock::TrueMicros;
+	bool ok = Temporal::CalibrateFromGps(offset);
+	double minutes = (SimulatedClock::TrueMicros - start) / 60e6;
+	double shortError = Temporal::GetDriftCentiPpm() / 100.0 - rtcPpm;
+	SimulatedClock::Advance(30 * 86400e6);
+	double monthError = ModelError();
+
+	int32_t laterOffset;
+	bool laterOk = Temporal::CalibrateFromGps(laterOffset);
+	double longError = Temporal::GetDriftCentiPpm() / 100.0 - rtcPpm;
+	SimulatedClock::Advance(365 * 86400e6);
+	double yearError = ModelError();
+
+	char name[80];
+	snprintf(name, sizeof(name), "rtc %+7.2f ppm, mcu %+5.0f ppm, jitter %4.0f us", rtcPpm, mcuPpm, jitterMicros);
+	printf("  %s: offset %d s in %.1f min, drift error %.2f ppm, month %+.0f s, long %.2f ppm, year %+.0f s\n", name, offset,
+		minutes, shortError, monthError, longError, yearError);
+	// Set 17 s behind UTC 3.37 s in, and 0.42 s into its own second, the RTC is 19.95 s behind: -20 to the nearest second.
+	Expect(name, ok && laterOk && offset == -20 && fabs(shortError) < 2.5 && fabs(longError) < 0.1 && fabs(yearError) <= 4);
+}
+
+// Calibration must return within a few seconds, without setting the RTC or touching the model.
+static void CheckRefused(const char* name)
+{
+	int16_t drift = Temporal::GetDriftCentiPpm();
+	uint32_t rtcWrites = SimulatedClock::RtcWrites;
+	double start = SimulatedClock::TrueMicros;
+	int32_t offset;
+	bool ok = Temporal::CalibrateFromGps(offset);
+	double seconds = (SimulatedClock::TrueMicros - start) / 1e6;
+	printf("  %s: gave up after %.2f s\n", name, seconds);
+	Expect(name, !ok && seconds < 3 && Temporal::GetDriftCentiPpm() == drift && SimulatedClock::RtcWrites == rtcWrites);
+}
+
+int main()
+{
+	srand(1);
+	static const double rtcCases[] = { 0, 23.0, -41.5, 87.3, -150.0 };
+	static const double mcuCases[] = { 0, 500, -2000 };
+	for (double rtcPpm : rtcCases)
+	{
+		for (double mcuPpm : mcuCases)
+		{
+			CheckCalibration(rtcPpm, mcuPpm, 0);
+			CheckCalibration(rtcPpm, mcuPpm, 1000);
+		}
+	}
+
+	SimulatedClock::PpsPresent = false;
+	CheckRefused("no PPS: refused, drift unchanged");
+	SimulatedClock::PpsPresent = true;
+
+	FreshUnit();
+	SimulatedClock::SetRtc(SimulatedClock::UTC_START - 17, 0.42);
+	SimulatedClock::RtcFailing = true;
+	CheckRefused("RTC reads failing: refused, drift unchanged");
+
+	FreshUnit();
+	SimulatedClock::SetRtc(SimulatedClock::UTC_START - 17, 0.42);
+	SimulatedClock::RtcStopped = true;
+	CheckRefused("RTC stopped: refused within the tick timeout");
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
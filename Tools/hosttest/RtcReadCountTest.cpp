@@ -0,0 +1,127 @@
+// Host check of Temporal's cached RTC time, counting the DS1307 reads SimulatedClock is asked for.
+//   - A hot loop asking every query 100 times a second must read the RTC once, and then once per RTC_RESYNC_MS;
+//   - Resync and GetDateTimeInUtc must each read it exactly once;
+//   - with a fix every second, AnchorToGps must read it at most twice per CLOCK_REANCHOR_INTERVAL_MS, once to check the
+//     fix and once to resync if the fix becomes the anchor;
+//   - between reads, the cached time must be at most a second behind the RTC, and with millis() up to 2000 ppm off, at
+//     most a second further either way.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Physical.h"
+#define private public // To restart the unit, and to see the cached time.
+#include "Temporal.h"
+#undef private
+#include "SimulatedClock.h"
+
+static const uint32_t LOOP_MS = 10;
+static const uint32_t RUN_SECONDS = 1800;
+
+static int failures = 0;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static void FreshUnit(double mcuPpm)
+{
+	SimulatedClock::Reset();
+	SimulatedClock::McuPpm = mcuPpm;
+	SimulatedClock::WindowOpen = SimulatedClock::UTC_START + 3600;
+	SimulatedClock::WindowClose = SimulatedClock::WindowOpen + 3600;
+	SimulatedClock::GameStart = SimulatedClock::UTC_START - 86400;
+	Temporal::modelLoaded = false;
+	Temporal::anchorChecked = false;
+	Temporal::snapshotValid = false;
+	Temporal::anchorTime = 0;
+}
+
+// The RTC as it stands, without counting the read.
+static time_t RtcNow()
+{
+	time_t rtcTime = RTC.get();
+	SimulatedClock::RtcReads--;
+	return rtcTime;
+}
+
+// Each pass asks everything the game's tasks ask, as often as the sketch's busiest loop would.
+static void CheckHotLoop(double mcuPpm)
+{
+	FreshUnit(mcuPpm);
+	uint32_t queries = 0;
+	int32_t worstBehind = 0;
+	int32_t worstAhead = 0;
+	while (SimulatedClock::TrueMicros < RUN_SECONDS * 1e6)
+	{
+		Temporal::IsGameStartReached();
+		Temporal::HasWindowOpened();
+		Temporal::HasWindowExpired();
+		Temporal::GetTimeUntilGameStart();
+		Temporal::GetTimeUntilWindowOpens();
+		Temporal::GetTimeUntilWindowClose();
+		queries += 6;
+		int32_t error = (int32_t)(Temporal::Now() - RtcNow());
+		worstBehind = min(worstBehind, error);
+		worstAhead = max(worstAhead, error);
+		SimulatedClock::Advance(LOOP_MS * 1000);
+	}
+	// Reads at the start and then each RTC_RESYNC_MS of millis(), which runs mcuPpm fast. The read that falls due is made at
+	// the next pass, so one more may have fallen due by the end than was made.
+	uint32_t due = (uint32_t)ceil(RUN_SECONDS * 1000 * (1 + mcuPpm * 1e-6) / RTC_RESYNC_MS);
+	char name[80];
+	snprintf(name, sizeof(name), "hot loop, millis %+5.0f ppm: one read per resync", mcuPpm);
+	printf("  %s: %u queries, %u reads, cached time %d to %+d s from the RTC\n", name, queries, SimulatedClock::RtcReads,
+		worstBehind, worstAhead);
+	Expect(name, SimulatedClock::RtcReads <= due && SimulatedClock::RtcReads + 1 >= due);
+	// The cached time is floored to the RTC's second when read, and millis() since floored again, so it is up to a second
+	// behind. A millis() running fast or slow can take it a second further either way before the next read.
+	snprintf(name, sizeof(name), "hot loop, millis %+5.0f ppm: cached time follows the RTC", mcuPpm);
+	Expect(name, worstBehind >= (mcuPpm < 0 ? -2 : -1) && worstAhead <= (mcuPpm > 0 ? 1 : 0));
+}
+
+static void CheckExplicitReads()
+{
+	FreshUnit(0);
+	Temporal::Now();
+	uint32_t reads = SimulatedClock::RtcReads;
+	Temporal::Resync();
+	Expect("Resync reads once", SimulatedClock::RtcReads == reads + 1);
+	Temporal::GetDateTimeInUtc();
+	Expect("GetDateTimeInUtc reads once", SimulatedClock::RtcReads == reads + 2);
+	Temporal::HasWindowExpired();
+	Expect("a query straight after reads nothing", SimulatedClock::RtcReads == reads + 2);
+}
+
+static void CheckAnchorReads()
+{
+	FreshUnit(0);
+	uint32_t anchorReads = 0;
+	for (uint32_t second = 0; second < RUN_SECONDS; second++)
+	{
+		uint32_t reads = SimulatedClock::RtcReads;
+		Temporal::AnchorToGps(SimulatedClock::UtcNow());
+		anchorReads += SimulatedClock::RtcReads - reads;
+		SimulatedClock::Advance(1e6);
+	}
+	uint32_t checks = (RUN_SECONDS * 1000 + CLOCK_REANCHOR_INTERVAL_MS - 1) / CLOCK_REANCHOR_INTERVAL_MS;
+	printf("  a fix every second for %u s: %u reads for %u checks\n", RUN_SECONDS, anchorReads, checks);
+	Expect("AnchorToGps reads only when it checks a fix", anchorReads <= 2 * checks);
+}
+
+int main()
+{
+	srand(1);
+	CheckHotLoop(0);
+	CheckHotLoop(2000);
+	CheckHotLoop(-2000);
+	CheckExplicitReads();
+	CheckAnchorReads();
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
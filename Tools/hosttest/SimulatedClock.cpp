@@ -0,0 +1,191 @@
+#include <math.h>
+#include <EEPROM.h>
+#include "Physical.h"
+#include "Setup.h"
+#include "SimulatedClock.h"
+
+double SimulatedClock::TrueMicros = 0;
+double SimulatedClock::RtcPpm = 0;
+double SimulatedClock::RtcSwingPpm = 0;
+double SimulatedClock::McuPpm = 0;
+double SimulatedClock::PpsJitterMicros = 0;
+bool SimulatedClock::PpsPresent = true;
+bool SimulatedClock::RtcFailing = false;
+bool SimulatedClock::RtcStopped = false;
+uint32_t SimulatedClock::RtcReads = 0;
+uint32_t SimulatedClock::RtcWrites = 0;
+time_t SimulatedClock::GameStart = 0;
+time_t SimulatedClock::WindowOpen = 0;
+time_t SimulatedClock::WindowClose = 0;
+
+static uint64_t mcuMicrosGiven = 0; // How far the shim's clock has been moved, in all.
+static uint64_t mcuOrigin = 0; // The shim's clock when TrueMicros was 0.
+static uint8_t edgeTotal = 0;
+static uint32_t edgeMcuMicros = 0;
+static time_t rtcBase = 0;
+static double rtcElapsedMicros = 0; // The RTC's own time since it was set.
+
+static double RtcPpmNow()
+{
+	return SimulatedClock::RtcPpm + SimulatedClock::RtcSwingPpm * sin(SimulatedClock::TrueMicros / 86400e6 * 2 * M_PI);
+}
+
+void SimulatedClock::Reset()
+{
+	hostManualClock = true;
+	memset(EEPROM.Bytes, 0xFF, sizeof(EEPROM.Bytes));
+	TrueMicros = 0;
+	RtcPpm = 0;
+	RtcSwingPpm = 0;
+	McuPpm = 0;
+	PpsJitterMicros = 0;
+	PpsPresent = true;
+	RtcFailing = false;
+	RtcStopped = false;
+	RtcReads = 0;
+	RtcWrites = 0;
+	mcuOrigin = mcuMicrosGiven;
+	edgeTotal = 0;
+	edgeMcuMicros = (uint32_t)mcuOrigin;
+	rtcBase = UTC_START;
+	rtcElapsedMicros = 0;
+}
+
+void SimulatedClock::Advance(double micros)
+{
+	double before = TrueMicros;
+	// A minute at a time, so the RTC follows its temperature swing.
+	while (micros > 0)
+	{
+		double step = min(micros, 60e6);
+		if (!RtcStopped)
+		{
+			rtcElapsedMicros += step * (1 + RtcPpmNow() * 1e-6);
+		}
+		TrueMicros += step;
+		micros -= step;
+	}
+
+	uint64_t mcuTarget = mcuOrigin + (uint64_t)(TrueMicros * (1 + McuPpm * 1e-6));
+	while (mcuMicrosGiven < mcuTarget)
+	{
+		uint32_t step = (uint32_t)min(mcuTarget - mcuMicrosGiven, (uint64_t)0x40000000UL);
+		hostAdvanceMicros(step);
+		mcuMicrosGiven += step;
+	}
+
+	double edges = floor(TrueMicros / 1e6) - floor(before / 1e6);
+	if (edges > 0)
+	{
+		edgeTotal += (uint8_t)fmod(edges, 256);
+		double jitter = PpsJitterMicros * ((rand() / (double)RAND_MAX) * 2 - 1);
+		double lastEdge = floor(TrueMicros / 1e6) * 1e6 + jitter;
+		edgeMcuMicros = (uint32_t)(mcuOrigin + (uint64_t)(lastEdge * (1 + McuPpm * 1e-6)));
+	}
+}
+
+time_t SimulatedClock::UtcNow()
+{
+	return UTC_START + (time_t)floor(TrueMicros / 1e6);
+}
+
+void SimulatedClock::SetRtc(time_t rtcTime, double phaseSeconds)
+{
+	rtcBase = rtcTime;
+	rtcElapsedMicros = phaseSeconds * 1e6;
+}
+
+bool DS1307RTC::exists = true;
+
+DS1307RTC::DS1307RTC()
+{
+}
+
+time_t DS1307RTC::get()
+{
+	SimulatedClock::RtcReads++;
+	SimulatedClock::Advance(SimulatedClock::RTC_READ_MICROS);
+	if (SimulatedClock::RtcFailing)
+	{
+		return 0;
+	}
+	return rtcBase + (time_t)floor(rtcElapsedMicros / 1e6);
+}
+
+// Writing the seconds restarts the DS1307's countdown, so the next tick is a whole second away.
+bool DS1307RTC::set(time_t t)
+{
+	SimulatedClock::RtcWrites++;
+	SimulatedClock::Advance(SimulatedClock::RTC_READ_MICROS);
+	if (SimulatedClock::RtcFailing)
+	{
+		return false;
+	}
+	SimulatedClock::SetRtc(t, 0);
+	return true;
+}
+
+bool DS1307RTC::read(tmElements_t& tm)
+{
+	time_t t = get();
+	breakTime(t, tm);
+	return t != 0;
+}
+
+bool DS1307RTC::write(tmElements_t& tm)
+{
+	return set(makeTime(tm));
+}
+
+unsigned char DS1307RTC::isRunning()
+{
+	return !SimulatedClock::RtcFailing && !SimulatedClock::RtcStopped;
+}
+
+void DS1307RTC::setCalibration(char)
+{
+}
+
+char DS1307RTC::getCalibration()
+{
+	return 0;
+}
+
+DS1307RTC RTC;
+
+// The fix for a second arrives 300 ms after its edge.
+bool Physical::GetUtcSecondStart(time_t& utcSecond, uint8_t& edgeCount)
+{
+	SimulatedClock::Advance((floor(SimulatedClock::TrueMicros / 1e6) + 1) * 1e6 + 300000 - SimulatedClock::TrueMicros);
+	if (!SimulatedClock::PpsPresent)
+	{
+		return false;
+	}
+	utcSecond = SimulatedClock::UtcNow();
+	edgeCount = edgeTotal;
+	return true;
+}
+
+// Each call stands for one pass of a polling loop. That is a few microseconds on the unit, but a year of simulated polling
+// would take minutes on the host.
+void Physical::GetLastPps(uint32_t& edgeMicros, uint8_t& edgeCount)
+{
+	SimulatedClock::Advance(SimulatedClock::PPS_POLL_MICROS);
+	edgeMicros = edgeMcuMicros;
+	edgeCount = SimulatedClock::PpsPresent ? edgeTotal : 0;
+}
+
+time_t Setup::GetGameStartDateTime()
+{
+	return SimulatedClock::GameStart;
+}
+
+time_t Setup::GetCurrentPointWindowOpenTime()
+{
+	return SimulatedClock::WindowOpen;
+}
+
+time_t Setup::GetCurrentPointWindowCloseTime()
+{
+	return SimulatedClock::WindowClose;
+}
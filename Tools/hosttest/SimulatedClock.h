@@ -0,0 +1,42 @@
+#ifndef _SIMULATED_CLOCK_h
+#define _SIMULATED_CLOCK_h
+
+// A DS1307, a GPS receiver's PPS output and the game's times on one simulated timeline, for the tests that link Temporal.
+// SimulatedClock.cpp stands in for DS1307RTC.cpp, for Physical's PPS methods and for Setup's game times, so Temporal is the
+// only lockbox module with clock logic in the program.
+//
+// True time only moves when a test calls Advance, or when the RTC or PPS is read, as the bus and the polling take time on
+// the unit. The shim's millis() and micros() follow it, running McuPpm fast.
+#include <Arduino.h>
+#include <DS1307RTC.h>
+
+class SimulatedClock
+{
+public:
+	static const time_t UTC_START = 1800000000; // 15 Jan 2027
+	static const uint32_t RTC_READ_MICROS = 600; // A DS1307 read or write at 100 kHz.
+	static const uint32_t PPS_POLL_MICROS = 250; // Between Physical::GetLastPps calls.
+
+	static double TrueMicros; // Since the simulation began.
+	static double RtcPpm; // How fast the RTC runs, on average.
+	static double RtcSwingPpm; // A daily temperature swing either side of RtcPpm.
+	static double McuPpm; // How fast millis() and micros() run.
+	static double PpsJitterMicros; // Each edge is up to this far either side of the true second.
+	static bool PpsPresent;
+	static bool RtcFailing; // Every read fails, as with a halted, unpowered or missing DS1307. DS1307RTC returns 0.
+	static bool RtcStopped; // Reads succeed but the seconds never move on.
+	static uint32_t RtcReads;
+	static uint32_t RtcWrites;
+	static time_t GameStart;
+	static time_t WindowOpen;
+	static time_t WindowClose;
+
+	// A fresh unit: erased EEPROM, an RTC set to UTC, no reads counted and nothing failing.
+	static void Reset();
+	static void Advance(double micros);
+	static time_t UtcNow();
+	// Sets the RTC to rtcTime, with its next tick phaseSeconds sooner than a fresh write would give.
+	static void SetRtc(time_t rtcTime, double phaseSeconds);
+};
+
+#endif
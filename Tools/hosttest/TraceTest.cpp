@@ -0,0 +1,89 @@
+// Host check of Trace, reading back what Dump prints to the serial port.
+//   - Dump must list the first time of each event that happened, in the enum's order, and no others;
+//   - an event happening again, or recorded late from an ISR's timestamp, must not move its first time;
+//   - after more events than the ring holds, Dump must list the last TRACE_RING_SIZE of them, oldest first;
+//   - Record without a time must stamp the event with millis().
+#include <string>
+#include <stdio.h>
+#include "Trace.h"
+
+extern std::string hostSerialOutput;
+
+static int failures = 0;
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static std::string DumpText()
+{
+	hostSerialOutput.clear();
+	Trace::Dump();
+	return hostSerialOutput;
+}
+
+int main()
+{
+	hostManualClock = true;
+
+	Expect("nothing recorded: only the headings", DumpText() == "TRACE first,ms\r\nTRACE recent,ms\r\n");
+
+	hostAdvanceMicros(120000);
+	Trace::Record(traceLcdInit);
+	Trace::Record(traceRtcRead, 130);
+	Trace::Record(traceFirstValidFix, 9000);
+	Trace::Record(traceFirstNmeaChar, 850); // The ISR's stamp, recorded after the fix it came before.
+	Trace::Record(traceRtcRead, 9500);
+	std::string text = DumpText();
+	std::string expected = "TRACE first,ms\r\n"
+		"LCD init,120\r\n"
+		"RTC read,130\r\n"
+		"First NMEA char,850\r\n"
+		"First valid fix,9000\r\n"
+		"TRACE recent,ms\r\n"
+		"LCD init,120\r\n"
+		"RTC read,130\r\n"
+		"First valid fix,9000\r\n"
+		"First NMEA char,850\r\n"
+		"RTC read,9500\r\n";
+	Expect("first times in enum order, repeats only in the recent events", text == expected);
+	if (text != expected)
+	{
+		printf("  dumped:\n%s", text.c_str());
+	}
+
+	// Wraps the ring, so the events above are all pushed out of it.
+	const uint8_t total = TRACE_RING_SIZE + 4;
+	for (uint8_t i = 0; i < total; i++)
+	{
+		Trace::Record(i % 2 ? traceDistanceComputed : traceDecisionMade, 10000 + i * 1000);
+	}
+	text = DumpText();
+	expected = "TRACE first,ms\r\n"
+		"LCD init,120\r\n"
+		"RTC read,130\r\n"
+		"First NMEA char,850\r\n"
+		"First valid fix,9000\r\n"
+		"Distance computed,11000\r\n"
+		"Decision made,10000\r\n"
+		"TRACE recent,ms\r\n";
+	for (uint8_t i = total - TRACE_RING_SIZE; i < total; i++)
+	{
+		expected += i % 2 ? "Distance computed," : "Decision made,";
+		expected += std::to_string(10000 + i * 1000) + "\r\n";
+	}
+	Expect("wrapped ring: the last TRACE_RING_SIZE events, oldest first", text == expected);
+	if (text != expected)
+	{
+		printf("  dumped:\n%s", text.c_str());
+	}
+	Expect("events never recorded aren't listed", text.find("EEPROM") == std::string::npos && text.find("timed out") == std::string::npos);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+// Host check that Setup's interactive wizard runs without the heap. The global operator new and new[] are replaced, and
+// any call while the wizard runs fails the test. A script types a three point game at the prompts, with a mistake at
+// each kind of prompt: a point count out of range and one too long, a month out of range, a latitude out of range, a
+// longitude without its sign, and a window too long.
+//   - Every mistake must be reported and asked for again, and every line of the script used;
+//   - the game stored must load back as it was typed;
+//   - nothing may be allocated.
+#include <new>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#define private public // To compare the configuration loaded.
+#include "Setup.h"
+#undef private
+
+extern std::string hostSerialInput;
+extern size_t hostSerialInputPosition;
+extern std::string hostSerialOutput;
+
+static int failures = 0;
+static bool watching = false;
+static long heapCalls = 0;
+
+static const char* const script[] = {
+	"x", // Any key at the splash screen.
+	"0", "12", "3",
+	"2030-13-01T10:00:00", "2030-01-01T10:00:00",
+	"+95.0000000", "-36.8485000", "174.7633000", "+174.7633000", "2030-01-01T11:00:00", "99", "15",
+	"-36.8500000", "+174.7600000", "2030-01-01T12:00:00", "05",
+	"-36.8510000", "+174.7650000", "2030-01-01T13:00:00", "30",
+};
+static const int SCRIPT_LINES = sizeof(script) / sizeof(script[0]);
+static int linesTyped = 0;
+static size_t lastPosition = 0;
+static int emptyPolls = 0;
+
+void* operator new(size_t size)
+{
+	heapCalls += watching;
+	void* memory = malloc(size ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+static void Expect(const char* name, bool ok)
+{
+	printf("%-62s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+// The wizard empties the serial input before each prompt, as typing ahead isn't meant to answer it, and that takes one
+// empty poll each time. A line is only typed once the wizard has found the input empty three times in a row, so it must be
+// waiting for it.
+static void TypeNextLine()
+{
+	if (hostSerialInputPosition != lastPosition)
+	{
+		lastPosition = hostSerialInputPosition;
+		emptyPolls = 0;
+	}
+	if (++emptyPolls < 3)
+	{
+		return;
+	}
+	if (linesTyped == SCRIPT_LINES)
+	{
+		watching = false;
+		printf("%s\nthe wizard wanted more than the script has\nFAIL\n", hostSerialOutput.c_str());
+		exit(1);
+	}
+	hostSerialInput += script[linesTyped++];
+	hostSerialInput += '\r';
+	emptyPolls = 0;
+}
+
+static bool Reported(const char* text)
+{
+	return hostSerialOutput.find(text) != std::string::npos;
+}
+
+static bool PointIs(uint8_t point, int32_t latitude, int32_t longitude, time_t open, time_t close)
+{
+	SinglePointConfiguration& configuration = Setup::singlePointConfigurationCollection[point];
+	return configuration.GetLocation().latitude == latitude && configuration.GetLocation().longitude == longitude
+		&& configuration.GetWindowOpenDateTime() == open && configuration.GetWindowCloseDateTime() == close;
+}
+
+int main()
+{
+	memset(EEPROM.Bytes, 0xFF, sizeof(EEPROM.Bytes));
+	// Reserved so that the shim's own strings don't allocate while the wizard runs.
+	hostSerialInput.reserve(4096);
+	hostSerialOutput.reserve(1 << 20);
+	hostSerialRefill = TypeNextLine;
+
+	watching = true;
+	bool stored = Setup::Initialize();
+	watching = false;
+	printf("  %d lines typed, %u characters of output, %ld calls to operator new\n", linesTyped, (unsigned)hostSerialOutput.size(),
+		heapCalls);
+	Expect("the wizard stores the game", stored && Reported("Cycle unlock key"));
+	Expect("every line of the script is used", linesTyped == SCRIPT_LINES);
+	Expect("a point count that is too long is asked for again", Reported("Entry too long. Maximum input length is 1"));
+	Expect("values out of range are asked for again", Reported("1 and 12 (inclusive) for Month") && Reported("-90 and +90.")
+		&& Reported("1 and 60 (inclusive)."));
+	Expect("a coordinate without its sign is asked for again", Reported("First character must be '+' or '-'"));
+
+	Setup::ZeroConfig();
+	bool loaded = Setup::LoadConfigFromEEPROM();
+	Expect("the game loads back as it was typed", loaded && Setup::GetTotalPointCount() == 3
+		&& Setup::GetGameStartDateTime() == 1893492000
+		&& PointIs(0, -368485000, 1747633000, 1893495600, 1893495600 + 15 * 60)
+		&& PointIs(1, -368500000, 1747600000, 1893499200, 1893499200 + 5 * 60)
+		&& PointIs(2, -368510000, 1747650000, 1893502800, 1893502800 + 30 * 60));
+	Expect("nothing is allocated", heapCalls == 0);
+
+	printf("%d failures\n%s\n", failures, failures ? "FAIL" : "ok");
+	return failures ? 1 : 0;
+}
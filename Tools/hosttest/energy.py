@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Estimate the charge one game takes from the battery, before and after the power saving in
+Physical and Scheduler, from the timeline of a host run of the firmware.
+
+    energy.py
+        The table for the timelines measured so far.
+
+    energy.py FIRST_FIX FINISHED_BEFORE FINISHED_AFTER
+        One timeline: seconds from boot to the first accepted fix ('none' if it never comes),
+        and to the game's phase finishing without and with the power saving ('inf' if never).
+
+Each part draws a constant current in each state, so the charge is the sum of each segment of
+the timeline at its currents. The currents are datasheet typical figures, not measurements.
+"""
+
+import sys
+
+# ATmega328P at 16 MHz and 5 V, with the regulator's quiescent current. In mA.
+MCU_ACTIVE = 12.0
+MCU_IDLE = 4.0
+MCU_POWER_DOWN = 0.1
+# Once loop() idles between interrupts, the share of the time it is awake parsing and drawing.
+MCU_BUSY_FRACTION = 0.05
+# NEO-6M.
+GPS_ACQUIRING = 47.0
+GPS_TRACKING = 37.0
+GPS_POWER_SAVE = 14.0
+GPS_BACKUP = 0.02
+# After the first fix, how long the receiver takes to ACK the power save request and settle into it.
+POWER_SAVE_AFTER_S = 5.0
+LCD_BACKLIGHT = 20.0
+# The player switches the box off this long after switching it on.
+SWITCHED_OFF_S = 600.0
+
+# Timelines from the host runs of the firmware: boot to the first fix, and boot to the phase
+# finishing without and with the power saving.
+TIMELINES = [
+    ('warm start, outside fence', 8, 40, 40),
+    ('cold start, outside fence', 35, 67, 67),
+    ('no sky', None, float('inf'), 307),
+    ('before start (no fix needed)', 8, 10, 10),
+]
+
+
+def current_ma(t, first_fix, finished, power_saving):
+    tracking = first_fix is not None and t >= first_fix
+    if not power_saving:
+        gps = GPS_TRACKING if tracking else GPS_ACQUIRING
+        return MCU_ACTIVE + gps + (0 if t >= finished else LCD_BACKLIGHT)
+    if t >= finished:
+        return MCU_POWER_DOWN + GPS_BACKUP
+    mcu = MCU_IDLE + (MCU_ACTIVE - MCU_IDLE) * MCU_BUSY_FRACTION
+    if not tracking:
+        gps = GPS_ACQUIRING
+    elif t >= first_fix + POWER_SAVE_AFTER_S:
+        gps = GPS_POWER_SAVE
+    else:
+        gps = GPS_TRACKING
+    return mcu + gps + LCD_BACKLIGHT
+
+
+def game_mah(first_fix, finished, power_saving):
+    """The charge from boot to switching off, in mAh."""
+    edges = [0.0, SWITCHED_OFF_S]
+    if first_fix is not None:
+        edges += [first_fix, first_fix + POWER_SAVE_AFTER_S]
+    edges.append(finished)
+    edges = sorted(set(e for e in edges if 0 <= e <= SWITCHED_OFF_S))
+    milliamp_seconds = 0.0
+    for start, end in zip(edges, edges[1:]):
+        milliamp_seconds += current_ma((start + end) / 2, first_fix, finished, power_saving) * (end - start)
+    return milliamp_seconds / 3600
+
+
+def print_table(timelines):
+    print('%-30s %10s %10s %8s' % ('timeline', 'before mAh', 'after mAh', 'saving'))
+    for name, first_fix, finished_before, finished_after in timelines:
+        before = game_mah(first_fix, finished_before, False)
+        after = game_mah(first_fix, finished_after, True)
+        print('%-30s %10.2f %10.2f %7.0f%%' % (name, before, after, 100 * (1 - after / before)))
+
+
+def main(args):
+    if not args:
+        print_table(TIMELINES)
+    elif len(args) == 3:
+        first_fix = None if args[0] == 'none' else float(args[0])
+        print_table([('given', first_fix, float(args[1]), float(args[2]))])
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Write synthetic 1 Hz NMEA logs for the host tests.
+
+    genlog.py bench out.nmea SECONDS
+        A receiver's full default output (RMC, VTG, GGA, GSA, three GSV and GLL) for a walk,
+        with the odd corrupted sentence, for NMEAlogBenchmark.
+
+    genlog.py stand out.nmea SECONDS NORTH EAST SEED [heavy]
+        GGA and RMC from a receiver standing NORTH and EAST meters from the test origin, with the
+        errors of a cheap module near buildings: a wandering bias, white noise, HDOP that drifts
+        with the sky, and multipath jumps of 15-60 m. 'heavy' makes the bias and jumps worse.
+
+The same arguments always give the same log.
+"""
+
+import math
+import random
+import sys
+
+ORIGIN_LAT = -36.8485
+ORIGIN_LON = 174.7633
+METERS_PER_DEGREE = 111320.0
+
+
+def nmea(body):
+    check = 0
+    for ch in body:
+        check ^= ord(ch)
+    return '$%s*%02X\r\n' % (body, check)
+
+
+def degrees_minutes(value, is_lat):
+    hemisphere = ('N' if value >= 0 else 'S') if is_lat else ('E' if value >= 0 else 'W')
+    value = abs(value)
+    whole = int(value)
+    return ('%02d%08.5f' if is_lat else '%03d%08.5f') % (whole, (value - whole) * 60), hemisphere
+
+
+def clock(second):
+    return '%02d%02d%02d.00' % ((second // 3600) % 24, (second // 60) % 60, second % 60)
+
+
+def to_lat_lon(north, east):
+    lat = ORIGIN_LAT + north / METERS_PER_DEGREE
+    return lat, ORIGIN_LON + east / (METERS_PER_DEGREE * math.cos(math.radians(ORIGIN_LAT)))
+
+
+def write_bench(path, seconds):
+    rng = random.Random(1)
+    north = east = 0.0
+    heading = 0.0
+    with open(path, 'w', newline='') as log:
+        for t in range(seconds):
+            heading = (heading + rng.gauss(0, 5)) % 360
+            speed = max(0.0, 1.4 + rng.gauss(0, 0.2))
+            north += speed * math.cos(math.radians(heading))
+            east += speed * math.sin(math.radians(heading))
+            lat, lon = to_lat_lon(north, east)
+            la, ns = degrees_minutes(lat, True)
+            lo, ew = degrees_minutes(lon, False)
+            knots = speed * 3600 / 1852
+            sentences = [
+                'GPRMC,%s,A,%s,%s,%s,%s,%.3f,%.2f,010130,,,A' % (clock(t), la, ns, lo, ew, knots, heading),
+                'GPVTG,%.2f,T,,M,%.3f,N,%.3f,K,A' % (heading, knots, speed * 3.6),
+                'GPGGA,%s,%s,%s,%s,%s,1,08,%.2f,30.0,M,0.0,M,,' % (clock(t), la, ns, lo, ew, 1.0 + rng.random()),
+                'GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.18,1.54',
+                'GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36',
+                'GPGSV,3,2,10,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44',
+                'GPGSV,3,3,10,26,82,187,47,28,43,056,46',
+                'GPGLL,%s,%s,%s,%s,%s,A,A' % (la, ns, lo, ew, clock(t)),
+            ]
+            for body in sentences:
+                line = nmea(body)
+                if rng.random() < 0.001:
+                    line = line.replace(',', ';', 1)  # A corrupted character, as a noisy line would give.
+                log.write(line)
+
+
+def write_stand(path, seconds, north, east, seed, heavy):
+    rng = random.Random(seed)
+    multipath = 0.15 if heavy else 0.05
+    bias_m = 3.5 if heavy else 2.5
+    tau = 40.0
+    a = math.exp(-1 / tau)
+    s = bias_m * math.sqrt(1 - a * a)
+    bias_north = bias_east = 0.0
+    hdop = 1.0
+    jump = 0
+    jump_north = jump_east = 0.0
+    with open(path, 'w', newline='') as log:
+        for t in range(seconds):
+            hdop = min(4.0, max(0.7, hdop + rng.gauss(0, 0.04) + (1.1 - hdop) * 0.02))
+            bias_north = a * bias_north + rng.gauss(0, s) * hdop
+            bias_east = a * bias_east + rng.gauss(0, s) * hdop
+            if jump == 0 and rng.random() < multipath:
+                jump = rng.randint(1, 4)
+                angle = rng.uniform(0, 2 * math.pi)
+                size = rng.uniform(15, 60)
+                jump_north, jump_east = size * math.cos(angle), size * math.sin(angle)
+            n = north + bias_north + rng.gauss(0, 0.8) * hdop
+            e = east + bias_east + rng.gauss(0, 0.8) * hdop
+            reported_hdop = hdop
+            if jump:
+                n += jump_north
+                e += jump_east
+                reported_hdop = hdop * 1.6
+                jump -= 1
+            lat, lon = to_lat_lon(n, e)
+            la, ns = degrees_minutes(lat, True)
+            lo, ew = degrees_minutes(lon, False)
+            log.write(nmea('GPGGA,%s,%s,%s,%s,%s,1,08,%.2f,30.0,M,0.0,M,,' % (clock(t), la, ns, lo, ew, reported_hdop)))
+            log.write(nmea('GPRMC,%s,A,%s,%s,%s,%s,0.01,0.0,010130,,,A' % (clock(t), la, ns, lo, ew)))
+
+
+def main(args):
+    if len(args) >= 3 and args[0] == 'bench':
+        write_bench(args[1], int(args[2]))
+    elif len(args) >= 6 and args[0] == 'stand':
+        write_stand(args[1], int(args[2]), float(args[3]), float(args[4]), int(args[5]), 'heavy' in args[6:])
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
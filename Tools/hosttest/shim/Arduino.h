@@ -0,0 +1,113 @@
+#ifndef _HOST_ARDUINO_h
+#define _HOST_ARDUINO_h
+
+// Just enough of the Arduino core to build the libraries and the lockbox's modules on a PC, for the tests in Tools/hosttest.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#define ARDUINO 10813
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+#define sq(x) ((x) * (x))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, b) (((value) >> (b)) & 1)
+#define bit(b) (1UL << (b))
+
+#define noInterrupts()
+#define interrupts()
+#define cli()
+#define sei()
+#define digitalPinToInterrupt(p) (p)
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void pinMode(uint8_t pin, uint8_t mode);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// The clock runs in real time until a test sets hostManualClock, after which only delay() and hostAdvanceMicros() move it.
+extern bool hostManualClock;
+void hostAdvanceMicros(uint32_t us);
+extern int hostPins[32]; // What digitalRead returns for each pin.
+
+inline size_t strlcpy(char* destination, const char* source, size_t size)
+{
+	size_t length = strlen(source);
+	if (size)
+	{
+		size_t copied = length < size - 1 ? length : size - 1;
+		memcpy(destination, source, copied);
+		destination[copied] = 0;
+	}
+	return length;
+}
+
+#define DTOSTR_PLUS_SIGN 2
+inline char* dtostre(double value, char* buffer, unsigned char precision, unsigned char flags)
+{
+	sprintf(buffer, (flags & DTOSTR_PLUS_SIGN) ? "%+.*e" : "%.*e", precision, value);
+	return buffer;
+}
+
+#include "Print.h"
+#include "Stream.h"
+
+// Reads from hostSerialInput and appends to hostSerialOutput.
+class HardwareSerial : public Stream
+{
+public:
+	void begin(long) {}
+	void end() {}
+	void flush() {}
+	int available();
+	int read();
+	int peek();
+	size_t write(uint8_t c);
+	using Print::write;
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Called when Serial.available() finds no input left, so a program can append more to hostSerialInput or end the run.
+extern void (*hostSerialRefill)();
+
+#endif
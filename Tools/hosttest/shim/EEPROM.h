@@ -0,0 +1,55 @@
+#ifndef _HOST_EEPROM_h
+#define _HOST_EEPROM_h
+
+#include "Arduino.h"
+
+// The ATmega328P's 1 KB of EEPROM, held in RAM. Tests load and save EEPROM.Bytes themselves.
+// Writes counts the erase and write cycles of each cell, which are what wear it out. As on the AVR, update and put skip a
+// cell that already holds the value.
+class EEPROMClass
+{
+public:
+	static const uint16_t SIZE = 1024;
+	uint8_t Bytes[SIZE];
+	uint32_t Writes[SIZE];
+
+	uint8_t read(int address) { return Bytes[address % SIZE]; }
+	void write(int address, uint8_t value)
+	{
+		Bytes[address % SIZE] = value;
+		Writes[address % SIZE]++;
+	}
+	void update(int address, uint8_t value)
+	{
+		if (read(address) != value)
+		{
+			write(address, value);
+		}
+	}
+	uint16_t length() { return SIZE; }
+	uint8_t& operator[](int address) { return Bytes[address % SIZE]; }
+
+	template <typename T> T& get(int address, T& value)
+	{
+		uint8_t* bytes = (uint8_t*)&value;
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			bytes[i] = read(address + i);
+		}
+		return value;
+	}
+
+	template <typename T> const T& put(int address, const T& value)
+	{
+		const uint8_t* bytes = (const uint8_t*)&value;
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			update(address + i, bytes[i]);
+		}
+		return value;
+	}
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
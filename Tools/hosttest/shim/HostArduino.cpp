@@ -0,0 +1,98 @@
+#include <string>
+#include <time.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+#include <Servo.h>
+
+bool hostManualClock = false;
+static uint64_t manualMicros = 0;
+int hostPins[32];
+
+// Serial input is read from here, and output appended here.
+std::string hostSerialInput;
+size_t hostSerialInputPosition = 0;
+std::string hostSerialOutput;
+void (*hostSerialRefill)() = NULL;
+
+int hostSleepMode = 0;
+long hostIdleCount = 0;
+long hostPowerDownCount = 0;
+int hostServoWrites = 0;
+int hostServoDegrees = 0;
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+TwoWire Wire;
+
+uint32_t micros()
+{
+	if (hostManualClock)
+	{
+		return (uint32_t)manualMicros;
+	}
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000ULL + now.tv_nsec / 1000);
+}
+
+uint32_t millis()
+{
+	if (hostManualClock)
+	{
+		return (uint32_t)(manualMicros / 1000);
+	}
+	return micros() / 1000;
+}
+
+void hostAdvanceMicros(uint32_t us)
+{
+	manualMicros += us;
+}
+
+void delay(uint32_t ms)
+{
+	if (hostManualClock)
+	{
+		manualMicros += ms * 1000ULL;
+	}
+}
+
+void delayMicroseconds(uint32_t us)
+{
+	if (hostManualClock)
+	{
+		manualMicros += us;
+	}
+}
+
+int digitalRead(uint8_t pin) { return hostPins[pin & 31]; }
+void digitalWrite(uint8_t pin, uint8_t value) { hostPins[pin & 31] = value; }
+void pinMode(uint8_t, uint8_t) {}
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+
+int HardwareSerial::available()
+{
+	if (hostSerialInputPosition == hostSerialInput.size() && hostSerialRefill)
+	{
+		hostSerialRefill();
+	}
+	return hostSerialInput.size() - hostSerialInputPosition;
+}
+
+int HardwareSerial::read()
+{
+	return (hostSerialInputPosition < hostSerialInput.size()) ? (uint8_t)hostSerialInput[hostSerialInputPosition++] : -1;
+}
+
+int HardwareSerial::peek()
+{
+	return (hostSerialInputPosition < hostSerialInput.size()) ? (uint8_t)hostSerialInput[hostSerialInputPosition] : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	hostSerialOutput += (char)c;
+	return 1;
+}
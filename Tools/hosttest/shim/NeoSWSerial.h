@@ -0,0 +1,32 @@
+#ifndef _HOST_NEOSWSERIAL_h
+#define _HOST_NEOSWSERIAL_h
+
+#include "Arduino.h"
+
+// A software serial port with nothing wired to it. Nothing is received unless a test calls the attached ISR itself, and
+// writes are dropped.
+class NeoSWSerial : public Stream
+{
+public:
+	typedef void (*isr_t)(uint8_t);
+
+	NeoSWSerial(uint8_t, uint8_t) : _isr(NULL) {}
+	void begin(uint16_t = 9600) {}
+	void listen() {}
+	void ignore() {}
+	void setBaudRate(uint16_t) {}
+	void end() {}
+	int available() { return 0; }
+	int read() { return -1; }
+	int peek() { return -1; }
+	void flush() {}
+	size_t write(uint8_t) { return 1; }
+	using Print::write;
+	void attachInterrupt(isr_t fn) { _isr = fn; }
+	void detachInterrupt() { _isr = NULL; }
+
+private:
+	isr_t _isr;
+};
+
+#endif
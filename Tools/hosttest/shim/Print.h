@@ -0,0 +1,73 @@
+#ifndef _HOST_PRINT_h
+#define _HOST_PRINT_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+
+class Print
+{
+	size_t printNumber(unsigned long long n, int base)
+	{
+		char buffer[66];
+		char* p = buffer + sizeof(buffer) - 1;
+		*p = 0;
+		do
+		{
+			int digit = n % base;
+			*--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+			n /= base;
+		} while (n);
+		return write(p);
+	}
+	size_t printSigned(long long n, int base)
+	{
+		if (n < 0 && base == 10)
+		{
+			return print('-') + printNumber(-(unsigned long long)n, 10);
+		}
+		return printNumber((unsigned long long)n, base);
+	}
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size)
+	{
+		size_t n = 0;
+		while (size--)
+		{
+			n += write(*buffer++);
+		}
+		return n;
+	}
+	size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+	size_t write(const char* s, size_t size) { return write((const uint8_t*)s, size); }
+	virtual void flush() {}
+
+	size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+	size_t print(const char* s) { return write(s); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char n, int base = 10) { return printNumber(n, base); }
+	size_t print(int n, int base = 10) { return printSigned(n, base); }
+	size_t print(unsigned int n, int base = 10) { return printNumber(n, base); }
+	size_t print(long n, int base = 10) { return printSigned(n, base); }
+	size_t print(unsigned long n, int base = 10) { return printNumber(n, base); }
+	size_t print(long long n, int base = 10) { return printSigned(n, base); }
+	size_t print(unsigned long long n, int base = 10) { return printNumber(n, base); }
+	size_t print(double value, int digits = 2)
+	{
+		char buffer[48];
+		snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+		return write(buffer);
+	}
+	size_t println() { return write("\r\n"); }
+	template<class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+	template<class T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+};
+
+#endif
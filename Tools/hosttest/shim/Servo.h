@@ -0,0 +1,20 @@
+#ifndef _HOST_SERVO_h
+#define _HOST_SERVO_h
+
+// Counts the positions written, so a test can see the lock move.
+extern int hostServoWrites;
+extern int hostServoDegrees;
+
+class Servo
+{
+public:
+	void attach(int) {}
+	void write(int degrees)
+	{
+		hostServoDegrees = degrees;
+		hostServoWrites++;
+	}
+	void detach() {}
+};
+
+#endif
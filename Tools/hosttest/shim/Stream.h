@@ -0,0 +1,23 @@
+#ifndef _HOST_STREAM_h
+#define _HOST_STREAM_h
+
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	size_t readBytes(char* buffer, size_t length)
+	{
+		size_t count = 0;
+		while (count < length && available())
+		{
+			buffer[count++] = read();
+		}
+		return count;
+	}
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef _HOST_WIRE_h
+#define _HOST_WIRE_h
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+// An I2C bus with nothing on it: every address is NACKed and no bytes come back.
+// Tests of a driver that writes set Acknowledge, so every transmission is ACKed. Whether ACKed or not, the first SENT_CAPACITY
+// bytes written are kept in Sent, in order. SentCount, the number of transmissions, the longest, and the bytes written
+// outside one count everything.
+class TwoWire : public Stream
+{
+	bool open = false;
+	uint32_t current = 0;
+public:
+	static const size_t SENT_CAPACITY = 65536;
+	bool Acknowledge = false;
+	uint8_t Sent[SENT_CAPACITY];
+	size_t SentCount = 0;
+	uint32_t Transmissions = 0;
+	uint32_t LongestTransmission = 0;
+	uint32_t WritesOutside = 0;
+
+	void Reset()
+	{
+		SentCount = 0;
+		Transmissions = 0;
+		LongestTransmission = 0;
+		WritesOutside = 0;
+	}
+
+	void begin() {}
+	void beginTransmission(uint8_t)
+	{
+		Transmissions++;
+		open = true;
+		current = 0;
+	}
+	uint8_t endTransmission(uint8_t = 1)
+	{
+		LongestTransmission = max(LongestTransmission, current);
+		open = false;
+		return Acknowledge ? 0 : 2;
+	}
+	uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+	size_t write(uint8_t value)
+	{
+		WritesOutside += !open;
+		current++;
+		if (SentCount < SENT_CAPACITY)
+		{
+			Sent[SentCount] = value;
+		}
+		SentCount++;
+		return 1;
+	}
+	using Print::write;
+	int available() { return 0; }
+	int read() { return -1; }
+	int peek() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,3 @@
+#ifndef _HOST_INTERRUPT_h
+#define _HOST_INTERRUPT_h
+#endif
@@ -0,0 +1,18 @@
+#ifndef _HOST_SLEEP_h
+#define _HOST_SLEEP_h
+
+// Counts sleeps instead of sleeping.
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+extern int hostSleepMode;
+extern long hostIdleCount;
+extern long hostPowerDownCount;
+
+inline void set_sleep_mode(int mode) { hostSleepMode = mode; }
+inline void sleep_enable() {}
+inline void sleep_mode() { hostIdleCount++; }
+inline void sleep_cpu() { hostPowerDownCount++; }
+
+#endif
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Configure a lockbox over serial with one batch message instead of the setup prompts.
+
+The game file lists the values in the order the prompts ask for them, one per line.
+Blank lines and lines starting with '#' are ignored.
+
+    2030-01-01T10:00:00     game start (UTC)
+    -36.8485000             latitude of point 1
+    +174.7633000            longitude of point 1
+    2030-01-01T11:00:00     window open for point 1 (UTC)
+    15                      window length for point 1, in minutes
+    ...                     four lines per further point, the last being the final unlock
+
+Usage:
+    provision.py game.txt                      print the message
+    provision.py game.txt /dev/ttyACM0         send it to a unit in configure mode (needs pyserial)
+"""
+
+import sys
+import time
+
+BAUD = 9600
+REPLY_TIMEOUT = 5.0
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, as Journal::Crc16 on the unit."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def read_game(path):
+    values = []
+    with open(path) as game:
+        for line in game:
+            line = line.strip()
+            if line and not line.startswith('#'):
+                values.append(line.split()[0])
+    if len(values) < 5 or (len(values) - 1) % 4:
+        raise ValueError('expected a game start then four values per point, got %d values' % len(values))
+    return values
+
+
+def build_message(values):
+    body = 'CFG,%d,%s' % ((len(values) - 1) // 4, ','.join(values))
+    return '$%s*%04X\r\n' % (body, crc16(body.encode('ascii')))
+
+
+def send(message, port_name):
+    import serial  # pyserial
+
+    with serial.Serial(port_name, BAUD, timeout=0.1) as port:
+        # Opening the port resets most boards, so wait for the splash screen before sending.
+        deadline = time.time() + REPLY_TIMEOUT
+        seen = b''
+        while b'press any key' not in seen:
+            if time.time() > deadline:
+                raise RuntimeError('unit did not show the setup splash screen')
+            seen = (seen + port.read(64))[-256:]
+
+        port.write(message.encode('ascii'))
+        deadline = time.time() + REPLY_TIMEOUT
+        while time.time() < deadline:
+            line = port.readline().decode('ascii', 'replace').strip()
+            if line.startswith('$ACK') or line.startswith('$NAK'):
+                return line
+            if line:
+                print(line)
+        raise RuntimeError('no reply from unit')
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        print(__doc__)
+        return 2
+    message = build_message(read_game(argv[1]))
+    if len(argv) == 2:
+        sys.stdout.write(message)
+        return 0
+    reply = send(message, argv[2])
+    print(reply)
+    return 0 if reply.startswith('$ACK') else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Loopback test of provision.py against a simulated unit.
+
+hosttest/ProvisionUnit runs the sketch's Setup on a PC, with stdin and stdout in place of
+the serial port and the EEPROM kept in a file. provision.send talks to it through a stand-in
+for pyserial, so the whole exchange runs as it would with a unit: splash screen, message,
+ACK or NAK, and the game that ends up in EEPROM.
+
+    make -C Tools/hosttest test             builds the unit and runs this
+    test_provision.py path/to/ProvisionUnit
+"""
+
+import os
+import select
+import subprocess
+import sys
+import tempfile
+import types
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import provision  # noqa: E402
+
+UNIT = None
+
+TWO_POINTS = [
+    '2030-01-01T10:00:00',
+    '-36.8067182', '+174.7423717', '2030-01-01T11:00:00', '15',
+    '-36.8381887', '+174.7127535', '2030-01-01T12:00:00', '30',
+]
+
+
+class SimulatedPort:
+    """Enough of serial.Serial for provision.send, with ProvisionUnit on the other end.
+
+    The port name is the unit's EEPROM file."""
+
+    def __init__(self, port_name, baud, timeout):
+        self.timeout = timeout
+        self.unit = subprocess.Popen([UNIT, port_name], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.pending = b''
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.unit.stdin.close()
+        self.unit.stdout.close()
+        self.unit.wait(10)
+
+    def read(self, size):
+        if not self.pending:
+            self._fill()
+        data, self.pending = self.pending[:size], self.pending[size:]
+        return data
+
+    def readline(self):
+        while b'\n' not in self.pending and self._fill():
+            pass
+        end = self.pending.find(b'\n') + 1 or len(self.pending)
+        line, self.pending = self.pending[:end], self.pending[end:]
+        return line
+
+    def write(self, data):
+        self.unit.stdin.write(data)
+        self.unit.stdin.flush()
+
+    def _fill(self):
+        if not select.select([self.unit.stdout], [], [], self.timeout)[0]:
+            return False
+        data = os.read(self.unit.stdout.fileno(), 256)
+        self.pending += data
+        return bool(data)
+
+
+def stored_game(eeprom):
+    dump = subprocess.run([UNIT, eeprom, 'dump'], stdout=subprocess.PIPE, universal_newlines=True)
+    return dump.stdout.split() if dump.returncode == 0 else None
+
+
+def message_with_body(body):
+    return '$%s*%04X\r\n' % (body, provision.crc16(body.encode('ascii')))
+
+
+class ProvisionLoopbackTest(unittest.TestCase):
+
+    def setUp(self):
+        sys.modules['serial'] = types.SimpleNamespace(Serial=SimulatedPort)
+        handle, self.eeprom = tempfile.mkstemp(suffix='.eeprom')
+        os.close(handle)
+        os.unlink(self.eeprom)  # The unit starts with erased EEPROM.
+
+    def tearDown(self):
+        if os.path.exists(self.eeprom):
+            os.unlink(self.eeprom)
+
+    def provision(self, values):
+        return provision.send(provision.build_message(values), self.eeprom)
+
+    def test_accepted_game_is_stored(self):
+        message = provision.build_message(TWO_POINTS)
+        reply = provision.send(message, self.eeprom)
+        self.assertTrue(reply.startswith('$ACK,'), reply)
+        self.assertEqual(stored_game(self.eeprom), TWO_POINTS)
+
+    def test_game_file_round_trip(self):
+        with tempfile.NamedTemporaryFile('w', suffix='.txt', delete=False) as game:
+            game.write('# two points\n\n%s\n' % '\n'.join('%s   comment' % value for value in TWO_POINTS))
+        try:
+            values = provision.read_game(game.name)
+        finally:
+            os.unlink(game.name)
+        self.assertEqual(values, TWO_POINTS)
+        self.assertTrue(self.provision(values).startswith('$ACK,'))
+
+    def test_nine_points(self):
+        game = ['2030-01-01T10:00:00']
+        for point in range(9):
+            game += ['-36.80%05d' % (point * 1111), '+174.70%05d' % (point * 2222), '2030-01-01T%02d:00:00' % (11 + point), '15']
+        self.assertTrue(self.provision(game).startswith('$ACK,'))
+        self.assertEqual(stored_game(self.eeprom), game)
+
+    def test_bad_crc_is_refused_and_keeps_the_stored_game(self):
+        self.provision(TWO_POINTS)
+        message = provision.build_message(TWO_POINTS[:2] + ['-36.9'] + TWO_POINTS[3:])
+        message = message.replace('-36.9,', '-36.8,')  # The CRC no longer matches the body.
+        self.assertEqual(provision.send(message, self.eeprom), '$NAK,CRC')
+        self.assertEqual(stored_game(self.eeprom), TWO_POINTS)
+
+    def test_bad_field_is_refused_by_number(self):
+        self.provision(TWO_POINTS)
+        values = list(TWO_POINTS)
+        values[1] = '-96.0000000'  # Field 3 of the message: CFG, count, start, then the first latitude.
+        self.assertEqual(self.provision(values), '$NAK,3')
+        self.assertEqual(stored_game(self.eeprom), TWO_POINTS)
+
+    def test_missing_field_is_refused(self):
+        body = 'CFG,2,%s' % ','.join(TWO_POINTS[:-1])
+        self.assertEqual(provision.send(message_with_body(body), self.eeprom), '$NAK,%d' % (3 + 4 * 2 - 1))
+        self.assertIsNone(stored_game(self.eeprom))
+
+    def test_game_too_large_to_store_keeps_the_stored_game(self):
+        self.provision(TWO_POINTS)
+        # Points far apart in place and time need the longest encodings.
+        game = ['2030-01-01T10:00:00']
+        for point in range(9):
+            sign = '-' if point % 2 else '+'
+            game += [sign + '80.1234567', sign + '179.7654321', '%04d-06-15T12:34:56' % (2031 + point), '60']
+        self.assertEqual(self.provision(game), '$NAK,SIZE')
+        self.assertEqual(stored_game(self.eeprom), TWO_POINTS)
+
+    def test_read_game_checks_the_value_count(self):
+        with tempfile.NamedTemporaryFile('w', suffix='.txt', delete=False) as game:
+            game.write('\n'.join(TWO_POINTS[:-1]))
+        try:
+            with self.assertRaises(ValueError):
+                provision.read_game(game.name)
+        finally:
+            os.unlink(game.name)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    UNIT = os.path.abspath(sys.argv.pop(1))
+    unittest.main(buffer=True)  # The unit's error messages are only shown for failing tests.